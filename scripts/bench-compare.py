@@ -0,0 +1,54 @@
+#! /usr/bin/env python3
+
+# Compares two JSON reports of `bench-headless replay --json` and fails on regressions.
+#
+# Usage: bench-compare.py BASELINE.json CURRENT.json [--tolerance PERCENT]
+#
+# A result regresses if its throughput dropped, or its heap allocation count grew,
+# by more than the given tolerance (default: 10 percent).
+# Exits with status 1 if any regression was found, 0 otherwise.
+
+import argparse
+import json
+import sys
+
+def load_results(path: str) -> dict[tuple[str, str], dict]:
+    with open(path, encoding='utf-8') as f:
+        report = json.load(f)
+    return {(r['corpus'], r['stage']): r for r in report['results']}
+
+def percent_change(before: float, after: float) -> float:
+    return (after - before) / before * 100.0 if before != 0 else 0.0
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description='Compares two bench-headless replay reports.')
+    parser.add_argument('baseline')
+    parser.add_argument('current')
+    parser.add_argument('--tolerance', type=float, default=10.0,
+                        help='Allowed regression in percent (default: 10).')
+    args = parser.parse_args()
+
+    baseline = load_results(args.baseline)
+    current = load_results(args.current)
+
+    regressions = 0
+    print(f"{'Corpus':<24} {'Stage':<8} {'MB/s':>10} {'change':>9} {'allocations':>12} {'change':>9}")
+    for key in sorted(baseline.keys() & current.keys()):
+        before, after = baseline[key], current[key]
+        throughput = percent_change(before['mb_per_second'], after['mb_per_second'])
+        allocations = percent_change(before['allocations'], after['allocations'])
+        regressed = throughput < -args.tolerance or allocations > args.tolerance
+        regressions += regressed
+        print(f"{key[0]:<24} {key[1]:<8} {after['mb_per_second']:>10.1f} {throughput:>+8.1f}% "
+              f"{after['allocations']:>12} {allocations:>+8.1f}%{'  REGRESSION' if regressed else ''}")
+
+    for key in sorted(baseline.keys() - current.keys()):
+        print(f"{key[0]:<24} {key[1]:<8} missing in current report")
+
+    if regressions:
+        print(f"\n{regressions} regression(s) beyond {args.tolerance}% tolerance.", file=sys.stderr)
+        return 1
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
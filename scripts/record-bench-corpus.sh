@@ -0,0 +1,83 @@
+#! /bin/bash
+#
+# Records real-world VT output streams to be replayed by: bench-headless replay CORPUS_DIR
+#
+# Usage: record-bench-corpus.sh OUTPUT_DIR [COLUMNS] [LINES]
+#
+# Every recipe is run inside a pseudo terminal of the given page size (default 80x24) and its output
+# is written verbatim into OUTPUT_DIR/<name>.vt. Recipes whose tools are not installed are skipped.
+#
+# Environment:
+#   CARGO_PROJECT   Path to a Rust project to record a (clean) cargo build of.
+
+set -e
+
+project_root="$(realpath "$(dirname "$0")/..")"
+output_dir="${1:?Usage: $0 OUTPUT_DIR [COLUMNS] [LINES]}"
+columns="${2:-80}"
+lines="${3:-24}"
+
+mkdir -p "$output_dir"
+
+have() {
+    command -v "$1" >/dev/null 2>&1
+}
+
+# record NAME COMMAND
+record() {
+    local name="$1"
+    local cmd="$2"
+    local out="$output_dir/$name.vt"
+
+    echo "Recording $name ..."
+    COLUMNS=$columns LINES=$lines TERM=xterm-256color GIT_PAGER=cat \
+        script -q -e -c "stty cols $columns rows $lines; $cmd" /dev/null > "$out" || true
+    echo "  $(wc -c < "$out") bytes written to $out"
+}
+
+skip() {
+    echo "Skipping $1 ($2 not found)."
+}
+
+if ! have script; then
+    echo 1>&2 "script(1) from util-linux is required."
+    exit 1
+fi
+
+if have vim; then
+    record vim-scroll "vim -u NONE -N -c 'syntax on' \
+        -c 'for i in range(400) | execute \"normal! \\<C-e>\" | redraw | endfor' \
+        -c 'qa!' '$project_root/src/vtbackend/Screen.cpp'"
+else
+    skip vim-scroll vim
+fi
+
+if have htop; then
+    record htop "timeout 10 htop -d 5"
+else
+    skip htop htop
+fi
+
+if have cargo && test -n "$CARGO_PROJECT"; then
+    record cargo-build "cd '$CARGO_PROJECT' && cargo clean && cargo build --color=always"
+else
+    skip cargo-build "cargo or CARGO_PROJECT"
+fi
+
+if have git; then
+    record git-log-graph "git -C '$project_root' log --graph --color=always --decorate --all -n 20000"
+else
+    skip git-log-graph git
+fi
+
+if have notcurses-demo; then
+    record notcurses-demo "timeout 60 notcurses-demo -d 0.25"
+else
+    skip notcurses-demo notcurses-demo
+fi
+
+record sixel "for i in \$(seq 50); do cat '$project_root/test/images/squirrel-50.sixel'; done"
+
+cjk_line="終端仿真器は文字列を表示します。터미널 에뮬레이터가 텍스트를 표시합니다。终端模拟器显示文本。"
+record emoji-cjk "for i in \$(seq 200); do cat '$project_root'/test/emoji/*.txt; \
+    for j in \$(seq 10); do echo '$cjk_line'; done; done"
@@ -37,6 +37,7 @@ optional<Action> fromString(string const& name)
         mapAction<actions::CreateSelection>("CreateSelection"),
         mapAction<actions::DecreaseFontSize>("DecreaseFontSize"),
         mapAction<actions::DecreaseOpacity>("DecreaseOpacity"),
+        mapAction<actions::DumpPerformanceCounters>("DumpPerformanceCounters"),
         mapAction<actions::FocusNextSearchMatch>("FocusNextSearchMatch"),
         mapAction<actions::FocusPreviousSearchMatch>("FocusPreviousSearchMatch"),
         mapAction<actions::FollowHyperlink>("FollowHyperlink"),
@@ -38,6 +38,7 @@ struct CreateDebugDump{};
 struct CreateSelection{ std::string delimiters; };
 struct DecreaseFontSize{};
 struct DecreaseOpacity{};
+struct DumpPerformanceCounters{};
 struct FocusNextSearchMatch{};
 struct FocusPreviousSearchMatch{};
 struct FollowHyperlink{};
@@ -101,6 +102,7 @@ using Action = std::variant<CancelSelection,
                             CreateSelection,
                             DecreaseFontSize,
                             DecreaseOpacity,
+                            DumpPerformanceCounters,
                             FocusNextSearchMatch,
                             FocusPreviousSearchMatch,
                             FollowHyperlink,
@@ -179,6 +181,10 @@ namespace documentation
     constexpr inline std::string_view CreateDebugDump { "Create dump for debug purposes" };
     constexpr inline std::string_view DecreaseFontSize { "Decreases the font size by 1 pixel." };
     constexpr inline std::string_view DecreaseOpacity { "Decreases the default-background opacity by 5%." };
+    constexpr inline std::string_view DumpPerformanceCounters {
+        "Prints the hot path performance counters since the last dump (requires a build with "
+        "CONTOUR_INSTRUMENTATION)."
+    };
     constexpr inline std::string_view FocusNextSearchMatch { "Focuses the next search match (if any)." };
     constexpr inline std::string_view FocusPreviousSearchMatch {
         "Focuses the next previous match (if any)."
@@ -301,6 +307,7 @@ constexpr
         std::tuple { Action { CreateSelection {} }, documentation::CreateSelection },
         std::tuple { Action { DecreaseFontSize {} }, documentation::DecreaseFontSize },
         std::tuple { Action { DecreaseOpacity {} }, documentation::DecreaseOpacity },
+        std::tuple { Action { DumpPerformanceCounters {} }, documentation::DumpPerformanceCounters },
         std::tuple { Action { FocusNextSearchMatch {} }, documentation::FocusNextSearchMatch },
         std::tuple { Action { FocusPreviousSearchMatch {} }, documentation::FocusPreviousSearchMatch },
         std::tuple { Action { FollowHyperlink {} }, documentation::FollowHyperlink },
@@ -383,6 +390,7 @@ DECLARE_ACTION_FMT(CreateDebugDump)
 DECLARE_ACTION_FMT(CreateSelection)
 DECLARE_ACTION_FMT(DecreaseFontSize)
 DECLARE_ACTION_FMT(DecreaseOpacity)
+DECLARE_ACTION_FMT(DumpPerformanceCounters)
 DECLARE_ACTION_FMT(FocusNextSearchMatch)
 DECLARE_ACTION_FMT(FocusPreviousSearchMatch)
 DECLARE_ACTION_FMT(FollowHyperlink)
@@ -475,6 +483,7 @@ struct std::formatter<contour::actions::Action>: std::formatter<std::string>
         HANDLE_ACTION(CreateDebugDump);
         HANDLE_ACTION(DecreaseFontSize);
         HANDLE_ACTION(DecreaseOpacity);
+        HANDLE_ACTION(DumpPerformanceCounters);
         HANDLE_ACTION(FocusNextSearchMatch);
         HANDLE_ACTION(FocusPreviousSearchMatch);
         HANDLE_ACTION(FollowHyperlink);
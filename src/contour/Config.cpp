@@ -355,6 +355,7 @@ void YAMLConfigReader::load(Config& c)
         loadFromEntry("early_exit_threshold", c.earlyExitThreshold);
         loadFromEntry("spawn_new_process", c.spawnNewProcess);
         loadFromEntry("reflow_on_resize", c.reflowOnResize);
+        loadFromEntry("io_reactor_threads", c.ioReactorThreads);
         loadFromEntry("experimental", c.experimentalFeatures);
         loadFromEntry("bypass_mouse_protocol_modifier", c.bypassMouseProtocolModifiers);
         loadFromEntry("on_mouse_select", c.onMouseSelection);
@@ -1119,6 +1120,7 @@ void YAMLConfigReader::loadFromEntry(YAML::Node const& node, std::string const&
         loadFromEntry(child, "limit", where.maxHistoryLineCount);
         loadFromEntry(child, "scroll_multiplier", where.historyScrollMultiplier);
         loadFromEntry(child, "auto_scroll_on_update", where.autoScrollOnUpdate);
+        loadFromEntry(child, "spill_file_limit", where.spillFileSizeLimit);
     }
 }
 
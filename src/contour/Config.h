@@ -165,6 +165,7 @@ struct HistoryConfig
     vtbackend::MaxHistoryLineCount maxHistoryLineCount { vtbackend::LineCount(1000) };
     vtbackend::LineCount historyScrollMultiplier { vtbackend::LineCount(3) };
     bool autoScrollOnUpdate { true };
+    size_t spillFileSizeLimit { 0 }; // in MB
 };
 
 struct ScrollBarConfig
@@ -762,6 +763,7 @@ struct Config
     };
     ConfigEntry<bool, documentation::SpawnNewProcess> spawnNewProcess { false };
     ConfigEntry<bool, documentation::ReflowOnResize> reflowOnResize { true };
+    ConfigEntry<unsigned, documentation::IOReactorThreads> ioReactorThreads { 0 };
     ConfigEntry<vtbackend::Modifiers, documentation::BypassMouseProtocolModifiers>
         bypassMouseProtocolModifiers { vtbackend::Modifier::Shift };
     ConfigEntry<vtbackend::Modifiers, documentation::MouseBlockSelectionModifiers>
@@ -1262,7 +1264,8 @@ struct Writer
                 return number;
             }(),
             v.autoScrollOnUpdate,
-            v.historyScrollMultiplier);
+            v.historyScrollMultiplier,
+            v.spillFileSizeLimit);
     }
 
     [[nodiscard]] std::string format(std::string_view doc, ScrollBarConfig& v)
@@ -210,6 +210,9 @@ constexpr StringLiteral HistoryConfig {
     "    auto_scroll_on_update: {}\n"
     "    {comment} Number of lines to scroll on ScrollUp & ScrollDown events.\n"
     "    scroll_multiplier: {}\n"
+    "    {comment} Maximum size in MB of a temporary file that lines falling off the history limit\n"
+    "    {comment} are spilled into (0 to disable). The file is deleted when the session closes.\n"
+    "    spill_file_limit: {}\n"
     "\n"
 
 };
@@ -577,6 +580,17 @@ constexpr StringLiteral ReflowOnResizeConfig {
     "reflow_on_resize: {}\n"
 };
 
+constexpr StringLiteral IOReactorThreadsConfig {
+    "\n"
+    "{comment} Number of worker threads shared by all terminal sessions for reading from their PTYs.\n"
+    "{comment}\n"
+    "{comment} With 0, every terminal session is reading from its PTY in its own dedicated thread.\n"
+    "{comment} Otherwise, a single event loop is dispatching all PTY input to the given number of threads,\n"
+    "{comment} which keeps the thread count constant regardless of the number of open tabs.\n"
+    "{comment} This is currently only supported on Linux and only affects newly spawned sessions.\n"
+    "io_reactor_threads: {}\n"
+};
+
 constexpr StringLiteral ColorSchemesConfig {
     "{comment} Color Profiles\n"
     "{comment} --------------\n"
@@ -732,6 +746,8 @@ constexpr StringLiteral InputMappingsConfig {
     "member.\n"
     "{comment} - DecreaseFontSize  Decreases the font size by 1 pixel.\n"
     "{comment} - DecreaseOpacity   Decreases the default-background opacity by 5%.\n"
+    "{comment} - DumpPerformanceCounters  Prints the hot path performance counters since the last dump "
+    "(requires a build with CONTOUR_INSTRUMENTATION).\n"
     "{comment} - FocusNextSearchMatch     Focuses the next search match (if any).\n"
     "{comment} - FocusPreviousSearchMatch Focuses the next previous match (if any).\n"
     "{comment} - FollowHyperlink   Follows the hyperlink that is exposed via OSC 8 under the current "
@@ -1133,6 +1149,12 @@ constexpr StringLiteral ReflowOnResizeWeb {
     "The default value is `true`."
 };
 
+constexpr StringLiteral IOReactorThreadsWeb {
+    "option determines the number of worker threads that are shared by all terminal sessions for reading "
+    "from their PTYs. With `0`, every terminal session is reading from its PTY in a dedicated thread. "
+    "This is currently only supported on Linux. The default value is `0`."
+};
+
 constexpr StringLiteral BypassMouseProtocolModifiersWeb {
     "option specifies the keyboard modifier (e.g., Shift) that can be used to bypass the terminal's mouse "
     "protocol and select screen content."
@@ -1338,6 +1360,7 @@ constexpr StringLiteral HistoryWeb {
     "      limit: 1000\n"
     "      auto_scroll_on_update: true\n"
     "      scroll_multiplier: 3\n"
+    "      spill_file_limit: 0\n"
     "```\n"
     ":octicons-horizontal-rule-16: ==limit== This option specifies the number of lines to preserve in the "
     "terminal's history. A value of -1 indicates unlimited history, meaning that all lines are preserved. In "
@@ -1350,6 +1373,11 @@ constexpr StringLiteral HistoryWeb {
     "when the ScrollUp or ScrollDown events occur. By default, scrolling up or down moves three lines at a "
     "time. You can adjust this value as needed. In the provided example, scroll_multiplier is set to 3. "
     "<br/>\n"
+    ":octicons-horizontal-rule-16: ==spill_file_limit== This option specifies the maximum size in megabytes "
+    "of a temporary, memory-mapped file that lines falling off the history limit are spilled into, instead of "
+    "being discarded. Spilled lines can still be scrolled to and searched beyond the top of the history, and "
+    "are read back from the file only while being displayed. Once the file is full, the oldest spilled lines "
+    "are discarded. The file is deleted when the session closes. A value of 0 disables spilling. <br/>\n"
     "\n"
 };
 
@@ -1811,6 +1839,7 @@ using Renderer = DocumentationEntry<RendererConfig, RendererWeb>;
 using PTYReadBufferSize = DocumentationEntry<PTYReadBufferSizeConfig, PTYReadBufferSizeWeb>;
 using PTYBufferObjectSize = DocumentationEntry<PTYBufferObjectSizeConfig, PTYBufferObjectSizeWeb>;
 using ReflowOnResize = DocumentationEntry<ReflowOnResizeConfig, ReflowOnResizeWeb>;
+using IOReactorThreads = DocumentationEntry<IOReactorThreadsConfig, IOReactorThreadsWeb>;
 using ColorSchemes = DocumentationEntry<ColorSchemesConfig, Dummy>;
 using Profiles = DocumentationEntry<ProfilesConfig, ProfilesWeb>;
 using DefaultProfiles = DocumentationEntry<StringLiteral { "default_profile: {}\n" }, DefaultProfilesWeb>;
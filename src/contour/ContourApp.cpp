@@ -304,6 +304,7 @@ pty_buffer_size: 1048576
 default_profile: main
 spawn_new_process: false
 reflow_on_resize: true
+io_reactor_threads: 0
 bypass_mouse_protocol_modifier: Shift
 mouse_block_selection_modifier: Control
 on_mouse_select: CopyToSelectionClipboard
@@ -112,6 +112,11 @@ crispy::cli::command ContourGuiApp::parameterDefinition() const
                     CLI::value { ""s },
                     "Dumps internal state at exit into the given directory. This is for debugging contour.",
                     "PATH" },
+                CLI::option { "latency-report",
+                              CLI::value { ""s },
+                              "Writes each session's frame time and input latency telemetry as JSON "
+                              "into the given directory at exit.",
+                              "PATH" },
                 CLI::option { "early-exit-threshold",
                               CLI::value { -1 },
                               "If the spawned process exits earlier than the given threshold seconds, an "
@@ -189,6 +194,14 @@ std::optional<fs::path> ContourGuiApp::dumpStateAtExit() const
     return fs::path(path);
 }
 
+std::optional<fs::path> ContourGuiApp::latencyReportPath() const
+{
+    auto const path = parameters().get<std::string>("contour.terminal.latency-report");
+    if (path.empty())
+        return std::nullopt;
+    return fs::path(path);
+}
+
 void ContourGuiApp::onExit(TerminalSession& session)
 {
     if (auto const* localProcess = dynamic_cast<vtpty::Process const*>(&session.terminal().device()))
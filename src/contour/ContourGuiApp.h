@@ -49,6 +49,7 @@ class ContourGuiApp: public QObject, public ContourApp
     [[nodiscard]] ExitStatus exitStatus() const noexcept { return _exitStatus; }
 
     [[nodiscard]] std::optional<std::filesystem::path> dumpStateAtExit() const;
+    [[nodiscard]] std::optional<std::filesystem::path> latencyReportPath() const;
 
     void onExit(TerminalSession& session);
 
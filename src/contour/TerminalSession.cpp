@@ -15,6 +15,7 @@
 
 #include <crispy/StackTrace.h>
 #include <crispy/assert.h>
+#include <crispy/instrumentation.h>
 #include <crispy/utils.h>
 
 #include <QtCore/QDebug>
@@ -36,6 +37,7 @@
 #include <filesystem>
 #include <format>
 #include <fstream>
+#include <iostream>
 #include <limits>
 
 #if defined(__OpenBSD__)
@@ -135,6 +137,7 @@ namespace
         settings.ptyBufferObjectSize = config.ptyBufferObjectSize.value();
         settings.ptyReadBufferSize = config.ptyReadBufferSize.value();
         settings.maxHistoryLineCount = profile.history.value().maxHistoryLineCount;
+        settings.historySpillFileSizeLimit = profile.history.value().spillFileSizeLimit * 1024 * 1024;
         settings.copyLastMarkRangeOffset = profile.copyLastMarkRangeOffset.value();
         settings.cursorBlinkInterval = profile.modeInsert.value().cursor.cursorBlinkInterval;
         settings.cursorShape = profile.modeInsert.value().cursor.cursorShape;
@@ -261,6 +264,10 @@ TerminalSession::~TerminalSession()
 {
     sessionLog()("Destroying terminal session.");
     _terminating = true;
+#if defined(__linux__)
+    if (_ioReactor)
+        _ioReactor->remove(_ioSourceId);
+#endif
     _terminal.device().wakeupReader();
     if (_exitWatcherThread->isRunning())
         _exitWatcherThread->terminate();
@@ -307,15 +314,42 @@ void TerminalSession::scheduleRedraw()
 void TerminalSession::start()
 {
     // ensure that we start only once
-    if (!_screenUpdateThread)
+    if (!_started)
     {
+        _started = true;
         sessionLog()("Starting terminal session.");
         _terminal.device().start();
-        _screenUpdateThread = make_unique<std::thread>(bind(&TerminalSession::mainLoop, this));
+        if (!startWithIOReactor())
+            _screenUpdateThread = make_unique<std::thread>(bind(&TerminalSession::mainLoop, this));
         _exitWatcherThread->start(QThread::LowPriority);
     }
 }
 
+bool TerminalSession::startWithIOReactor()
+{
+#if defined(__linux__)
+    auto reactor = _manager->ioReactor();
+    if (!reactor)
+        return false;
+
+    auto const fds = _terminal.device().pollableDescriptors();
+    if (fds.empty())
+        return false;
+
+    sessionLog()("Reading from PTY via shared I/O reactor.");
+    _ioReactor = std::move(reactor);
+    _ioSourceId = _ioReactor->add(fds, [this]() {
+        if (!_terminating && _terminal.processAvailableInput())
+            return true;
+        sessionLog()("Event loop terminating (PTY {}).", _terminal.device().isClosed() ? "closed" : "open");
+        return false;
+    });
+    return true;
+#else
+    return false;
+#endif
+}
+
 void TerminalSession::mainLoop()
 {
     setThreadName("Terminal.Loop");
@@ -652,6 +686,19 @@ void TerminalSession::onClosed()
     else
         sessionLog()("Process terminated after {} seconds.", diff.count());
 
+    if (auto const reportDir = _app.latencyReportPath(); reportDir.has_value())
+    {
+        auto const reportPath =
+            *reportDir / std::format("contour-latency-{}-{}.json", QCoreApplication::applicationPid(), _id);
+        if (auto ofs = ofstream { reportPath, ios::trunc }; ofs.good())
+        {
+            ofs << _terminal.latencyTelemetry().toJson();
+            sessionLog()("Latency report written to {}.", reportPath.string());
+        }
+        else
+            errorLog()("Could not write latency report to \"{}\".", reportPath.string());
+    }
+
     emit sessionClosed(*this);
 
     if (diff < _app.earlyExitThreshold())
@@ -941,6 +988,7 @@ void TerminalSession::sendKeyEvent(Key key, Modifiers modifiers, KeyboardEventTy
             handleAction(actions, eventType, [&](auto const& actions) { executeAllActions(actions); });
             return;
         }
+        _terminal.latencyTelemetry().keyPressed(now);
     }
     terminal().sendKeyEvent(key, modifiers, eventType, now);
 }
@@ -976,6 +1024,7 @@ void TerminalSession::sendCharEvent(
             handleAction(actions, eventType, [&](auto const& actions) { executeAllActions(actions); });
             return;
         }
+        _terminal.latencyTelemetry().keyPressed(now);
     }
     terminal().sendCharEvent(value, physicalKey, modifiers, eventType, now);
 }
@@ -1180,6 +1229,19 @@ bool TerminalSession::operator()(actions::DecreaseOpacity)
     return true;
 }
 
+bool TerminalSession::operator()(actions::DumpPerformanceCounters)
+{
+    if (!crispy::instrumentation::enabled)
+    {
+        errorLog()("Performance counters are not available. Rebuild with CONTOUR_INSTRUMENTATION enabled.");
+        return true;
+    }
+
+    std::cout << crispy::instrumentation::report(crispy::instrumentation::snapshot());
+    crispy::instrumentation::reset();
+    return true;
+}
+
 bool TerminalSession::operator()(actions::FocusNextSearchMatch)
 {
     auto const nextPosition = _terminal.searchNextMatch(_terminal.normalModeCursorPosition());
@@ -1739,6 +1801,7 @@ void TerminalSession::configureTerminal()
     configureCursor(_profile.modeInsert.value().cursor);
     updateColorPreference(_app.colorPreference());
     _terminal.setMaxHistoryLineCount(_profile.history.value().maxHistoryLineCount);
+    _terminal.setHistorySpillFileSizeLimit(_profile.history.value().spillFileSizeLimit * 1024 * 1024);
     _terminal.setHighlightTimeout(_profile.highlightTimeout.value());
     _terminal.viewport().setScrollOff(_profile.modalCursorScrollOff.value());
     _terminal.inputHandler().setSearchModeSwitch(_profile.searchModeSwitch.value());
@@ -10,6 +10,7 @@
 
 #include <vtrasterizer/Renderer.h>
 
+#include <crispy/io_reactor.h>
 #include <crispy/point.h>
 
 #include <QtCore/QAbstractItemModel>
@@ -318,6 +319,7 @@ class TerminalSession: public QAbstractItemModel, public vtbackend::Terminal::Ev
     bool operator()(actions::CreateSelection const&);
     bool operator()(actions::DecreaseFontSize);
     bool operator()(actions::DecreaseOpacity);
+    bool operator()(actions::DumpPerformanceCounters);
     bool operator()(actions::FollowHyperlink);
     bool operator()(actions::FocusNextSearchMatch);
     bool operator()(actions::FocusPreviousSearchMatch);
@@ -444,6 +446,7 @@ class TerminalSession: public QAbstractItemModel, public vtbackend::Terminal::Ev
     uint8_t matchModeFlags() const;
     void flushInput();
     void mainLoop();
+    bool startWithIOReactor();
 
     // private data
     //
@@ -468,6 +471,11 @@ class TerminalSession: public QAbstractItemModel, public vtbackend::Terminal::Ev
     bool _terminating = false;
     std::thread::id _mainLoopThreadID {};
     std::unique_ptr<std::thread> _screenUpdateThread;
+#if defined(__linux__)
+    std::shared_ptr<crispy::io_reactor> _ioReactor;
+    crispy::io_reactor::source_id _ioSourceId = 0;
+#endif
+    bool _started = false;
 
     // state vars
     //
@@ -28,6 +28,22 @@ TerminalSessionManager::TerminalSessionManager(ContourGuiApp& app): _app { app }
 {
 }
 
+#if defined(__linux__)
+std::shared_ptr<crispy::io_reactor> TerminalSessionManager::ioReactor()
+{
+    auto const threadCount = _app.config().ioReactorThreads.value();
+    if (threadCount == 0)
+        return nullptr;
+
+    if (!_ioReactor)
+    {
+        managerLog()("Starting shared I/O reactor with {} worker threads.", threadCount);
+        _ioReactor = std::make_shared<crispy::io_reactor>(threadCount);
+    }
+    return _ioReactor;
+}
+#endif
+
 std::unique_ptr<vtpty::Pty> TerminalSessionManager::createPty(std::optional<std::string> cwd)
 {
     auto const& profile = _app.config().profile(_app.profileName());
@@ -4,9 +4,12 @@
 #include <contour/display/TerminalDisplay.h>
 #include <contour/helper.h>
 
+#include <crispy/io_reactor.h>
+
 #include <QtCore/QAbstractListModel>
 #include <QtQml/QQmlEngine>
 
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
@@ -62,6 +65,12 @@ class TerminalSessionManager: public QAbstractListModel
 
     void doNotSwitchToNewSession() { _allowSwitchOfTheSession = false; }
 
+#if defined(__linux__)
+    /// Returns the I/O reactor shared by all sessions for reading from their PTYs,
+    /// or nullptr if sessions shall read from their PTYs in a dedicated thread each.
+    [[nodiscard]] std::shared_ptr<crispy::io_reactor> ioReactor();
+#endif
+
     struct DisplayState
     {
         TerminalSession* currentSession = nullptr;
@@ -110,6 +119,11 @@ class TerminalSessionManager: public QAbstractListModel
     std::vector<TerminalSession*> _sessions;
     display::TerminalDisplay* _activeDisplay = nullptr;
 
+#if defined(__linux__)
+    // Lazily created, and shared with the sessions using it, as those may outlive this manager.
+    std::shared_ptr<crispy::io_reactor> _ioReactor;
+#endif
+
     // on windows qt tries to create a new session
     // twice on qml file loading, this bool is used to
     // prevent that, and to allow creation of new session
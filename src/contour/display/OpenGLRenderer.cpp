@@ -11,6 +11,7 @@
 #include <crispy/algorithm.h>
 #include <crispy/assert.h>
 #include <crispy/defines.h>
+#include <crispy/instrumentation.h>
 #include <crispy/utils.h>
 
 #include <range/v3/all.hpp>
@@ -22,6 +23,9 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
 #include <memory>
 #include <optional>
 #include <utility>
@@ -56,9 +60,11 @@ namespace contour::display
 namespace ZAxisDepths
 {
     constexpr GLfloat BackgroundSGR = 0.0f;
-    constexpr GLfloat Text = 0.0f;
 } // namespace ZAxisDepths
 
+// Initial capacity of the text instance ring buffer, enough for a full-screen frame at 4K with small fonts.
+constexpr auto MinTextInstanceRingSize = GLsizeiptr { 4 * 1024 * 1024 };
+
 namespace
 {
     struct CRISPY_PACKED vec2 // NOLINT
@@ -82,6 +88,11 @@ namespace
         float w;
     };
 
+    GLubyte toColorComponent(float value) noexcept
+    {
+        return static_cast<GLubyte>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+    }
+
     constexpr bool isPowerOfTwo(uint32_t value) noexcept
     {
         //.
@@ -160,10 +171,11 @@ namespace
 } // namespace
 
 /**
- * Text rendering input:
- *  - vec3 screenCoord    (x/y/z)
+ * Text rendering input, per tile instance:
+ *  - vec4 target         (x/y and w/h)
  *  - vec4 textureCoord   (x/y and w/h)
  *  - vec4 textColor      (r/g/b/a)
+ *  - float selector      (fragment shader selector)
  *
  */
 
@@ -189,6 +201,7 @@ void OpenGLRenderer::setRenderSize(vtbackend::ImageSize targetSurfaceSize)
         return;
 
     _renderTargetSize = targetSurfaceSize;
+    _frame.valid = false;
     _projectionMatrix = ortho(/* left */ 0.0f,
                               /* right */ unbox<float>(_renderTargetSize.width),
                               /* bottom */ unbox<float>(_renderTargetSize.height),
@@ -199,18 +212,28 @@ void OpenGLRenderer::setRenderSize(vtbackend::ImageSize targetSurfaceSize)
 
 void OpenGLRenderer::setTranslation(float x, float y, float z) noexcept
 {
-    _viewMatrix.setToIdentity();
-    _viewMatrix.translate(x, y, z);
+    auto viewMatrix = QMatrix4x4 {};
+    viewMatrix.translate(x, y, z);
+    if (_viewMatrix == viewMatrix)
+        return;
+
+    _viewMatrix = viewMatrix;
+    _frame.valid = false;
 }
 
 void OpenGLRenderer::setModelMatrix(QMatrix4x4 matrix) noexcept
 {
+    if (_modelMatrix == matrix)
+        return;
+
     _modelMatrix = matrix;
+    _frame.valid = false;
 }
 
 void OpenGLRenderer::setMargin(vtrasterizer::PageMargin margin) noexcept
 {
     _margin = margin;
+    _frame.valid = false;
 }
 
 atlas::AtlasBackend& OpenGLRenderer::textureScheduler()
@@ -247,34 +270,64 @@ void OpenGLRenderer::initializeTextureRendering()
     CHECKED_GL(glGenVertexArrays(1, &_textVAO));
     CHECKED_GL(glBindVertexArray(_textVAO));
 
-    constexpr auto const BufferStride = (3 + 4 + 4) * sizeof(GLfloat);
-    constexpr auto const* const VertexOffset = (void const*) nullptr;
-    const auto* const TexCoordOffset = (void const*) (3 * sizeof(GLfloat)); // NOLINT
-    const auto* const ColorOffset = (void const*) (7 * sizeof(GLfloat));    // NOLINT
-
     CHECKED_GL(glGenBuffers(1, &_textVBO));
     CHECKED_GL(glBindBuffer(GL_ARRAY_BUFFER, _textVBO));
-    CHECKED_GL(glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_STREAM_DRAW));
+    CHECKED_GL(glBufferData(GL_ARRAY_BUFFER, MinTextInstanceRingSize, nullptr, GL_STREAM_DRAW));
+    _textInstanceRing.size = MinTextInstanceRingSize;
+    _textInstanceRing.offset = 0;
 
-    // 0 (vec3): vertex buffer
-    CHECKED_GL(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, BufferStride, VertexOffset));
-    CHECKED_GL(glEnableVertexAttribArray(0));
+    // All attributes advance per tile instance rather than per vertex.
+    for (GLuint attribute = 0; attribute < 4; ++attribute)
+    {
+        CHECKED_GL(glEnableVertexAttribArray(attribute));
+        CHECKED_GL(glVertexAttribDivisor(attribute, 1));
+    }
+    bindTextInstanceAttributes(0);
 
-    // 1 (vec4): texture coordinates buffer
-    CHECKED_GL(glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, BufferStride, TexCoordOffset));
-    CHECKED_GL(glEnableVertexAttribArray(1));
+    CHECKED_GL(glBindVertexArray(0));
+}
 
-    // 2 (vec4): color buffer
-    CHECKED_GL(glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, BufferStride, ColorOffset));
-    CHECKED_GL(glEnableVertexAttribArray(2));
+void OpenGLRenderer::bindTextInstanceAttributes(GLintptr offset)
+{
+    constexpr auto Stride = static_cast<GLsizei>(sizeof(TileInstance));
+    auto const at = [offset](size_t memberOffset) {
+        return reinterpret_cast<void const*>(offset + static_cast<GLintptr>(memberOffset)); // NOLINT
+    };
+
+    // 0 (vec4): target rectangle
+    CHECKED_GL(glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, Stride, at(offsetof(TileInstance, target))));
+
+    // 1 (vec4): texture coordinates rectangle
+    CHECKED_GL(
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, Stride, at(offsetof(TileInstance, texCoords))));
+
+    // 2 (vec4): color, normalized from 8 bits per component
+    CHECKED_GL(
+        glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, Stride, at(offsetof(TileInstance, color))));
+
+    // 3 (float): fragment shader selector
+    CHECKED_GL(
+        glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, Stride, at(offsetof(TileInstance, selector))));
+}
 
-    // setup EBO
-    // glGenBuffers(1, &_ebo);
-    // glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ebo);
-    // static const GLuint indices[6] = { 0, 1, 3, 1, 2, 3 };
-    // glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+void OpenGLRenderer::initializeCompositeRendering()
+{
+    // Two triangles covering the whole viewport.
+    static constexpr std::array<GLfloat, 12> Vertices = {
+        -1.0f, -1.0f, 1.0f, -1.0f, 1.0f, 1.0f, // bottom right triangle
+        -1.0f, -1.0f, 1.0f, 1.0f,  -1.0f, 1.0f // top left triangle
+    };
+
+    CHECKED_GL(glGenVertexArrays(1, &_compositeVAO));
+    CHECKED_GL(glBindVertexArray(_compositeVAO));
 
-    // glVertexAttribDivisor(0, 1); // TODO: later for instanced rendering
+    CHECKED_GL(glGenBuffers(1, &_compositeVBO));
+    CHECKED_GL(glBindBuffer(GL_ARRAY_BUFFER, _compositeVBO));
+    CHECKED_GL(glBufferData(GL_ARRAY_BUFFER, sizeof(Vertices), Vertices.data(), GL_STATIC_DRAW));
+
+    // 0 (vec2): vertex buffer
+    CHECKED_GL(glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr));
+    CHECKED_GL(glEnableVertexAttribArray(0));
 
     CHECKED_GL(glBindVertexArray(0));
 }
@@ -284,6 +337,13 @@ OpenGLRenderer::~OpenGLRenderer()
     displayLog()("~OpenGLRenderer");
     CHECKED_GL(glDeleteVertexArrays(1, &_rectVAO));
     CHECKED_GL(glDeleteBuffers(1, &_rectVBO));
+    CHECKED_GL(glDeleteVertexArrays(1, &_compositeVAO));
+    CHECKED_GL(glDeleteBuffers(1, &_compositeVBO));
+    if (_frame.framebuffer)
+    {
+        CHECKED_GL(glDeleteFramebuffers(1, &_frame.framebuffer));
+        CHECKED_GL(glDeleteTextures(1, &_frame.texture));
+    }
 }
 
 void OpenGLRenderer::initialize()
@@ -308,6 +368,7 @@ void OpenGLRenderer::initialize()
     CHECKED_GL(_rectShader = createShader(_rectShaderConfig));
     CHECKED_GL(_rectProjectionLocation = _rectShader->uniformLocation("u_projection")); // NOLINT(cppcoreguidelines-prefer-member-initializer)
     CHECKED_GL(_rectTimeLocation = _rectShader->uniformLocation("u_time")); // NOLINT(cppcoreguidelines-prefer-member-initializer)
+    CHECKED_GL(_compositeShader = createShader(builtinShaderConfig(ShaderClass::Composite)));
     // clang-format on
 
     // Image row alignment is 1 byte (OpenGL defaults to 4).
@@ -323,8 +384,13 @@ void OpenGLRenderer::initialize()
         CHECKED_GL(_textShader->setUniformValue(_textTextureAtlasLocation, 0)); // GL_TEXTURE0?
     });
 
+    bound(*_compositeShader, [&]() {
+        CHECKED_GL(_compositeShader->setUniformValue("u_frame", 0)); // GL_TEXTURE0
+    });
+
     initializeRectRendering();
     initializeTextureRendering();
+    initializeCompositeRendering();
 
     logInfo();
 }
@@ -369,6 +435,7 @@ void OpenGLRenderer::logInfo()
 
 void OpenGLRenderer::clearCache()
 {
+    _frame.valid = false;
 }
 
 int OpenGLRenderer::maxTextureDepth()
@@ -422,62 +489,23 @@ void OpenGLRenderer::uploadTile(atlas::UploadTile tile)
 
 void OpenGLRenderer::renderTile(atlas::RenderTile tile)
 {
-    RenderBatch& batch = _scheduledExecutions.renderBatch;
-
-    // atlas texture Vertices to locate the tile
-    auto const x = static_cast<GLfloat>(tile.x.value);
-    auto const y = static_cast<GLfloat>(tile.y.value);
-    auto const z = ZAxisDepths::Text;
-
     // tile bitmap size on target render surface
-    GLfloat const r = unbox<GLfloat>(firstNonZero(tile.targetSize.width, tile.bitmapSize.width));
-    GLfloat const s = unbox<GLfloat>(firstNonZero(tile.targetSize.height, tile.bitmapSize.height));
-
-    // normalized TexCoords
-    GLfloat const nx = tile.normalizedLocation.x;
-    GLfloat const ny = tile.normalizedLocation.y;
-    GLfloat const nw = tile.normalizedLocation.width;
-    GLfloat const nh = tile.normalizedLocation.height;
-
-    // These two are currently not used.
-    // This used to be used for the z-plane into the 3D texture,
-    // but I've reverted back to a 2D texture atlas for now.
-    GLfloat const i = 0;
-
-    // Tile dependant userdata.
-    // This is current the fragment shader's selector that
-    // determines how to operate on this tile (images vs gray-scale anti-aliased
-    // glyphs vs LCD subpixel antialiased glyphs)
-    auto const u = static_cast<GLfloat>(tile.fragmentShaderSelector);
-
-    // color
-    GLfloat const cr = tile.color[0];
-    GLfloat const cg = tile.color[1];
-    GLfloat const cb = tile.color[2];
-    GLfloat const ca = tile.color[3];
-
-    // clang-format off
-    GLfloat const vertices[6 * 11] = {
-        // first triangle
-    // <X      Y      Z> <X        Y        I  U>  <R   G   B   A>
-        x,     y + s, z,  nx,      ny + nh, i, u,  cr, cg, cb, ca, // left top
-        x,     y,     z,  nx,      ny,      i, u,  cr, cg, cb, ca, // left bottom
-        x + r, y,     z,  nx + nw, ny,      i, u,  cr, cg, cb, ca, // right bottom
-
-        // second triangle
-        x,     y + s, z,  nx,      ny + nh, i, u,  cr, cg, cb, ca, // left top
-        x + r, y,     z,  nx + nw, ny,      i, u,  cr, cg, cb, ca, // right bottom
-        x + r, y + s, z,  nx + nw, ny + nh, i, u,  cr, cg, cb, ca, // right top
-
-        // buffer contains
-        // - 3 vertex coordinates (XYZ)
-        // - 4 texture coordinates (XYIU), I is unused currently, U selects which texture to use
-        // - 4 color values (RGBA)
-    };
-    // clang-format on
-
-    batch.renderTiles.emplace_back(tile);
-    crispy::copy(vertices, back_inserter(batch.buffer));
+    auto const width = unbox<GLfloat>(firstNonZero(tile.targetSize.width, tile.bitmapSize.width));
+    auto const height = unbox<GLfloat>(firstNonZero(tile.targetSize.height, tile.bitmapSize.height));
+
+    auto const& location = tile.normalizedLocation;
+
+    // The fragment shader's selector determines how to operate on this tile
+    // (images vs gray-scale anti-aliased glyphs vs LCD subpixel antialiased glyphs).
+    _scheduledExecutions.renderBatch.instances.push_back(TileInstance {
+        .target = { static_cast<GLfloat>(tile.x.value), static_cast<GLfloat>(tile.y.value), width, height },
+        .texCoords = { location.x, location.y, location.width, location.height },
+        .color = { toColorComponent(tile.color[0]),
+                   toColorComponent(tile.color[1]),
+                   toColorComponent(tile.color[2]),
+                   toColorComponent(tile.color[3]) },
+        .selector = static_cast<GLfloat>(tile.fragmentShaderSelector),
+    });
 }
 // }}}
 
@@ -500,6 +528,7 @@ struct ScopedRenderEnvironment
     QOpenGLExtraFunctions& gl;
 
     bool savedBlend;          // QML seems to explicitly disable that, but we need it.
+    bool savedScissorTest;    // Scissoring is only used internally for partial redraws.
     GLenum savedDepthFunc {}; // Shuold be GL_LESS, but you never know.
     GLuint savedVAO {};       // QML sets that before and uses it later, so we need to back it up, too.
     GLenum savedBlendSource {};
@@ -507,8 +536,11 @@ struct ScopedRenderEnvironment
 
     ScopedRenderEnvironment(QOpenGLExtraFunctions& glIn):
         gl { glIn }, // clang-format off
-        savedBlend { gl.glIsEnabled(GL_BLEND) != GL_FALSE } // clang-format on
+        savedBlend { gl.glIsEnabled(GL_BLEND) != GL_FALSE },
+        savedScissorTest { gl.glIsEnabled(GL_SCISSOR_TEST) != GL_FALSE } // clang-format on
     {
+        gl.glDisable(GL_SCISSOR_TEST);
+
         gl.glGetIntegerv(GL_VERTEX_ARRAY_BINDING, (GLint*) &savedVAO);
 
         gl.glGetIntegerv(GL_DEPTH_FUNC, (GLint*) &savedDepthFunc);
@@ -529,16 +561,69 @@ struct ScopedRenderEnvironment
         gl.glDepthFunc(savedDepthFunc);
         if (!savedBlend)
             gl.glDisable(GL_BLEND);
+        if (savedScissorTest)
+            gl.glEnable(GL_SCISSOR_TEST);
 
         gl.glBindVertexArray(savedVAO);
         gl.glDepthMask(GL_TRUE);
     }
 };
 
+bool OpenGLRenderer::setDamagedBands(std::vector<vtrasterizer::PixelRowBand> bands)
+{
+    // Band coordinates are only meaningful as long as the view is not transformed
+    // any further than translated into place.
+    if (!_frame.valid || !_modelMatrix.isIdentity())
+        return false;
+
+    _damagedBands = std::move(bands);
+    return true;
+}
+
+void OpenGLRenderer::ensureFrameBuffer(ImageSize size)
+{
+    if (_frame.framebuffer && _frame.size == size)
+        return;
+
+    if (!_frame.framebuffer)
+    {
+        CHECKED_GL(glGenFramebuffers(1, &_frame.framebuffer));
+        CHECKED_GL(glGenTextures(1, &_frame.texture));
+    }
+
+    CHECKED_GL(glBindTexture(GL_TEXTURE_2D, _frame.texture));
+    CHECKED_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+    CHECKED_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+    CHECKED_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    CHECKED_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    CHECKED_GL(glTexImage2D(GL_TEXTURE_2D,
+                            0,
+                            GL_RGBA8,
+                            unbox<GLsizei>(size.width),
+                            unbox<GLsizei>(size.height),
+                            0,
+                            GL_RGBA,
+                            GL_UNSIGNED_BYTE,
+                            nullptr));
+    CHECKED_GL(glBindTexture(GL_TEXTURE_2D, 0));
+
+    CHECKED_GL(glBindFramebuffer(GL_FRAMEBUFFER, _frame.framebuffer));
+    CHECKED_GL(
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _frame.texture, 0));
+
+    displayLog()("Resized offscreen frame buffer to {}.", size);
+    _frame.size = size;
+    _frame.valid = false;
+}
+
 void OpenGLRenderer::execute(std::chrono::steady_clock::time_point now)
 {
+    CRISPY_INSTRUMENT_STAGE(gpu_execute, 0);
     Require(_initialized);
 
+    if (_latencyTelemetry)
+        _latencyTelemetry->gpuExecutionStarted(std::chrono::steady_clock::now());
+
     auto const _ = ScopedRenderEnvironment { *this };
 
     auto const timeValue = uptime(now);
@@ -546,31 +631,10 @@ void OpenGLRenderer::execute(std::chrono::steady_clock::time_point now)
     // displayLog()("execute {} rects, {} uploads, {} renders\n",
     //              _rectBuffer.size() / 7,
     //              _scheduledExecutions.uploadTiles.size(),
-    //              _scheduledExecutions.renderBatch.renderTiles.size());
+    //              _scheduledExecutions.renderBatch.instances.size());
 
     auto const mvp = _projectionMatrix * _viewMatrix * _modelMatrix;
 
-    // render filled rects
-    //
-    if (!_rectBuffer.empty())
-    {
-        bound(*_rectShader, [&]() {
-            _rectShader->setUniformValue(_rectProjectionLocation, mvp);
-            _rectShader->setUniformValue(_rectTimeLocation, timeValue);
-
-            glBindVertexArray(_rectVAO);
-            glBindBuffer(GL_ARRAY_BUFFER, _rectVBO);
-            glBufferData(GL_ARRAY_BUFFER,
-                         static_cast<GLsizeiptr>(_rectBuffer.size() * sizeof(GLfloat)),
-                         _rectBuffer.data(),
-                         GL_STREAM_DRAW);
-
-            glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(_rectBuffer.size() / 7));
-            glBindVertexArray(0);
-        });
-        _rectBuffer.clear();
-    }
-
     // potentially (re-)configure atlas
     //
     if (_scheduledExecutions.configureAtlas)
@@ -586,14 +650,64 @@ void OpenGLRenderer::execute(std::chrono::steady_clock::time_point now)
         _textureAtlas.gpuTexture.release();
     }
 
-    // render textures
+    // Render into the offscreen frame buffer, which mirrors the viewport of the actual render target,
+    // and keeps its contents across frames.
     //
-    bound(*_textShader, [&]() {
-        // TODO: only upload when it actually DOES change
-        _textShader->setUniformValue(_textProjectionLocation, mvp);
-        _textShader->setUniformValue(_textTimeLocation, timeValue);
-        executeRenderTextures();
-    });
+    GLint targetFramebuffer {};
+    std::array<GLint, 4> viewport {};
+    std::array<GLfloat, 4> clearColor {};
+    CHECKED_GL(glGetIntegerv(GL_FRAMEBUFFER_BINDING, &targetFramebuffer));
+    CHECKED_GL(glGetIntegerv(GL_VIEWPORT, viewport.data()));
+    CHECKED_GL(glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor.data()));
+
+    auto const frameWidth = viewport[2];
+    auto const frameHeight = viewport[3];
+    ensureFrameBuffer(ImageSize { Width::cast_from(frameWidth), Height::cast_from(frameHeight) });
+    CHECKED_GL(glBindFramebuffer(GL_FRAMEBUFFER, _frame.framebuffer));
+    CHECKED_GL(glViewport(0, 0, frameWidth, frameHeight));
+    CHECKED_GL(glClearColor(0.0f, 0.0f, 0.0f, 0.0f));
+
+    // Accumulate premultiplied colors, so that the frame can be composited as is.
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    executeUploadRenderBuffers();
+
+    if (_damagedBands && _frame.valid)
+    {
+        // Only redraw the damaged row bands, leaving everything else as rendered by previous frames.
+        glEnable(GL_SCISSOR_TEST);
+        for (auto const& band: *_damagedBands)
+        {
+            // Map the band from render target coordinates (top-down) to frame buffer
+            // coordinates (bottom-up).
+            auto const toFrameY = [&](int y) {
+                return (mvp.map(QPointF(0, y)).y() + 1.0) * 0.5 * frameHeight;
+            };
+            auto const bottom = static_cast<GLint>(std::floor(toFrameY(band.top + band.height)));
+            auto const top = static_cast<GLint>(std::ceil(toFrameY(band.top)));
+            glScissor(0, bottom, frameWidth, top - bottom);
+            glClear(GL_COLOR_BUFFER_BIT);
+            executeDrawRenderBuffers(mvp, timeValue);
+        }
+        glDisable(GL_SCISSOR_TEST);
+    }
+    else
+    {
+        glClear(GL_COLOR_BUFFER_BIT);
+        executeDrawRenderBuffers(mvp, timeValue);
+    }
+
+    _frame.valid = true;
+    _damagedBands.reset();
+    _rectBuffer.clear();
+    _scheduledExecutions.clear();
+
+    // Composite the frame onto the actual render target.
+    //
+    CHECKED_GL(glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(targetFramebuffer)));
+    CHECKED_GL(glViewport(viewport[0], viewport[1], viewport[2], viewport[3]));
+    CHECKED_GL(glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]));
+    executeCompositeFrame();
 
     if (_pendingScreenshotCallback)
     {
@@ -601,30 +715,105 @@ void OpenGLRenderer::execute(std::chrono::steady_clock::time_point now)
         _pendingScreenshotCallback.value()(result.second, result.first);
         _pendingScreenshotCallback.reset();
     }
+
+    if (_latencyTelemetry)
+        _latencyTelemetry->gpuExecutionFinished(std::chrono::steady_clock::now());
 }
 
-void OpenGLRenderer::executeRenderTextures()
+void OpenGLRenderer::executeUploadRenderBuffers()
 {
-    // upload vertices and render
-    RenderBatch& batch = _scheduledExecutions.renderBatch;
-    if (!batch.renderTiles.empty())
+    if (!_rectBuffer.empty())
     {
-        _textureAtlas.gpuTexture.bind();
-        glBindVertexArray(_textVAO);
-
-        // upload buffer
-        glBindBuffer(GL_ARRAY_BUFFER, _textVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, _rectVBO);
         glBufferData(GL_ARRAY_BUFFER,
-                     static_cast<GLsizei>(batch.buffer.size() * sizeof(GLfloat)),
-                     batch.buffer.data(),
+                     static_cast<GLsizeiptr>(_rectBuffer.size() * sizeof(GLfloat)),
+                     _rectBuffer.data(),
                      GL_STREAM_DRAW);
-        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(batch.renderTiles.size() * 6));
+    }
+
+    RenderBatch const& batch = _scheduledExecutions.renderBatch;
+    if (!batch.instances.empty())
+    {
+        auto const byteCount = static_cast<GLsizeiptr>(batch.instances.size() * sizeof(TileInstance));
+        auto& ring = _textInstanceRing;
+
+        glBindBuffer(GL_ARRAY_BUFFER, _textVBO);
+        if (ring.offset + byteCount > ring.size)
+        {
+            // Orphan the buffer, letting the driver hand out fresh storage while the GPU may still
+            // be reading from the old one.
+            ring.size = std::max(ring.size, byteCount * 4);
+            ring.offset = 0;
+            glBufferData(GL_ARRAY_BUFFER, ring.size, nullptr, GL_STREAM_DRAW);
+        }
+
+        // This range has not been written to since the buffer has last been orphaned,
+        // so there is no need to synchronize with the GPU.
+        auto constexpr Access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+        if (void* target = glMapBufferRange(GL_ARRAY_BUFFER, ring.offset, byteCount, Access))
+        {
+            std::memcpy(target, batch.instances.data(), static_cast<size_t>(byteCount));
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        }
+        else
+            glBufferSubData(GL_ARRAY_BUFFER, ring.offset, byteCount, batch.instances.data());
 
+        glBindVertexArray(_textVAO);
+        bindTextInstanceAttributes(ring.offset);
         glBindVertexArray(0);
-        _textureAtlas.gpuTexture.release();
+
+        ring.offset += byteCount;
     }
+}
 
-    _scheduledExecutions.clear();
+void OpenGLRenderer::executeDrawRenderBuffers(QMatrix4x4 const& mvp, float timeValue)
+{
+    // render filled rects
+    //
+    if (!_rectBuffer.empty())
+    {
+        bound(*_rectShader, [&]() {
+            _rectShader->setUniformValue(_rectProjectionLocation, mvp);
+            _rectShader->setUniformValue(_rectTimeLocation, timeValue);
+
+            glBindVertexArray(_rectVAO);
+            glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(_rectBuffer.size() / 7));
+            glBindVertexArray(0);
+        });
+    }
+
+    // render textures
+    //
+    RenderBatch const& batch = _scheduledExecutions.renderBatch;
+    if (!batch.instances.empty())
+    {
+        bound(*_textShader, [&]() {
+            // TODO: only upload when it actually DOES change
+            _textShader->setUniformValue(_textProjectionLocation, mvp);
+            _textShader->setUniformValue(_textTimeLocation, timeValue);
+
+            _textureAtlas.gpuTexture.bind();
+            glBindVertexArray(_textVAO);
+            glDrawArraysInstanced(GL_TRIANGLES, 0, 6, static_cast<GLsizei>(batch.instances.size()));
+            glBindVertexArray(0);
+            _textureAtlas.gpuTexture.release();
+        });
+    }
+}
+
+void OpenGLRenderer::executeCompositeFrame()
+{
+    // The frame buffer holds premultiplied colors.
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    bound(*_compositeShader, [&]() {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, _frame.texture);
+        glBindVertexArray(_compositeVAO);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        glBindVertexArray(0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    });
 }
 
 void OpenGLRenderer::executeConfigureAtlas(atlas::ConfigureAtlas const& param)
@@ -5,6 +5,7 @@
 #include <contour/display/ShaderConfig.h>
 
 #include <vtbackend/Image.h>
+#include <vtbackend/LatencyTelemetry.h>
 #include <vtbackend/primitives.h>
 
 #include <vtrasterizer/RenderTarget.h>
@@ -19,6 +20,7 @@
 #include <QtOpenGL/QOpenGLTexture>
 #include <QtQuick/QQuickWindow>
 
+#include <array>
 #include <chrono>
 #include <memory>
 #include <optional>
@@ -70,12 +72,17 @@ class OpenGLRenderer final:
     void setRenderSize(vtbackend::ImageSize targetSurfaceSize) override;
     void setTranslation(float x, float y, float z) noexcept;
     void setViewSize(vtbackend::ImageSize size) noexcept { _viewSize = size; }
+    void setLatencyTelemetry(vtbackend::LatencyTelemetry* telemetry) noexcept
+    {
+        _latencyTelemetry = telemetry;
+    }
     void setModelMatrix(QMatrix4x4 matrix) noexcept;
     void setMargin(vtrasterizer::PageMargin margin) noexcept override;
     std::optional<AtlasTextureScreenshot> readAtlas() override;
     AtlasBackend& textureScheduler() override;
     void scheduleScreenshot(ScreenshotCallback callback) override;
     void renderRectangle(int x, int y, Width, Height, RGBAColor color) override;
+    bool setDamagedBands(std::vector<vtrasterizer::PixelRowBand> bands) override;
     void execute(std::chrono::steady_clock::time_point now) override;
 
     std::pair<vtbackend::ImageSize, std::vector<uint8_t>> takeScreenshot();
@@ -104,6 +111,7 @@ class OpenGLRenderer final:
     void initializeBackgroundRendering();
     void initializeTextureRendering();
     void initializeRectRendering();
+    void initializeCompositeRendering();
     int maxTextureDepth();
     int maxTextureSize();
     int maxTextureUnits();
@@ -114,10 +122,14 @@ class OpenGLRenderer final:
                                 int rowAlignment,
                                 uint8_t const* pixels);
 
-    void executeRenderTextures();
+    void ensureFrameBuffer(ImageSize size);
+    void executeUploadRenderBuffers();
+    void executeDrawRenderBuffers(QMatrix4x4 const& mvp, float timeValue);
+    void executeCompositeFrame();
     void executeConfigureAtlas(ConfigureAtlas const& param);
     void executeUploadTile(UploadTile const& param);
     void executeRenderTile(RenderTile const& param);
+    void bindTextInstanceAttributes(GLintptr offset);
 
     //? void renderRectangle(int _x, int _y, int width, int height, QVector4D const& color);
 
@@ -126,17 +138,21 @@ class OpenGLRenderer final:
     //
 
     // {{{ scheduling data
+    // Attributes of a single rendered tile, which the vertex shader expands into the tile's two triangles.
+    struct TileInstance
+    {
+        std::array<GLfloat, 4> target;    // x, y, width, height on the render target
+        std::array<GLfloat, 4> texCoords; // x, y, width, height in the texture atlas (normalized)
+        std::array<GLubyte, 4> color;     // RGBA
+        GLfloat selector;                 // fragment shader selector (RenderTile::fragmentShaderSelector)
+    };
+
     struct RenderBatch
     {
-        std::vector<vtrasterizer::atlas::RenderTile> renderTiles;
-        std::vector<GLfloat> buffer;
+        std::vector<TileInstance> instances;
         uint32_t userdata = 0;
 
-        void clear()
-        {
-            renderTiles.clear();
-            buffer.clear();
-        }
+        void clear() { instances.clear(); }
     };
 
     struct Scheduler
@@ -175,8 +191,15 @@ class OpenGLRenderer final:
     // private data members for rendering textures
     //
     GLuint _textVAO {}; // Vertex Array Object, covering all buffer objects
-    GLuint _textVBO {}; // Buffer containing the vertex coordinates
-    // TODO: GLuint ebo_{};
+    GLuint _textVBO {}; // Ring buffer containing the tile instances of the recent frames
+
+    // Each frame's tile instances are appended to the ring buffer, which is orphaned once it is full,
+    // so that writing them never has to wait for the GPU to finish reading those of previous frames.
+    struct
+    {
+        GLsizeiptr size = 0; // capacity in bytes
+        GLintptr offset = 0; // where to write the next frame's instances to
+    } _textInstanceRing;
 
     // index equals AtlasID
     struct AtlasAttributes
@@ -205,9 +228,26 @@ class OpenGLRenderer final:
     GLuint _rectVAO {};
     GLuint _rectVBO {};
 
+    // Offscreen frame buffer holding the most recently rendered frame (with premultiplied alpha),
+    // so that subsequent frames only need to redraw their damaged areas before being composited
+    // onto the actual render target.
+    struct
+    {
+        GLuint framebuffer {};
+        GLuint texture {};
+        ImageSize size {};
+        bool valid = false; // Indicates whether or not the frame buffer holds a complete frame.
+    } _frame;
+    std::optional<std::vector<vtrasterizer::PixelRowBand>> _damagedBands;
+
+    std::unique_ptr<QOpenGLShaderProgram> _compositeShader;
+    GLuint _compositeVAO {};
+    GLuint _compositeVBO {};
+
     std::optional<ScreenshotCallback> _pendingScreenshotCallback;
 
     QQuickWindow* _window = nullptr;
+    vtbackend::LatencyTelemetry* _latencyTelemetry = nullptr;
 
     // render state cache
     struct
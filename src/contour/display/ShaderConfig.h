@@ -16,7 +16,8 @@ namespace contour::display
 enum class ShaderClass : uint8_t
 {
     Background,
-    Text
+    Text,
+    Composite
 };
 
 struct ShaderSource
@@ -40,6 +41,7 @@ inline std::string to_string(ShaderClass shaderClass)
     {
         case ShaderClass::Background: return "background";
         case ShaderClass::Text: return "text";
+        case ShaderClass::Composite: return "composite";
     }
 
     crispy::unreachable();
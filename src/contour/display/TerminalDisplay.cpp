@@ -325,6 +325,9 @@ void TerminalDisplay::setSession(TerminalSession* newSession)
             // TODO: , WindowMargin(windowMargin_.left, windowMargin_.bottom);
         );
 
+        // Glyphs rendered as placeholders are shown as soon as they have been rasterized.
+        _renderer->setGlyphsRasterizedCallback([this]() { post([this]() { scheduleRedraw(); }); });
+
         // setup once with the renderer creation
         applyFontDPI();
         updateImplicitSize();
@@ -581,6 +584,7 @@ void TerminalDisplay::onBeforeSynchronize()
     _renderTarget->setModelMatrix(createModelMatrix());
     _renderTarget->setTranslation(float(x() * dpr), float(y() * dpr), float(z() * dpr));
     _renderTarget->setViewSize(viewSize);
+    _renderTarget->setLatencyTelemetry(&terminal().latencyTelemetry());
 }
 
 void TerminalDisplay::createRenderer()
@@ -645,6 +649,12 @@ void TerminalDisplay::createRenderer()
             &TerminalDisplay::onAfterRendering,
             Qt::DirectConnection);
 
+    connect(window(),
+            &QQuickWindow::frameSwapped,
+            this,
+            &TerminalDisplay::onFrameSwapped,
+            Qt::DirectConnection);
+
     configureScreenHooks();
     watchKdeDpiSetting();
 
@@ -736,6 +746,13 @@ float TerminalDisplay::uptime() const noexcept
     return uptimeSecs;
 }
 
+void TerminalDisplay::onFrameSwapped()
+{
+    // This signal is emitted from the scene graph rendering thread
+    if (_session)
+        terminal().latencyTelemetry().frameSwapped(std::chrono::steady_clock::now());
+}
+
 void TerminalDisplay::onAfterRendering()
 {
     // This method is called after the QML scene has been rendered.
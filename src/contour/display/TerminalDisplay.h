@@ -173,6 +173,7 @@ class TerminalDisplay: public QQuickItem
     void cleanup();
 
     void onAfterRendering();
+    void onFrameSwapped();
     void onScrollBarValueChanged(int value);
     void onRefreshRateChanged();
     void applyFontDPI();
@@ -0,0 +1,10 @@
+uniform highp sampler2D u_frame;   // previously rendered frame, with premultiplied alpha
+
+in highp vec2 fs_TexCoord;
+
+out highp vec4 fragColor;
+
+void main()
+{
+    fragColor = texture(u_frame, fs_TexCoord);
+}
@@ -0,0 +1,9 @@
+layout (location = 0) in highp vec2 vs_vertex;    // normalized device coordinates
+
+out highp vec2 fs_TexCoord;
+
+void main()
+{
+    gl_Position = vec4(vs_vertex, 0.0, 1.0);
+    fs_TexCoord = (vs_vertex + 1.0) * 0.5;
+}
@@ -1,16 +1,25 @@
 uniform highp mat4 vs_projection;                 // projection matrix (flips around the coordinate system)
 
-layout (location = 0) in highp vec3 vs_vertex;    // target vertex coordinates
-layout (location = 1) in highp vec4 vs_texCoords; // 2D-atlas texture coordinates
+layout (location = 0) in highp vec4 vs_target;    // target rectangle (x/y and w/h)
+layout (location = 1) in highp vec4 vs_texCoords; // 2D-atlas texture rectangle (x/y and w/h)
 layout (location = 2) in highp vec4 vs_colors;    // custom foreground colors
+layout (location = 3) in highp float vs_selector; // fragment shader selector
 
 out highp vec4 fs_TexCoord;
 out highp vec4 fs_textColor;
 
+// Corners of the two triangles making up a tile, relative to the tile's rectangle.
+const highp vec2 Corners[6] = vec2[6](
+    vec2(0.0, 1.0), vec2(0.0, 0.0), vec2(1.0, 0.0), // first triangle
+    vec2(0.0, 1.0), vec2(1.0, 0.0), vec2(1.0, 1.0)  // second triangle
+);
+
 void main()
 {
-    gl_Position = vs_projection * vec4(vs_vertex.xyz, 1.0);
+    highp vec2 corner = Corners[gl_VertexID];
+
+    gl_Position = vs_projection * vec4(vs_target.xy + corner * vs_target.zw, 0.0, 1.0);
 
-    fs_TexCoord = vs_texCoords;
+    fs_TexCoord = vec4(vs_texCoords.xy + corner * vs_texCoords.zw, 0.0, vs_selector);
     fs_textColor = vs_colors;
 }
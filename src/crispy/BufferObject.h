@@ -7,6 +7,7 @@
 #include <gsl/span_ext>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <cstdlib>
@@ -18,6 +19,8 @@
 #include <mutex>
 #include <string_view>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #define BUFFER_OBJECT_INLINE 1
 
@@ -37,6 +40,9 @@ class buffer_object;
 template <BufferObjectElementType>
 class buffer_fragment;
 
+template <BufferObjectElementType>
+class buffer_object_pool;
+
 template <BufferObjectElementType T>
 using buffer_object_release = std::function<void(buffer_object<T>*)>;
 
@@ -62,6 +68,8 @@ auto const inline bufferObjectLog = logstore::category("BufferObject",
  *   can start filling at the same offset again.
  *   The offset gets incremented only if new references have been added.
  * - This buffer does not grow or shrink.
+ * - Keeps track of how many bytes are still referenced by buffer fragments,
+ *   so that sparsely referenced buffers can be compacted.
  */
 template <BufferObjectElementType T>
 class buffer_object: public std::enable_shared_from_this<buffer_object<T>>
@@ -91,6 +99,11 @@ class buffer_object: public std::enable_shared_from_this<buffer_object<T>>
 
     [[nodiscard]] float loadFactor() const noexcept { return float(bytesUsed()) / float(capacity()); }
 
+    /// Returns the number of bytes currently referenced by buffer fragments.
+    ///
+    /// Bytes referenced by multiple fragments are counted multiple times.
+    [[nodiscard]] std::size_t liveBytes() const noexcept { return _liveBytes.load(std::memory_order_relaxed); }
+
     [[nodiscard]] T* data() noexcept;
     [[nodiscard]] T const* data() const noexcept;
 
@@ -128,12 +141,23 @@ class buffer_object: public std::enable_shared_from_this<buffer_object<T>>
 #endif
     T* _hotEnd;
     T* _end;
+    std::atomic<std::size_t> _liveBytes = 0;
 
     friend class buffer_fragment<T>;
 
     std::mutex _mutex;
 };
 
+/// Usage statistics of a buffer_object_pool.
+struct buffer_object_pool_statistics
+{
+    std::size_t buffers = 0;       // number of buffer objects currently handed out
+    std::size_t unusedBuffers = 0; // number of buffer objects kept for reuse
+    std::size_t reservedBytes = 0; // capacity of all buffer objects, including unused ones
+    std::size_t usedBytes = 0;     // bytes written into buffer objects that are handed out
+    std::size_t liveBytes = 0;     // bytes still referenced by buffer fragments
+};
+
 /**
  * buffer_object_pool manages reusable buffer_object objects.
  *
@@ -148,16 +172,28 @@ class buffer_object_pool
     explicit buffer_object_pool(size_t bufferSize = 4096);
     ~buffer_object_pool();
 
+    buffer_object_pool(buffer_object_pool const&) = delete;
+    buffer_object_pool(buffer_object_pool&&) = delete;
+    buffer_object_pool& operator=(buffer_object_pool const&) = delete;
+    buffer_object_pool& operator=(buffer_object_pool&&) = delete;
+
     void releaseUnusedBuffers();
     [[nodiscard]] size_t unusedBuffers() const noexcept;
     [[nodiscard]] buffer_object_ptr<T> allocateBufferObject();
 
+    [[nodiscard]] size_t bufferSize() const noexcept { return _bufferSize; }
+    [[nodiscard]] buffer_object_pool_statistics statistics() const;
+
   private:
+    buffer_object_ptr<T> track(buffer_object<T>* ptr);
     void release(buffer_object<T>* ptr);
+    static void destroy(buffer_object<T>* ptr);
 
+    mutable std::mutex _mutex;
     bool _reuseBuffers = true;
     size_t _bufferSize;
-    std::list<buffer_object_ptr<T>> _unusedBuffers;
+    std::vector<buffer_object<T>*> _activeBuffers;
+    std::list<buffer_object<T>*> _unusedBuffers;
 };
 
 /**
@@ -172,16 +208,23 @@ class buffer_fragment
     buffer_fragment(buffer_object_ptr<T> buffer, span_type region) noexcept;
 
     buffer_fragment() noexcept = default;
-    buffer_fragment(buffer_fragment&&) noexcept = default;
-    buffer_fragment(buffer_fragment const&) noexcept = default;
-    buffer_fragment& operator=(buffer_fragment&&) noexcept = default;
-    buffer_fragment& operator=(buffer_fragment const&) noexcept = default;
+    buffer_fragment(buffer_fragment&& other) noexcept;
+    buffer_fragment(buffer_fragment const& other) noexcept;
+    buffer_fragment& operator=(buffer_fragment&& other) noexcept;
+    buffer_fragment& operator=(buffer_fragment const& other) noexcept;
+    ~buffer_fragment() { detach(); }
 
-    void reset() noexcept { _region = {}; }
+    void reset() noexcept
+    {
+        detach();
+        _buffer.reset();
+        _region = {};
+    }
 
     void growBy(std::size_t byteCount) noexcept
     {
         _region = span_type(_region.data(), _region.size() + byteCount);
+        _buffer->_liveBytes.fetch_add(byteCount, std::memory_order_relaxed);
     }
 
     [[nodiscard]] std::basic_string_view<T> view() const noexcept
@@ -204,6 +247,18 @@ class buffer_fragment
     [[nodiscard]] std::size_t endOffset() const noexcept;
 
   private:
+    void attach() noexcept
+    {
+        if (_buffer)
+            _buffer->_liveBytes.fetch_add(_region.size(), std::memory_order_relaxed);
+    }
+
+    void detach() noexcept
+    {
+        if (_buffer)
+            _buffer->_liveBytes.fetch_sub(_region.size(), std::memory_order_relaxed);
+    }
+
     buffer_object_ptr<T> _buffer;
     span_type _region;
 };
@@ -214,6 +269,49 @@ buffer_fragment(buffer_object_ptr<T>, gsl::span<T const>) -> buffer_fragment<T>;
 template <BufferObjectElementType T>
 buffer_fragment(buffer_object_ptr<T>, std::basic_string_view<T>) -> buffer_fragment<T>;
 
+/**
+ * Relocates buffer fragments out of sparsely referenced buffer objects into densely packed ones.
+ *
+ * A buffer fragment keeps its whole buffer object alive. Once most of the fragments into a
+ * buffer object are gone, the few surviving ones would keep pinning all of it.
+ * Relocating those into a dense arena allows the buffer object to be released.
+ */
+template <BufferObjectElementType T>
+class buffer_fragment_compactor
+{
+  public:
+    /// @param arena         Pool to allocate the buffer objects from that fragments are relocated into.
+    /// @param maxLiveRatio  Buffer objects with at most this share of their used bytes still being
+    ///                      referenced are considered sparse.
+    explicit buffer_fragment_compactor(buffer_object_pool<T>& arena, float maxLiveRatio = 0.25f) noexcept:
+        _arena { arena }, _maxLiveRatio { maxLiveRatio }
+    {
+    }
+
+    /// Never relocates fragments out of the given buffer object, such as one still being written to.
+    void exclude(buffer_object<T> const* buffer) noexcept { _excluded = buffer; }
+
+    /// Relocates the given fragment into the arena if its buffer object is sparse.
+    ///
+    /// @returns true if the fragment has been relocated, false otherwise.
+    bool compact(buffer_fragment<T>& fragment);
+
+    /// Total number of bytes relocated so far.
+    [[nodiscard]] std::size_t relocatedBytes() const noexcept { return _relocatedBytes; }
+
+  private:
+    [[nodiscard]] bool isSparse(buffer_object<T> const& buffer) const noexcept
+    {
+        return float(buffer.liveBytes()) <= _maxLiveRatio * float(buffer.bytesUsed());
+    }
+
+    buffer_object_pool<T>& _arena;
+    float _maxLiveRatio;
+    buffer_object<T> const* _excluded = nullptr;
+    buffer_object_ptr<T> _current; // arena buffer object currently being filled
+    std::size_t _relocatedBytes = 0;
+};
+
 // {{{ buffer_object implementation
 template <BufferObjectElementType T>
 buffer_object<T>::buffer_object(size_t capacity) noexcept:
@@ -325,6 +423,45 @@ buffer_fragment<T>::buffer_fragment(buffer_object_ptr<T> buffer, gsl::span<T con
     _buffer { std::move(buffer) }, _region { region }
 {
     assert(_buffer->begin() <= _region.data() && (_region.data() + _region.size()) <= _buffer->end());
+    attach();
+}
+
+template <BufferObjectElementType T>
+buffer_fragment<T>::buffer_fragment(buffer_fragment&& other) noexcept:
+    _buffer { std::move(other._buffer) }, _region { std::exchange(other._region, {}) }
+{
+}
+
+template <BufferObjectElementType T>
+buffer_fragment<T>::buffer_fragment(buffer_fragment const& other) noexcept:
+    _buffer { other._buffer }, _region { other._region }
+{
+    attach();
+}
+
+template <BufferObjectElementType T>
+buffer_fragment<T>& buffer_fragment<T>::operator=(buffer_fragment&& other) noexcept
+{
+    if (this != &other)
+    {
+        detach();
+        _buffer = std::move(other._buffer);
+        _region = std::exchange(other._region, {});
+    }
+    return *this;
+}
+
+template <BufferObjectElementType T>
+buffer_fragment<T>& buffer_fragment<T>::operator=(buffer_fragment const& other) noexcept
+{
+    if (this != &other)
+    {
+        detach();
+        _buffer = other._buffer;
+        _region = other._region;
+        attach();
+    }
+    return *this;
 }
 
 template <BufferObjectElementType T>
@@ -340,6 +477,29 @@ inline std::size_t buffer_fragment<T>::endOffset() const noexcept
 }
 // }}}
 
+// {{{ buffer_fragment_compactor implementation
+template <BufferObjectElementType T>
+bool buffer_fragment_compactor<T>::compact(buffer_fragment<T>& fragment)
+{
+    auto const& owner = fragment.owner();
+    if (!owner || fragment.empty() || owner.get() == _excluded || owner == _current || !isSparse(*owner))
+        return false;
+
+    if (!_current || _current->bytesAvailable() < fragment.size())
+    {
+        if (fragment.size() > _arena.bufferSize())
+            return false;
+        _current = _arena.allocateBufferObject();
+    }
+
+    auto const region = _current->advance(fragment.size());
+    std::memcpy(region.data(), fragment.data(), fragment.size());
+    _relocatedBytes += fragment.size();
+    fragment = buffer_fragment<T>(_current, gsl::span<T const>(region.data(), region.size()));
+    return true;
+}
+// }}}
+
 // {{{ BufferObjectPool implementation
 template <BufferObjectElementType T>
 buffer_object_pool<T>::buffer_object_pool(size_t bufferSize): _bufferSize { bufferSize }
@@ -351,55 +511,94 @@ buffer_object_pool<T>::buffer_object_pool(size_t bufferSize): _bufferSize { buff
 template <BufferObjectElementType T>
 buffer_object_pool<T>::~buffer_object_pool()
 {
+    auto const _ = std::lock_guard { _mutex };
     _reuseBuffers = false;
+    for (auto* buffer: _unusedBuffers)
+        destroy(buffer);
+    _unusedBuffers.clear();
 }
 
 template <BufferObjectElementType T>
 size_t buffer_object_pool<T>::unusedBuffers() const noexcept
 {
+    auto const _ = std::lock_guard { _mutex };
     return _unusedBuffers.size();
 }
 
 template <BufferObjectElementType T>
 void buffer_object_pool<T>::releaseUnusedBuffers()
 {
-    _reuseBuffers = false;
+    auto const _ = std::lock_guard { _mutex };
+    for (auto* buffer: _unusedBuffers)
+        destroy(buffer);
     _unusedBuffers.clear();
-    _reuseBuffers = true;
 }
 
 template <BufferObjectElementType T>
 buffer_object_ptr<T> buffer_object_pool<T>::allocateBufferObject()
 {
+    auto lock = std::unique_lock { _mutex };
     if (_unusedBuffers.empty())
-        return buffer_object<T>::create(_bufferSize, [this](auto p) { release(p); });
+    {
+        lock.unlock();
+        auto buffer = buffer_object<T>::create(_bufferSize, [this](auto p) { release(p); });
+        lock.lock();
+        _activeBuffers.push_back(buffer.get());
+        return buffer;
+    }
 
-    buffer_object_ptr<T> buffer = std::move(_unusedBuffers.front());
+    auto* buffer = _unusedBuffers.front();
     if (bufferObjectLog)
-        bufferObjectLog()("Recycling BufferObject from pool: @{}.", (void*) buffer.get());
+        bufferObjectLog()("Recycling BufferObject from pool: @{}.", (void*) buffer);
     _unusedBuffers.pop_front();
-    return buffer;
+    _activeBuffers.push_back(buffer);
+    return buffer_object_ptr<T>(buffer, [this](auto p) { release(p); });
+}
+
+template <BufferObjectElementType T>
+buffer_object_pool_statistics buffer_object_pool<T>::statistics() const
+{
+    auto const _ = std::lock_guard { _mutex };
+    auto result = buffer_object_pool_statistics {};
+    result.buffers = _activeBuffers.size();
+    result.unusedBuffers = _unusedBuffers.size();
+    for (auto const* buffer: _activeBuffers)
+    {
+        result.reservedBytes += buffer->capacity();
+        result.usedBytes += buffer->bytesUsed();
+        result.liveBytes += buffer->liveBytes();
+    }
+    for (auto const* buffer: _unusedBuffers)
+        result.reservedBytes += buffer->capacity();
+    return result;
 }
 
 template <BufferObjectElementType T>
 void buffer_object_pool<T>::release(buffer_object<T>* ptr)
 {
+    auto const _ = std::lock_guard { _mutex };
+    _activeBuffers.erase(std::remove(_activeBuffers.begin(), _activeBuffers.end(), ptr),
+                         _activeBuffers.end());
     if (_reuseBuffers)
     {
         if (bufferObjectLog)
             bufferObjectLog()("Releasing BufferObject from pool: @{}", (void*) ptr);
         ptr->reset();
-        _unusedBuffers.emplace_back(ptr, [this](auto p) { release(p); });
+        _unusedBuffers.emplace_back(ptr);
     }
     else
-    {
+        destroy(ptr);
+}
+
+template <BufferObjectElementType T>
+void buffer_object_pool<T>::destroy(buffer_object<T>* ptr)
+{
 #if defined(BUFFER_OBJECT_INLINE)
-        std::destroy_n(ptr, 1);
-        free(ptr);
+    std::destroy_n(ptr, 1);
+    free(ptr);
 #else
-        delete ptr;
+    delete ptr;
 #endif
-    }
 }
 // }}}
 
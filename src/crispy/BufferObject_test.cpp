@@ -3,7 +3,91 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <string_view>
+
 TEST_CASE("buffer_object", "[buffer_object]")
 {
     // TODO
 }
+
+TEST_CASE("buffer_object.liveBytes", "[buffer_object]")
+{
+    auto pool = crispy::buffer_object_pool<char>(64);
+    auto buffer = pool.allocateBufferObject();
+    buffer->advance(10);
+    CHECK(buffer->liveBytes() == 0);
+
+    auto a = buffer->ref(0, 4);
+    CHECK(buffer->liveBytes() == 4);
+
+    auto b = a; // copies count twice
+    CHECK(buffer->liveBytes() == 8);
+
+    auto c = std::move(b);
+    CHECK(buffer->liveBytes() == 8);
+
+    c.growBy(2);
+    CHECK(buffer->liveBytes() == 10);
+
+    c.reset();
+    CHECK(buffer->liveBytes() == 4);
+
+    a = crispy::buffer_fragment<char> {};
+    CHECK(buffer->liveBytes() == 0);
+}
+
+TEST_CASE("buffer_object_pool.statistics", "[buffer_object]")
+{
+    auto pool = crispy::buffer_object_pool<char>(64);
+    auto buffer = pool.allocateBufferObject();
+    buffer->advance(10);
+    auto const fragment = buffer->ref(2, 3);
+
+    auto const stats = pool.statistics();
+    CHECK(stats.buffers == 1);
+    CHECK(stats.unusedBuffers == 0);
+    CHECK(stats.reservedBytes == buffer->capacity());
+    CHECK(stats.usedBytes == 10);
+    CHECK(stats.liveBytes == 3);
+}
+
+TEST_CASE("buffer_fragment_compactor", "[buffer_object]")
+{
+    auto pool = crispy::buffer_object_pool<char>(64);
+    auto arena = crispy::buffer_object_pool<char>(64);
+    auto compactor = crispy::buffer_fragment_compactor<char>(arena, 0.25f);
+
+    auto fragment = crispy::buffer_fragment<char> {};
+    {
+        auto buffer = pool.allocateBufferObject();
+        auto const text = std::string_view("Hello, World! This is mostly dead.");
+        (void) buffer->writeAtEnd(gsl::span<char const>(text.data(), text.size()));
+        buffer->advance(text.size());
+        auto dense = buffer->ref(0, text.size());
+
+        // The buffer object is fully referenced, so nothing is relocated.
+        fragment = buffer->ref(7, 5);
+        CHECK_FALSE(compactor.compact(fragment));
+
+        // Once the majority of the buffer object is gone, the survivor is relocated.
+        dense.reset();
+        compactor.exclude(buffer.get());
+        CHECK_FALSE(compactor.compact(fragment));
+        compactor.exclude(nullptr);
+    }
+
+    CHECK(pool.statistics().buffers == 1); // still pinned by the surviving fragment
+    CHECK(compactor.compact(fragment));
+    CHECK(fragment.view() == "World");
+    CHECK(compactor.relocatedBytes() == 5);
+
+    auto const stats = pool.statistics();
+    CHECK(stats.buffers == 0);
+    CHECK(stats.unusedBuffers == 1);
+
+    pool.releaseUnusedBuffers();
+    CHECK(pool.statistics().reservedBytes == 0);
+
+    // Fragments already living in the arena are not relocated again.
+    CHECK_FALSE(compactor.compact(fragment));
+}
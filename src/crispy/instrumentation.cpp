@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <crispy/instrumentation.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <format>
+#include <new>
+
+namespace crispy::instrumentation
+{
+
+namespace
+{
+    struct atomic_stage_counters
+    {
+        std::atomic<uint64_t> calls = 0;
+        std::atomic<uint64_t> bytes = 0;
+        std::atomic<uint64_t> allocations = 0;
+        std::atomic<uint64_t> nanoseconds = 0;
+    };
+
+    // NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+    std::array<atomic_stage_counters, stage_count> stageCounters;
+    std::atomic<uint64_t> heapAllocationCount = 0;
+#if defined(CONTOUR_INSTRUMENTATION)
+    thread_local uint64_t threadHeapAllocationCount = 0;
+    thread_local scoped_stage* currentStage = nullptr;
+#endif
+    // NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+    double ratio(uint64_t a, uint64_t b) noexcept
+    {
+        return b != 0 ? static_cast<double>(a) / static_cast<double>(b) : 0.0;
+    }
+} // namespace
+
+std::string_view name(stage s) noexcept
+{
+    switch (s)
+    {
+        case stage::parser: return "parser";
+        case stage::dispatch: return "dispatch";
+        case stage::write_text: return "writeText";
+        case stage::scroll_up: return "scrollUp";
+        case stage::render_buffer: return "renderBuffer";
+        case stage::text_renderer: return "textRenderer";
+        case stage::gpu_execute: return "gpuExecute";
+    }
+    return "unknown";
+}
+
+counters snapshot() noexcept
+{
+    auto result = counters {};
+    for (size_t i = 0; i < stage_count; ++i)
+    {
+        result[i].calls = stageCounters[i].calls.load(std::memory_order_relaxed);
+        result[i].bytes = stageCounters[i].bytes.load(std::memory_order_relaxed);
+        result[i].allocations = stageCounters[i].allocations.load(std::memory_order_relaxed);
+        result[i].nanoseconds = stageCounters[i].nanoseconds.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+void reset() noexcept
+{
+    for (auto& counter: stageCounters)
+    {
+        counter.calls.store(0, std::memory_order_relaxed);
+        counter.bytes.store(0, std::memory_order_relaxed);
+        counter.allocations.store(0, std::memory_order_relaxed);
+        counter.nanoseconds.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t heap_allocations() noexcept
+{
+    return heapAllocationCount.load(std::memory_order_relaxed);
+}
+
+std::string report(counters const& values)
+{
+    auto text = std::format("{:<14} {:>12} {:>14} {:>12} {:>10} {:>12} {:>10} {:>10}\n",
+                            "Stage",
+                            "Calls",
+                            "Bytes",
+                            "Allocations",
+                            "Allocs/KB",
+                            "Total (ms)",
+                            "ns/call",
+                            "ns/byte");
+    for (size_t i = 0; i < stage_count; ++i)
+    {
+        auto const& value = values[i];
+        text += std::format("{:<14} {:>12} {:>14} {:>12} {:>10.2f} {:>12.3f} {:>10.1f} {:>10.2f}\n",
+                            name(static_cast<stage>(i)),
+                            value.calls,
+                            value.bytes,
+                            value.allocations,
+                            ratio(value.allocations * 1024, value.bytes),
+                            static_cast<double>(value.nanoseconds) / 1e6,
+                            ratio(value.nanoseconds, value.calls),
+                            ratio(value.nanoseconds, value.bytes));
+    }
+    return text;
+}
+
+#if defined(CONTOUR_INSTRUMENTATION)
+scoped_stage::scoped_stage(stage s, size_t bytes) noexcept:
+    _stage { s },
+    _bytes { bytes },
+    _parent { currentStage },
+    _startAllocations { threadHeapAllocationCount },
+    _startTime { std::chrono::steady_clock::now() }
+{
+    currentStage = this;
+}
+
+scoped_stage::~scoped_stage()
+{
+    auto const elapsed = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _startTime)
+            .count());
+    auto const allocations = threadHeapAllocationCount - _startAllocations;
+
+    auto& counter = stageCounters[static_cast<size_t>(_stage)];
+    counter.calls.fetch_add(1, std::memory_order_relaxed);
+    counter.bytes.fetch_add(_bytes, std::memory_order_relaxed);
+    counter.allocations.fetch_add(allocations - _nestedAllocations, std::memory_order_relaxed);
+    counter.nanoseconds.fetch_add(elapsed - std::min(elapsed, _nestedNanoseconds), std::memory_order_relaxed);
+
+    if (_parent)
+    {
+        _parent->_nestedAllocations += allocations;
+        _parent->_nestedNanoseconds += elapsed;
+    }
+    currentStage = _parent;
+}
+#endif
+
+} // namespace crispy::instrumentation
+
+#if defined(CONTOUR_INSTRUMENTATION)
+// {{{ counting global allocation functions
+void* operator new(size_t size)
+{
+    ++crispy::instrumentation::threadHeapAllocationCount;
+    crispy::instrumentation::heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size != 0 ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t /*size*/) noexcept
+{
+    std::free(p);
+}
+// }}}
+#endif
@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * Hot path instrumentation of the VT processing and rendering pipeline.
+ *
+ * With the CONTOUR_INSTRUMENTATION build option enabled, the global operator new is replaced
+ * by a counting one, and every stage of the pipeline that is marked with CRISPY_INSTRUMENT_STAGE()
+ * accumulates its number of calls, input bytes, heap allocations, and wall time.
+ *
+ * Nested stages are accounted to the innermost stage only, e.g. the time spent in Screen::writeText()
+ * while parsing does not count towards the parser stage, so that the counters of all stages add up.
+ *
+ * Without that build option, CRISPY_INSTRUMENT_STAGE() expands to nothing,
+ * and the counters remain zero.
+ */
+namespace crispy::instrumentation
+{
+
+enum class stage : uint8_t
+{
+    parser,        // VT parser, excluding whatever it dispatches to
+    dispatch,      // dispatching control functions and sequences to the screen
+    write_text,    // Screen::writeText()
+    scroll_up,     // Grid::scrollUp()
+    render_buffer, // RenderBufferBuilder
+    text_renderer, // vtrasterizer::TextRenderer
+    gpu_execute,   // OpenGLRenderer::execute()
+};
+
+constexpr inline size_t stage_count = 7;
+
+#if defined(CONTOUR_INSTRUMENTATION)
+constexpr inline bool enabled = true;
+#else
+constexpr inline bool enabled = false;
+#endif
+
+struct stage_counters
+{
+    uint64_t calls = 0;
+    uint64_t bytes = 0;       // input bytes, for stages that consume a byte stream
+    uint64_t allocations = 0; // heap allocations
+    uint64_t nanoseconds = 0;
+};
+
+using counters = std::array<stage_counters, stage_count>;
+
+[[nodiscard]] std::string_view name(stage s) noexcept;
+
+/// Returns the counters accumulated by all threads since startup or the last reset().
+[[nodiscard]] counters snapshot() noexcept;
+
+void reset() noexcept;
+
+/// Total number of heap allocations performed by all threads, or 0 if not instrumented.
+[[nodiscard]] uint64_t heap_allocations() noexcept;
+
+/// Formats the given counters as a human readable table.
+[[nodiscard]] std::string report(counters const& values);
+
+#if defined(CONTOUR_INSTRUMENTATION)
+/// Accounts the lifetime of this object to the given stage.
+class scoped_stage
+{
+  public:
+    scoped_stage(stage s, size_t bytes) noexcept;
+    ~scoped_stage();
+
+    scoped_stage(scoped_stage const&) = delete;
+    scoped_stage(scoped_stage&&) = delete;
+    scoped_stage& operator=(scoped_stage const&) = delete;
+    scoped_stage& operator=(scoped_stage&&) = delete;
+
+  private:
+    stage _stage;
+    size_t _bytes;
+    scoped_stage* _parent;
+    uint64_t _startAllocations;
+    std::chrono::steady_clock::time_point _startTime;
+    uint64_t _nestedAllocations = 0;
+    uint64_t _nestedNanoseconds = 0;
+};
+#endif
+
+} // namespace crispy::instrumentation
+
+#if defined(CONTOUR_INSTRUMENTATION)
+    #define CRISPY_INSTRUMENT_STAGE(stageName, byteCount)                                 \
+        ::crispy::instrumentation::scoped_stage const _instrumentedStage                  \
+        {                                                                                 \
+            ::crispy::instrumentation::stage::stageName, static_cast<size_t>(byteCount)   \
+        }
+#else
+    #define CRISPY_INSTRUMENT_STAGE(stageName, byteCount) static_cast<void>(0)
+#endif
@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <crispy/instrumentation.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <new>
+
+using crispy::instrumentation::stage;
+
+TEST_CASE("instrumentation.report")
+{
+    auto const text = crispy::instrumentation::report(crispy::instrumentation::counters {});
+    for (size_t i = 0; i < crispy::instrumentation::stage_count; ++i)
+        CHECK(text.find(crispy::instrumentation::name(static_cast<stage>(i))) != std::string::npos);
+}
+
+#if defined(CONTOUR_INSTRUMENTATION)
+namespace
+{
+// Calls the allocation function directly, as new-expressions may be optimized away.
+void allocateAndRelease()
+{
+    ::operator delete(::operator new(sizeof(int)));
+}
+} // namespace
+
+TEST_CASE("instrumentation.nested_stages")
+{
+    crispy::instrumentation::reset();
+    {
+        CRISPY_INSTRUMENT_STAGE(parser, 10);
+        allocateAndRelease();
+        {
+            CRISPY_INSTRUMENT_STAGE(write_text, 4);
+            allocateAndRelease();
+            allocateAndRelease();
+        }
+    }
+
+    auto const counters = crispy::instrumentation::snapshot();
+    auto const& parser = counters[static_cast<size_t>(stage::parser)];
+    auto const& writeText = counters[static_cast<size_t>(stage::write_text)];
+    CHECK(parser.calls == 1);
+    CHECK(parser.bytes == 10);
+    CHECK(parser.allocations == 1); // excludes the nested stage's allocations
+    CHECK(writeText.calls == 1);
+    CHECK(writeText.bytes == 4);
+    CHECK(writeText.allocations == 2);
+}
+#endif
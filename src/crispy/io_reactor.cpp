@@ -0,0 +1,204 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <crispy/io_reactor.h>
+
+#if defined(__linux__)
+
+    #include <crispy/assert.h>
+    #include <crispy/logstore.h>
+
+    #include <cstring>
+    #include <system_error>
+
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+
+    #include <pthread.h>
+
+namespace crispy
+{
+
+namespace
+{
+    // Identifies the stop event. Never handed out as a source_id.
+    constexpr io_reactor::source_id StopId = 0;
+} // namespace
+
+io_reactor::io_reactor(size_t workerCount)
+{
+    Require(workerCount > 0);
+
+    _epollFd = file_descriptor::from_native(epoll_create1(EPOLL_CLOEXEC));
+    _stopFd = file_descriptor::from_native(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+
+    // Level-triggered and never drained, so that every worker gets to see it once signaled.
+    auto event = epoll_event {};
+    event.events = EPOLLIN;
+    event.data.u64 = StopId;
+    if (epoll_ctl(_epollFd, EPOLL_CTL_ADD, _stopFd, &event) < 0)
+        throw std::system_error(errno, std::system_category(), "epoll_ctl() failed");
+
+    _workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i)
+        _workers.emplace_back([this]() { worker_main(); });
+}
+
+io_reactor::~io_reactor()
+{
+    auto const value = eventfd_t { 1 };
+    if (::write(_stopFd, &value, sizeof(value)) < 0)
+        errorLog()("Failed to signal I/O reactor to stop. {}", strerror(errno));
+
+    for (auto& worker: _workers)
+        worker.join();
+}
+
+io_reactor::source_id io_reactor::add(std::vector<int> const& fds, handler fn)
+{
+    Require(!fds.empty());
+
+    auto const _ = std::lock_guard { _mutex };
+    auto const id = _nextId++;
+    auto s = std::make_shared<source>(source { .fds = fds, .fn = std::move(fn) });
+
+    for (auto const fd: fds)
+    {
+        auto event = epoll_event {};
+        event.events = EPOLLIN | EPOLLONESHOT;
+        event.data.u64 = id;
+        if (epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &event) < 0)
+        {
+            auto const error = errno;
+            unwatch(*s);
+            throw std::system_error(error, std::system_category(), "epoll_ctl() failed");
+        }
+    }
+
+    _sources.emplace(id, std::move(s));
+    return id;
+}
+
+void io_reactor::remove(source_id id)
+{
+    auto lock = std::unique_lock { _mutex };
+    auto const i = _sources.find(id);
+    if (i == _sources.end())
+        return;
+
+    auto const s = i->second;
+    _sources.erase(i);
+    s->removed = true;
+    unwatch(*s);
+
+    if (s->runner != std::this_thread::get_id())
+        _handlerReturned.wait(lock, [&]() { return s->runner == std::thread::id {}; });
+}
+
+size_t io_reactor::size() const
+{
+    auto const _ = std::lock_guard { _mutex };
+    return _sources.size();
+}
+
+void io_reactor::worker_main()
+{
+    pthread_setname_np(pthread_self(), "IO.Reactor");
+
+    for (;;)
+    {
+        // Fetch one event at a time, so that ready sources are spread across all idle workers.
+        auto event = epoll_event {};
+        auto const result = epoll_wait(_epollFd, &event, 1, -1);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            errorLog()("I/O reactor failed to wait for events. {}", strerror(errno));
+            return;
+        }
+
+        if (result == 0)
+            continue;
+
+        if (event.data.u64 == StopId)
+            return;
+
+        dispatch(event.data.u64);
+    }
+}
+
+void io_reactor::dispatch(source_id id)
+{
+    auto lock = std::unique_lock { _mutex };
+    auto const i = _sources.find(id);
+    if (i == _sources.end())
+        return;
+
+    auto const s = i->second;
+    if (s->runner != std::thread::id {})
+    {
+        // Another one of its file descriptors fired while the handler is running on another worker.
+        // Have that worker run the handler once more instead.
+        s->pending = true;
+        return;
+    }
+
+    s->runner = std::this_thread::get_id();
+    for (;;)
+    {
+        lock.unlock();
+        auto keep = false;
+        try
+        {
+            keep = s->fn();
+        }
+        catch (std::exception const& e)
+        {
+            errorLog()("Unhandled exception caught in I/O handler. {}", e.what());
+        }
+        lock.lock();
+
+        if (!keep || !s->pending || s->removed)
+            break;
+        s->pending = false;
+    }
+
+    // A source being removed has already been unwatched and erased by remove().
+    if (!s->removed)
+    {
+        if (keep)
+            rearm(id, *s);
+        else
+        {
+            unwatch(*s);
+            _sources.erase(id);
+        }
+    }
+
+    // Reset while still holding the lock, so that readiness reported right after re-arming
+    // is dispatched rather than mistaken as pending.
+    s->runner = {};
+    _handlerReturned.notify_all();
+}
+
+void io_reactor::rearm(source_id id, source const& s) const noexcept
+{
+    for (auto const fd: s.fds)
+    {
+        auto event = epoll_event {};
+        event.events = EPOLLIN | EPOLLONESHOT;
+        event.data.u64 = id;
+        if (epoll_ctl(_epollFd, EPOLL_CTL_MOD, fd, &event) < 0)
+            errorLog()("Failed to re-arm file descriptor {} in I/O reactor. {}", fd, strerror(errno));
+    }
+}
+
+void io_reactor::unwatch(source const& s) const noexcept
+{
+    // Errors are ignored, as the file descriptor may have been closed already.
+    for (auto const fd: s.fds)
+        epoll_ctl(_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+} // namespace crispy
+
+#endif
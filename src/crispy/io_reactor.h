@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#if defined(__linux__)
+
+    #include <crispy/file_descriptor.h>
+
+    #include <condition_variable>
+    #include <cstdint>
+    #include <functional>
+    #include <memory>
+    #include <mutex>
+    #include <thread>
+    #include <unordered_map>
+    #include <vector>
+
+namespace crispy
+{
+
+/**
+ * Dispatches readiness of many file descriptor sources onto a small, fixed pool of worker threads.
+ *
+ * A source is a set of file descriptors together with a handler that is invoked whenever any of
+ * them becomes readable. All file descriptors are watched by a single epoll instance in one-shot
+ * mode, so that a source's handler is never run by more than one worker at a time, and its file
+ * descriptors are re-armed only after the handler has returned.
+ *
+ * Handlers are expected to consume whatever is available without blocking and then return.
+ * Data left unconsumed will cause the source to be dispatched again, on whichever worker is free.
+ */
+class io_reactor
+{
+  public:
+    using source_id = uint64_t;
+
+    /// Invoked on a worker thread when the source has become readable.
+    ///
+    /// @returns false if the source shall be removed, true otherwise.
+    using handler = std::function<bool()>;
+
+    explicit io_reactor(size_t workerCount);
+    io_reactor(io_reactor const&) = delete;
+    io_reactor(io_reactor&&) = delete;
+    io_reactor& operator=(io_reactor const&) = delete;
+    io_reactor& operator=(io_reactor&&) = delete;
+    ~io_reactor();
+
+    /// Registers a new source, watching the given file descriptors for readability.
+    ///
+    /// The handler may be invoked before this call returns.
+    [[nodiscard]] source_id add(std::vector<int> const& fds, handler fn);
+
+    /// Unregisters the given source, waiting for its handler to return if currently running.
+    ///
+    /// When invoked from within the source's own handler, this call does not wait.
+    void remove(source_id id);
+
+    [[nodiscard]] size_t worker_count() const noexcept { return _workers.size(); }
+
+    /// Number of currently registered sources.
+    [[nodiscard]] size_t size() const;
+
+  private:
+    struct source
+    {
+        std::vector<int> fds;
+        handler fn;
+        std::thread::id runner {}; // worker currently running the handler, if any
+        bool pending = false;      // readiness was reported while the handler was running
+        bool removed = false;
+    };
+
+    void worker_main();
+    void dispatch(source_id id);
+    void rearm(source_id id, source const& s) const noexcept;
+    void unwatch(source const& s) const noexcept;
+
+    file_descriptor _epollFd;
+    file_descriptor _stopFd;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _handlerReturned;
+    std::unordered_map<source_id, std::shared_ptr<source>> _sources;
+    source_id _nextId = 1;
+
+    std::vector<std::thread> _workers;
+};
+
+} // namespace crispy
+
+#endif
@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <crispy/io_reactor.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#if defined(__linux__)
+
+    #include <atomic>
+    #include <chrono>
+    #include <cstring>
+    #include <thread>
+
+    #include <fcntl.h>
+    #include <unistd.h>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+struct pipe_pair
+{
+    int reader = -1;
+    int writer = -1;
+
+    pipe_pair()
+    {
+        int fds[2];
+        REQUIRE(pipe2(fds, O_NONBLOCK | O_CLOEXEC) == 0);
+        reader = fds[0];
+        writer = fds[1];
+    }
+
+    ~pipe_pair()
+    {
+        close(reader);
+        close(writer);
+    }
+
+    pipe_pair(pipe_pair const&) = delete;
+    pipe_pair& operator=(pipe_pair const&) = delete;
+
+    void send(char const* text) const { REQUIRE(write(writer, text, strlen(text)) > 0); }
+
+    size_t drain() const
+    {
+        char buf[64];
+        size_t total = 0;
+        for (auto n = read(reader, buf, sizeof(buf)); n > 0; n = read(reader, buf, sizeof(buf)))
+            total += static_cast<size_t>(n);
+        return total;
+    }
+};
+
+template <typename Predicate>
+bool waitUntil(Predicate predicate)
+{
+    for (auto i = 0; i < 500 && !predicate(); ++i)
+        std::this_thread::sleep_for(2ms);
+    return predicate();
+}
+} // namespace
+
+TEST_CASE("io_reactor.dispatch")
+{
+    auto reactor = crispy::io_reactor(2);
+    auto channel = pipe_pair {};
+    auto received = std::atomic<size_t> { 0 };
+
+    auto const id = reactor.add({ channel.reader }, [&]() {
+        received += channel.drain();
+        return true;
+    });
+    CHECK(reactor.size() == 1);
+
+    channel.send("Hello");
+    REQUIRE(waitUntil([&]() { return received == 5; }));
+
+    // The source is re-armed after its handler returned.
+    channel.send(", World");
+    REQUIRE(waitUntil([&]() { return received == 12; }));
+
+    reactor.remove(id);
+    CHECK(reactor.size() == 0);
+}
+
+TEST_CASE("io_reactor.handler_returning_false_removes_source")
+{
+    auto reactor = crispy::io_reactor(1);
+    auto channel = pipe_pair {};
+    auto calls = std::atomic<int> { 0 };
+
+    (void) reactor.add({ channel.reader }, [&]() {
+        channel.drain();
+        ++calls;
+        return false;
+    });
+
+    channel.send("x");
+    REQUIRE(waitUntil([&]() { return reactor.size() == 0; }));
+
+    channel.send("y");
+    std::this_thread::sleep_for(20ms);
+    CHECK(calls == 1);
+}
+
+TEST_CASE("io_reactor.one_handler_at_a_time_per_source")
+{
+    auto reactor = crispy::io_reactor(4);
+    auto first = pipe_pair {};
+    auto second = pipe_pair {};
+    auto concurrent = std::atomic<int> { 0 };
+    auto maxConcurrent = std::atomic<int> { 0 };
+    auto received = std::atomic<size_t> { 0 };
+
+    auto const id = reactor.add({ first.reader, second.reader }, [&]() {
+        auto const current = ++concurrent;
+        if (current > maxConcurrent)
+            maxConcurrent = current;
+        std::this_thread::sleep_for(5ms);
+        received += first.drain() + second.drain();
+        --concurrent;
+        return true;
+    });
+
+    for (auto i = 0; i < 10; ++i)
+    {
+        first.send("a");
+        second.send("b");
+        std::this_thread::sleep_for(1ms);
+    }
+
+    REQUIRE(waitUntil([&]() { return received == 20; }));
+    CHECK(maxConcurrent == 1);
+    reactor.remove(id);
+}
+
+#endif
@@ -174,6 +174,10 @@ class epoll_read_selector
     void wakeup() const noexcept;
     std::optional<int> wait_one(std::optional<std::chrono::milliseconds> timeout = std::nullopt) noexcept;
 
+    /// Returns the underlying epoll file descriptor, which becomes readable as soon as
+    /// any of the watched file descriptors does, or wakeup() has been called.
+    [[nodiscard]] int native_handle() const noexcept { return _epollFd.get(); }
+
   private:
     std::optional<int> try_pop_pending() noexcept;
 
@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <crispy/thread_pool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace crispy
+{
+
+thread_pool::thread_pool(size_t workerCount)
+{
+    _workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i)
+        _workers.emplace_back([this]() { worker_main(); });
+}
+
+thread_pool::~thread_pool()
+{
+    {
+        auto const _ = std::lock_guard { _mutex };
+        _stopping = true;
+    }
+    _taskAvailable.notify_all();
+
+    for (auto& worker: _workers)
+        worker.join();
+}
+
+thread_pool& thread_pool::shared()
+{
+    static auto pool = thread_pool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+    return pool;
+}
+
+void thread_pool::post(task fn)
+{
+    if (_workers.empty())
+    {
+        fn();
+        return;
+    }
+
+    {
+        auto const _ = std::lock_guard { _mutex };
+        _tasks.emplace_back(std::move(fn));
+    }
+    _taskAvailable.notify_one();
+}
+
+void thread_pool::parallel_for(size_t count, std::function<void(size_t)> const& fn)
+{
+    // Shared with the helper tasks, as those may only start running after this call has returned,
+    // when there is nothing left to do for them.
+    struct state
+    {
+        std::atomic<size_t> next = 0;
+        size_t remaining = 0;
+        std::exception_ptr exception;
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+
+    auto const s = std::make_shared<state>();
+    s->remaining = count;
+
+    auto const run = [s, count, &fn]() {
+        for (auto i = s->next++; i < count; i = s->next++)
+        {
+            auto exception = std::exception_ptr {};
+            try
+            {
+                fn(i);
+            }
+            catch (...)
+            {
+                exception = std::current_exception();
+            }
+
+            auto const _ = std::lock_guard { s->mutex };
+            if (exception && !s->exception)
+                s->exception = exception;
+            if (--s->remaining == 0)
+                s->done.notify_all();
+        }
+    };
+
+    for (size_t i = 1; i < std::min(count, _workers.size() + 1); ++i)
+        post(run);
+
+    run();
+
+    auto lock = std::unique_lock { s->mutex };
+    s->done.wait(lock, [&]() { return s->remaining == 0; });
+    if (s->exception)
+        std::rethrow_exception(s->exception);
+}
+
+void thread_pool::worker_main()
+{
+    while (true)
+    {
+        auto fn = task {};
+        {
+            auto lock = std::unique_lock { _mutex };
+            _taskAvailable.wait(lock, [this]() { return _stopping || !_tasks.empty(); });
+            if (_tasks.empty())
+                return;
+            fn = std::move(_tasks.front());
+            _tasks.pop_front();
+        }
+        fn();
+    }
+}
+
+} // namespace crispy
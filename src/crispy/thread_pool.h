@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace crispy
+{
+
+/**
+ * A fixed number of worker threads running tasks in the order they were posted.
+ *
+ * Meant for CPU bound work that can be split up, such as reflowing a large scrollback,
+ * not for tasks that block on I/O.
+ */
+class thread_pool
+{
+  public:
+    using task = std::function<void()>;
+
+    explicit thread_pool(size_t workerCount);
+    thread_pool(thread_pool const&) = delete;
+    thread_pool(thread_pool&&) = delete;
+    thread_pool& operator=(thread_pool const&) = delete;
+    thread_pool& operator=(thread_pool&&) = delete;
+
+    /// Runs all tasks posted so far before joining the workers.
+    ~thread_pool();
+
+    /// Returns the process wide pool, with one worker less than there are hardware threads,
+    /// as the thread making use of it usually takes part in the work, too.
+    [[nodiscard]] static thread_pool& shared();
+
+    [[nodiscard]] size_t worker_count() const noexcept { return _workers.size(); }
+
+    /// Schedules the given task to be run on one of the workers,
+    /// or runs it right away if this pool has no workers.
+    void post(task fn);
+
+    /// Invokes fn(i) for every i in [0, count), distributed across the workers and the calling thread,
+    /// and returns once all invocations have returned.
+    ///
+    /// The first exception thrown by any invocation is rethrown to the caller,
+    /// after all other invocations have returned.
+    void parallel_for(size_t count, std::function<void(size_t)> const& fn);
+
+  private:
+    void worker_main();
+
+    std::mutex _mutex;
+    std::condition_variable _taskAvailable;
+    std::deque<task> _tasks;
+    bool _stopping = false;
+
+    std::vector<std::thread> _workers;
+};
+
+} // namespace crispy
@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <crispy/thread_pool.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("thread_pool.parallel_for")
+{
+    auto pool = crispy::thread_pool(3);
+    auto visited = std::vector<std::atomic<int>>(1000);
+
+    pool.parallel_for(visited.size(), [&](size_t i) { ++visited[i]; });
+
+    for (auto const& count: visited)
+        REQUIRE(count == 1);
+}
+
+TEST_CASE("thread_pool.parallel_for_without_workers")
+{
+    auto pool = crispy::thread_pool(0);
+    auto sum = size_t { 0 };
+
+    pool.parallel_for(10, [&](size_t i) { sum += i; });
+
+    CHECK(sum == 45);
+}
+
+TEST_CASE("thread_pool.parallel_for_rethrows")
+{
+    auto pool = crispy::thread_pool(2);
+    auto invocations = std::atomic<size_t> { 0 };
+
+    auto const run = [&]() {
+        pool.parallel_for(100, [&](size_t i) {
+            ++invocations;
+            if (i == 42)
+                throw std::runtime_error("42");
+        });
+    };
+
+    CHECK_THROWS_AS(run(), std::runtime_error);
+    CHECK(invocations == 100);
+}
+
+TEST_CASE("thread_pool.destructor_runs_posted_tasks")
+{
+    auto count = std::atomic<int> { 0 };
+    {
+        auto pool = crispy::thread_pool(2);
+        for (int i = 0; i < 100; ++i)
+            pool.post([&]() { ++count; });
+    }
+    CHECK(count == 100);
+}
@@ -33,6 +33,9 @@ namespace vtbackend
 Function const* select(FunctionSelector const& selector,
                        gsl::span<Function const> availableDefinitions) noexcept
 {
+    if (availableDefinitions.empty())
+        return nullptr;
+
     auto a = size_t { 0 };
     auto b = availableDefinitions.size() - 1;
     while (a <= b)
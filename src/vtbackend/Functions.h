@@ -793,12 +793,37 @@ inline auto allFunctions() noexcept
     return funcs;
 }
 
+/// Selects a FunctionDefinition based on a FunctionSelector.
+///
+/// @return the matching FunctionDefinition or nullptr if none matched.
+Function const* select(FunctionSelector const& selector,
+                       gsl::span<Function const> availableDefinition) noexcept;
+
 // Class to store all supported VT sequence and support properly enabling/disabling them
 // The storage stores all available definition at all time and is partitioned into
 // two parts first part contains all active sequences and last part contains all
 // disabled sequences
+//
+// The active sequences are additionally indexed by their category and final symbol,
+// which are the leading sort keys, so that selecting a function only needs to search
+// the few active sequences sharing both, rather than all of them.
 class SupportedSequences
 {
+    // Range of active sequences sharing the same category and final symbol.
+    struct DispatchRange
+    {
+        uint16_t first = 0;
+        uint16_t last = 0;
+    };
+
+    static constexpr size_t FinalSymbolCount = 0x80;
+    static constexpr size_t CategoryCount = 5;
+
+    [[nodiscard]] static constexpr size_t dispatchKey(FunctionCategory category, char finalSymbol) noexcept
+    {
+        return (static_cast<size_t>(category) * FinalSymbolCount)
+               + (static_cast<size_t>(static_cast<unsigned char>(finalSymbol)) % FinalSymbolCount);
+    }
 
   private:
     [[nodiscard]] constexpr auto begin() noexcept { return _supportedSequences.data(); }
@@ -810,6 +835,8 @@ class SupportedSequences
     [[nodiscard]] constexpr auto cend() const noexcept { return cbegin() + _lastIndex; }
 
   public:
+    CRISPY_CONSTEXPR SupportedSequences() noexcept { rebuildDispatchIndex(); }
+
     [[nodiscard]] constexpr gsl::span<Function const> allSequences() const noexcept
     {
         return gsl::span<Function const>(cbegin(), _supportedSequences.size());
@@ -833,6 +860,7 @@ class SupportedSequences
         gsl::span<Function> availableDefinition(begin(), _lastIndex);
         crispy::sort(availableDefinition,
                      [](Function const& a, Function const& b) constexpr { return compare(a, b); });
+        rebuildDispatchIndex();
     }
 
     CRISPY_CONSTEXPR void disableSequence(Function seq) noexcept
@@ -843,6 +871,7 @@ class SupportedSequences
             // Move the disabled sequence to the end of array, keep the rest of active sequences sorted
             std::rotate(seqIter, seqIter + 1, _supportedSequences.data() + _supportedSequences.size());
             --_lastIndex;
+            rebuildDispatchIndex();
         }
     }
 
@@ -857,20 +886,41 @@ class SupportedSequences
             ++_lastIndex;
             gsl::span<Function> arr(begin(), end());
             crispy::sort(arr, [](Function const& a, Function const& b) constexpr { return compare(a, b); });
+            rebuildDispatchIndex();
         }
     }
 
+    /// Selects the active FunctionDefinition matching the given selector.
+    ///
+    /// @return the matching FunctionDefinition or nullptr if none matched.
+    [[nodiscard]] Function const* select(FunctionSelector const& selector) const noexcept
+    {
+        auto const range = _dispatchIndex[dispatchKey(selector.category, selector.finalSymbol)];
+        return vtbackend::select(selector,
+                                 gsl::span<Function const>(cbegin() + range.first, range.last - range.first));
+    }
+
   private:
+    CRISPY_CONSTEXPR void rebuildDispatchIndex() noexcept
+    {
+        // The active sequences are sorted by category and final symbol first,
+        // so that all sequences sharing both are adjacent.
+        _dispatchIndex.fill(DispatchRange {});
+        for (size_t i = 0; i < _lastIndex; ++i)
+        {
+            auto const& function = _supportedSequences[i];
+            auto& range = _dispatchIndex[dispatchKey(function.category, function.finalSymbol)];
+            if (range.first == range.last)
+                range.first = static_cast<uint16_t>(i);
+            range.last = static_cast<uint16_t>(i + 1);
+        }
+    }
+
     std::array<Function, allFunctionsArray().size()> _supportedSequences = allFunctions();
     size_t _lastIndex = allFunctions().size(); // No of total active sequences
+    std::array<DispatchRange, CategoryCount * FinalSymbolCount> _dispatchIndex {};
 };
 
-/// Selects a FunctionDefinition based on a FunctionSelector.
-///
-/// @return the matching FunctionDefinition or nullptr if none matched.
-Function const* select(FunctionSelector const& selector,
-                       gsl::span<Function const> availableDefinition) noexcept;
-
 /// Selects a FunctionDefinition based on given input Escape sequence fields.
 ///
 /// @p intermediate an optional intermediate character between (0x20 .. 0x2F)
@@ -92,3 +92,41 @@ TEST_CASE("Functions.EnableAndDisable", "[Functions]")
     REQUIRE(f);
     CHECK(*f == DECSLRM);
 }
+
+TEST_CASE("Functions.SelectIndexed", "[Functions]")
+{
+    auto const selectorOf = [](Function const& f) {
+        return FunctionSelector { .category = f.category,
+                                  .leader = f.leader,
+                                  .argc = f.category == FunctionCategory::OSC ? f.maximumParameters
+                                                                              : f.minimumParameters,
+                                  .intermediate = f.intermediate,
+                                  .finalSymbol = f.finalSymbol };
+    };
+
+    SupportedSequences availableSequences;
+    availableSequences.disableSequence(DECSLRM);
+    for (auto const& f: availableSequences.allSequences())
+    {
+        INFO(std::format("{}", f));
+        auto const selector = selectorOf(f);
+        CHECK(availableSequences.select(selector)
+              == vtbackend::select(selector, availableSequences.activeSequences()));
+    }
+
+    CHECK(availableSequences.select(selectorOf(SGR)) != nullptr);
+    CHECK(*availableSequences.select(selectorOf(SGR)) == SGR);
+    CHECK(availableSequences.select(selectorOf(DECSLRM)) != nullptr);
+    CHECK(*availableSequences.select(selectorOf(DECSLRM)) == SCOSC);
+
+    availableSequences.reset(VTType::VT100);
+    auto decslrm = selectorOf(DECSLRM);
+    decslrm.argc = 2;
+    CHECK(availableSequences.select(decslrm) == nullptr);
+    CHECK(availableSequences.select(FunctionSelector { .category = FunctionCategory::CSI,
+                                                       .leader = 0,
+                                                       .argc = 0,
+                                                       .intermediate = 0,
+                                                       .finalSymbol = '\x7F' })
+          == nullptr);
+}
@@ -3,11 +3,14 @@
 #include <vtbackend/primitives.h>
 
 #include <crispy/assert.h>
+#include <crispy/instrumentation.h>
 #include <crispy/logstore.h>
+#include <crispy/thread_pool.h>
 
 #include <algorithm>
 #include <format>
 #include <iostream>
+#include <limits>
 
 using std::max;
 using std::min;
@@ -97,6 +100,98 @@ namespace detail
         return LineCount::cast_from(i);
     }
 
+    /// Reflowing fewer lines than this is not worth handing them over to other threads.
+    constexpr inline auto MinParallelReflowLineCount = size_t { 8192 };
+
+    /**
+     * Splits the lines [first, last) into chunks that can be reflowed independently of each other.
+     *
+     * Every chunk but the first one begins at a line satisfying isChunkStart, i.e. at the beginning
+     * of a logical line, so that the result only depends on what is carried over from one chunk
+     * into the next, which is merged in while stitching the chunks back together.
+     *
+     * @returns the first line of each chunk.
+     */
+    template <typename IsChunkStart>
+    std::vector<int> reflowChunkStarts(int first, int last, IsChunkStart const& isChunkStart)
+    {
+        auto starts = std::vector<int> { first };
+
+        auto const lineCount = static_cast<size_t>(last - first);
+        auto const concurrency = crispy::thread_pool::shared().worker_count() + 1;
+        if (concurrency < 2 || lineCount < MinParallelReflowLineCount)
+            return starts;
+
+        // More chunks than threads, as the chunks vary in size.
+        auto const chunkSize =
+            static_cast<int>(max(lineCount / (concurrency * 4), MinParallelReflowLineCount / 8));
+
+        for (auto i = first + chunkSize; i < last; ++i)
+        {
+            if (isChunkStart(i))
+            {
+                starts.push_back(i);
+                i += chunkSize - 1;
+            }
+        }
+
+        return starts;
+    }
+
+    /// Invokes reflow(chunkIndex, firstLine, lastLine) for every chunk in parallel.
+    template <typename Result, typename Reflow>
+    std::vector<Result> reflowChunks(std::vector<int> const& starts, int last, Reflow const& reflow)
+    {
+        auto results = std::vector<Result>(starts.size());
+        crispy::thread_pool::shared().parallel_for(starts.size(), [&](size_t k) {
+            results[k] = reflow(k, starts[k], k + 1 < starts.size() ? starts[k + 1] : last);
+        });
+        return results;
+    }
+
+    /// Feeds the first codepoint of each of the line's cells into the collector, 0 for empty cells.
+    template <CellConcept Cell>
+    void collectTrigrams(Line<Cell> const& line, TrigramCollector& collector)
+    {
+        auto const collectCells = [&](InflatedLineBuffer<Cell> const& cells) {
+            for (Cell const& cell: cells)
+                collector.push(cell.codepointCount() ? cell.codepoint(0) : 0);
+        };
+
+        auto const collectText = [&](TrigramCollector& target, std::string_view text, ColumnCount used) {
+            for (char32_t const codepoint: unicode::convert_to<char32_t>(text))
+                target.push(codepoint);
+            if (used < line.size())
+                target.push(0);
+        };
+
+        if (line.isTrivialBuffer())
+        {
+            auto const& buffer = line.trivialBuffer();
+            if (buffer.isAscii())
+            {
+                collectText(collector, buffer.text.view(), buffer.usedColumns);
+                return;
+            }
+
+            // Trivial lines are searched for the UTF-8 text as a whole, but once inflated,
+            // cell by cell, so both sequences are indexed.
+            auto textCollector = collector;
+            collectText(textCollector, buffer.text.view(), buffer.usedColumns);
+            collectCells(inflate<Cell>(buffer));
+        }
+        else if (line.isFrozenBuffer())
+        {
+            auto const& buffer = line.frozenBuffer();
+            if (buffer.layout.empty())
+                collectText(collector, buffer.text, buffer.usedColumns());
+            else
+                collectCells(inflate<Cell>(buffer));
+        }
+        else
+            collectCells(line.inflatedBuffer());
+    }
+
 } // namespace detail
 // {{{ Grid impl
 template <CellConcept Cell>
@@ -123,10 +218,12 @@ template <CellConcept Cell>
 void Grid<Cell>::setMaxHistoryLineCount(MaxHistoryLineCount maxHistoryLineCount)
 {
     verifyState();
+    _recalledLines.clear();
     rezeroBuffers();
     _historyLimit = maxHistoryLineCount;
     _lines.resize(unbox<size_t>(_pageSize.lines + this->maxHistoryLineCount()));
     _linesUsed = min(_linesUsed, _pageSize.lines + this->maxHistoryLineCount());
+    _searchIndex.clear();
     verifyState();
 }
 
@@ -134,9 +231,186 @@ template <CellConcept Cell>
 void Grid<Cell>::clearHistory()
 {
     _linesUsed = _pageSize.lines;
+    if (_spillFile)
+        _spillFile->clear();
+    _recalledLines.clear();
+    _searchIndex.clear();
     verifyState();
 }
 
+template <CellConcept Cell>
+void Grid<Cell>::freezeHistory() noexcept
+{
+    // Only the thawed lines are stamped, so that the search index remains valid for all others.
+    for (auto offset = boxed_cast<LineOffset>(_hotHistoryLineCount + 1);
+         offset <= boxed_cast<LineOffset>(historyLineCount());
+         ++offset)
+        if (auto& line = _lines[unbox<long>(-offset)]; line.isInflatedBuffer())
+            markLineDirty(line).freeze();
+}
+
+template <CellConcept Cell>
+void Grid<Cell>::freezeColdLines(LineCount count) noexcept
+{
+    // Freezes the lines that just crossed the boundary from the hot into the cold history area.
+    auto const first = boxed_cast<LineOffset>(_hotHistoryLineCount + 1);
+    auto const last = boxed_cast<LineOffset>(std::min(_hotHistoryLineCount + count, historyLineCount()));
+    for (auto line = first; line <= last; ++line)
+        lineAt(-line).freeze();
+
+    // Re-freezes cold lines that have been thawed by accessing them, e.g. by viewing or searching them,
+    // sweeping through the cold history by a few lines per scrolled line.
+    auto const coldTop = -boxed_cast<LineOffset>(historyLineCount());
+    auto const coldBottom = -boxed_cast<LineOffset>(_hotHistoryLineCount + 1);
+    if (coldTop > coldBottom)
+        return;
+
+    auto const sweepCount = std::min(unbox(count) * ColdLineSweepRate, unbox(coldBottom - coldTop) + 1);
+    for (auto i = 0; i < sweepCount; ++i)
+    {
+        auto offset = lineOffsetOf(_coldLineSweepPosition);
+        if (offset < coldTop || offset > coldBottom)
+            offset = coldBottom;
+        if (auto& line = _lines[unbox<long>(offset)]; line.isInflatedBuffer())
+            markLineDirty(line).freeze();
+        _coldLineSweepPosition = absoluteLineNumber(offset) - 1;
+    }
+}
+
+template <CellConcept Cell>
+void Grid<Cell>::spillOldestLines(LineCount count)
+{
+    if (!_spillFile)
+        return;
+
+    // The oldest lines are the ones at the top of the history, about to be rotated out.
+    auto const top = -boxed_cast<LineOffset>(historyLineCount());
+    auto const bottom = top + boxed_cast<LineOffset>(std::min(count, _linesUsed));
+
+    // The recalled lines move up along with the lines spilled below them.
+    _recalledLinesSpillIndex += unbox<size_t>(bottom - top);
+    for (auto lineOffset = top; lineOffset < bottom; ++lineOffset)
+    {
+        auto& line = lineAt(lineOffset);
+        if (line.isFrozenBuffer())
+            _spillFile->append(line.flags(), line.frozenBuffer());
+        else if (auto const frozen = freeze<Cell>(line.inflatedBuffer()))
+            _spillFile->append(line.flags(), *frozen);
+        else // Lines with images cannot be spilled, so keep at least the line's position.
+            _spillFile->append(line.flags(), FrozenLineBuffer { .displayWidth = line.size() });
+    }
+}
+
+template <CellConcept Cell>
+Line<Cell> Grid<Cell>::spilledLineAt(size_t index) const
+{
+    auto const view = _spillFile->at(index);
+    return Line<Cell>(view.flags, view.toFrozenLineBuffer());
+}
+
+template <CellConcept Cell>
+void Grid<Cell>::recallSpilledLines(LineOffset top, LineCount count)
+{
+    // Spill indices of the range's lines above the history, from the most recent one upwards.
+    auto const historyTop = -boxed_cast<LineOffset>(historyLineCount());
+    auto const bottom = std::min(top + boxed_cast<LineOffset>(count), historyTop);
+    auto const first = unbox<long>(historyTop - bottom);
+    auto const last = std::min(unbox<long>(historyTop - top), unbox<long>(spilledLineCount()));
+    if (first >= last)
+    {
+        _recalledLines.clear();
+        return;
+    }
+
+    auto const firstIndex = static_cast<size_t>(first);
+    auto const lastIndex = static_cast<size_t>(last);
+    auto const recalledEnd = _recalledLinesSpillIndex + _recalledLines.size();
+    if (firstIndex == _recalledLinesSpillIndex && lastIndex == recalledEnd)
+        return;
+
+    // Keep the lines that have been recalled already, and only copy the others out of the file.
+    auto lines = std::vector<Line<Cell>> {};
+    lines.reserve(lastIndex - firstIndex);
+    for (auto index = firstIndex; index < lastIndex; ++index)
+    {
+        if (_recalledLinesSpillIndex <= index && index < recalledEnd)
+            lines.emplace_back(std::move(_recalledLines[index - _recalledLinesSpillIndex]));
+        else
+            markLineDirty(lines.emplace_back(spilledLineAt(index)));
+    }
+    _recalledLines = std::move(lines);
+    _recalledLinesSpillIndex = firstIndex;
+}
+
+template <CellConcept Cell>
+std::optional<CellLocation> Grid<Cell>::searchSpilledLinesReverse(std::u32string_view text,
+                                                                  CellLocation startPosition,
+                                                                  bool isCaseSensitive) const
+{
+    auto const needle = unicode::convert_to<char>(text);
+    auto const historyTop = -boxed_cast<LineOffset>(historyLineCount());
+    auto const lastColumn = ColumnOffset::cast_from(std::numeric_limits<int>::max());
+    auto column = startPosition.line < historyTop ? startPosition.column : lastColumn;
+    for (auto index = std::max(unbox<long>(historyTop - startPosition.line) - 1, 0L);
+         index < unbox<long>(spilledLineCount());
+         ++index)
+    {
+        if (auto const match =
+                _spillFile->at(static_cast<size_t>(index)).findReverse(needle, column, isCaseSensitive))
+            return CellLocation { .line = historyTop - 1 - LineOffset::cast_from(index), .column = *match };
+        column = lastColumn;
+    }
+    return std::nullopt;
+}
+
+template <CellConcept Cell>
+std::optional<CellLocation> Grid<Cell>::searchSpilledLines(std::u32string_view text,
+                                                           CellLocation startPosition,
+                                                           bool isCaseSensitive) const
+{
+    auto const needle = unicode::convert_to<char>(text);
+    auto const historyTop = -boxed_cast<LineOffset>(historyLineCount());
+    auto column = startPosition.column;
+    for (auto index = std::min(unbox<long>(historyTop - startPosition.line), unbox<long>(spilledLineCount()));
+         index > 0;
+         --index)
+    {
+        if (auto const match =
+                _spillFile->at(static_cast<size_t>(index - 1)).find(needle, column, isCaseSensitive))
+            return CellLocation { .line = historyTop - LineOffset::cast_from(index), .column = *match };
+        column = ColumnOffset(0);
+    }
+    return std::nullopt;
+}
+
+template <CellConcept Cell>
+size_t Grid<Cell>::historyBytesUsed() const noexcept
+{
+    auto bytes = size_t { 0 };
+    for (auto line = LineOffset(1); line <= boxed_cast<LineOffset>(historyLineCount()); ++line)
+        bytes += lineAt(-line).bytesUsed();
+    return bytes;
+}
+
+template <CellConcept Cell>
+size_t Grid<Cell>::compactText(crispy::buffer_fragment_compactor<char>& compactor)
+{
+    auto count = size_t { 0 };
+    auto const top = -boxed_cast<LineOffset>(historyLineCount());
+    auto const bottom = boxed_cast<LineOffset>(_pageSize.lines);
+    for (auto lineOffset = top; lineOffset < bottom; ++lineOffset)
+    {
+        // The line is only marked dirty if relocated, as cached render lines refer to its text.
+        auto& line = _lines[unbox<long>(lineOffset)];
+        if (line.isTrivialBuffer() && compactor.compact(line.trivialBuffer().text))
+        {
+            markLineDirty(line);
+            ++count;
+        }
+    }
+    return count;
+}
+
 template <CellConcept Cell>
 void Grid<Cell>::verifyState() const noexcept
 {
@@ -181,14 +455,25 @@ template <CellConcept Cell>
 Line<Cell>& Grid<Cell>::lineAt(LineOffset line) noexcept
 {
     // Require(*line < *_pageSize.lines);
-    return _lines[unbox<long>(line)];
+    if (auto* recalledLine = recalledLineAt(line))
+        return markLineDirty(*recalledLine);
+    return markLineDirty(_lines[unbox<long>(line)]);
 }
 
 template <CellConcept Cell>
 Line<Cell> const& Grid<Cell>::lineAt(LineOffset line) const noexcept
 {
     // Require(*line < *_pageSize.lines);
-    return const_cast<Grid&>(*this).lineAt(line);
+    if (auto const* recalledLine = recalledLineAt(line))
+        return *recalledLine;
+    return _lines[unbox<long>(line)];
+}
+
+template <CellConcept Cell>
+void Grid<Cell>::markAllLinesDirty() noexcept
+{
+    for (auto& line: _lines)
+        markLineDirty(line);
 }
 
 template <CellConcept Cell>
@@ -206,7 +491,8 @@ Cell& Grid<Cell>::useCellAt(LineOffset line, ColumnOffset column) noexcept
 template <CellConcept Cell>
 Cell const& Grid<Cell>::at(LineOffset line, ColumnOffset column) const noexcept
 {
-    return const_cast<Grid&>(*this).at(line, column);
+    // Inflating the line does not alter its contents, so it need not be marked dirty.
+    return const_cast<Line<Cell>&>(lineAt(line)).useCellAt(column);
 }
 
 template <CellConcept Cell>
@@ -218,6 +504,9 @@ gsl::span<Line<Cell>> Grid<Cell>::pageAtScrollOffset(ScrollOffset scrollOffset)
     Line<Cell>* startLine = &_lines[offset];
     auto const count = unbox<size_t>(_pageSize.lines);
 
+    for (auto i = 0; i < unbox<int>(_pageSize.lines); ++i)
+        markLineDirty(_lines[offset + i]);
+
     return gsl::span<Line<Cell>> { startLine, count };
 }
 
@@ -357,6 +646,119 @@ int Grid<Cell>::computeLogicalLineNumberFromBottom(LineCount n) const noexcept
     return outputRelativePhysicalLine;
 }
 // }}}
+// {{{ Grid impl: search
+template <CellConcept Cell>
+TrigramFilter const& Grid<Cell>::searchFilter(int64_t blockNumber)
+{
+    // The block's lines, preceded by the line above, which a wrapped first line continues.
+    auto const historyTop = absoluteLineNumber(-boxed_cast<LineOffset>(historyLineCount()));
+    auto const first = max(blockNumber * SearchIndex::BlockLineCount - 1, historyTop);
+    auto const last = (blockNumber + 1) * SearchIndex::BlockLineCount;
+    auto const lineAtNumber = [this](int64_t lineNumber) -> Line<Cell> const& {
+        return _lines[unbox<long>(lineOffsetOf(lineNumber))];
+    };
+
+    auto& block = _searchIndex.block(blockNumber);
+    if (block.built)
+    {
+        auto upToDate = true;
+        for (auto lineNumber = first; lineNumber < last && upToDate; ++lineNumber)
+            upToDate = lineAtNumber(lineNumber).dirtyGeneration() <= block.generation;
+        if (upToDate)
+            return block.filter;
+    }
+
+    block.filter = TrigramFilter {};
+    auto collector = TrigramCollector { block.filter };
+    for (auto lineNumber = first; lineNumber < last; ++lineNumber)
+    {
+        auto const& line = lineAtNumber(lineNumber);
+        if (!line.wrapped())
+            collector.reset();
+        detail::collectTrigrams(line, collector);
+    }
+    block.built = true;
+    block.generation = _generation;
+    return block.filter;
+}
+
+template <CellConcept Cell>
+SearchRange Grid<Cell>::nextSearchRange(std::u32string_view text, LineOffset from)
+{
+    auto const pageBottom = boxed_cast<LineOffset>(_pageSize.lines - 1);
+    if (text.size() < 3)
+        return SearchRange { .top = from, .bottom = pageBottom };
+
+    constexpr auto BlockLineCount = SearchIndex::BlockLineCount;
+    auto const historyTop = absoluteLineNumber(-boxed_cast<LineOffset>(historyLineCount()));
+    auto const indexEnd = searchIndexEnd();
+    _searchIndex.dropBlocksBefore(SearchIndex::blockNumber(historyTop));
+
+    auto lineNumber = absoluteLineNumber(from);
+    while (lineNumber < indexEnd)
+    {
+        // Extends the range over the following blocks as long as they continue its last logical line.
+        auto lastBlock = SearchIndex::blockNumber(lineNumber);
+        auto filter = searchFilter(lastBlock);
+        while (_lines[unbox<long>(lineOffsetOf((lastBlock + 1) * BlockLineCount))].wrapped())
+        {
+            if ((lastBlock + 1) * BlockLineCount == indexEnd)
+                return SearchRange { .top = lineOffsetOf(lineNumber), .bottom = pageBottom };
+            filter.merge(searchFilter(++lastBlock));
+        }
+
+        auto const bottom = (lastBlock + 1) * BlockLineCount - 1;
+        if (filter.mayContain(text))
+            return SearchRange { .top = lineOffsetOf(lineNumber), .bottom = lineOffsetOf(bottom) };
+        lineNumber = bottom + 1;
+    }
+
+    return SearchRange { .top = lineOffsetOf(lineNumber), .bottom = pageBottom };
+}
+
+template <CellConcept Cell>
+SearchRange Grid<Cell>::previousSearchRange(std::u32string_view text, LineOffset from)
+{
+    auto const historyTopOffset = -boxed_cast<LineOffset>(historyLineCount());
+    if (text.size() < 3)
+        return SearchRange { .top = historyTopOffset, .bottom = from };
+
+    constexpr auto BlockLineCount = SearchIndex::BlockLineCount;
+    auto const historyTop = absoluteLineNumber(historyTopOffset);
+    auto const indexEnd = searchIndexEnd();
+    _searchIndex.dropBlocksBefore(SearchIndex::blockNumber(historyTop));
+
+    auto const isContinued = [&](int64_t lineNumber) {
+        return lineNumber > historyTop && _lines[unbox<long>(lineOffsetOf(lineNumber))].wrapped();
+    };
+
+    auto lineNumber = absoluteLineNumber(from);
+    if (lineNumber >= indexEnd)
+    {
+        // The lines not covered by the index, up to the beginning of the logical line they start with.
+        auto top = max(indexEnd, historyTop);
+        while (isContinued(top))
+            --top;
+        return SearchRange { .top = lineOffsetOf(top), .bottom = from };
+    }
+
+    while (lineNumber >= historyTop)
+    {
+        // Extends the range over the preceding blocks as long as its first logical line began there.
+        auto firstBlock = SearchIndex::blockNumber(lineNumber);
+        auto filter = searchFilter(firstBlock);
+        while (isContinued(firstBlock * BlockLineCount))
+            filter.merge(searchFilter(--firstBlock));
+
+        auto const top = max(firstBlock * BlockLineCount, historyTop);
+        if (filter.mayContain(text))
+            return SearchRange { .top = lineOffsetOf(top), .bottom = lineOffsetOf(lineNumber) };
+        lineNumber = top - 1;
+    }
+
+    return SearchRange { .top = historyTopOffset, .bottom = historyTopOffset - 1 };
+}
+// }}}
 // {{{ Grid impl: scrolling
 template <CellConcept Cell>
 LineCount Grid<Cell>::scrollUp(LineCount linesCountToScrollUp, GraphicsAttributes defaultAttributes) noexcept
@@ -375,11 +777,14 @@ LineCount Grid<Cell>::scrollUp(LineCount linesCountToScrollUp, GraphicsAttribute
                                 TrivialLineBuffer { .displayWidth = _pageSize.columns,
                                                     .textAttributes = GraphicsAttributes() });
         }
+        // The new lines are inserted in between the existing ones, unless the ring is zero-based.
+        _searchIndex.clear();
         return scrollUp(linesCountToScrollUp, defaultAttributes);
     }
     if (unbox<size_t>(_linesUsed) == _lines.size()) // with all grid lines in-use
     {
         // TODO: ensure explicit test for this case
+        spillOldestLines(linesCountToScrollUp);
         rotateBuffersLeft(linesCountToScrollUp);
 
         // Initialize (/reset) new lines.
@@ -388,6 +793,7 @@ LineCount Grid<Cell>::scrollUp(LineCount linesCountToScrollUp, GraphicsAttribute
              ++y)
             lineAt(y).reset(defaultLineFlags(), defaultAttributes);
 
+        freezeColdLines(linesCountToScrollUp);
         return linesCountToScrollUp;
     }
     else
@@ -411,6 +817,7 @@ LineCount Grid<Cell>::scrollUp(LineCount linesCountToScrollUp, GraphicsAttribute
         if (linesAppendCount < linesCountToScrollUp)
         {
             auto const incrementCount = linesCountToScrollUp - linesAppendCount;
+            spillOldestLines(incrementCount);
             rotateBuffersLeft(incrementCount);
 
             // Initialize (/reset) new lines.
@@ -419,6 +826,7 @@ LineCount Grid<Cell>::scrollUp(LineCount linesCountToScrollUp, GraphicsAttribute
                  ++y)
                 lineAt(y).reset(defaultLineFlags(), defaultAttributes);
         }
+        freezeColdLines(linesCountToScrollUp);
         return LineCount::cast_from(linesAppendCount);
     }
 }
@@ -426,6 +834,7 @@ LineCount Grid<Cell>::scrollUp(LineCount linesCountToScrollUp, GraphicsAttribute
 template <CellConcept Cell>
 LineCount Grid<Cell>::scrollUp(LineCount n, GraphicsAttributes defaultAttributes, Margin margin) noexcept
 {
+    CRISPY_INSTRUMENT_STAGE(scroll_up, 0);
     verifyState();
     Require(0 <= *margin.horizontal.from && *margin.horizontal.to < *_pageSize.columns);
     Require(0 <= *margin.vertical.from && *margin.vertical.to < *_pageSize.lines);
@@ -459,7 +868,7 @@ LineCount Grid<Cell>::scrollUp(LineCount n, GraphicsAttributes defaultAttributes
         auto const bottomLineNumber = *margin.vertical.to;
         for (auto lineNumber = topEmptyLineNr; lineNumber <= bottomLineNumber; ++lineNumber)
         {
-            _lines[lineNumber].reset(defaultLineFlags(), defaultAttributes, _pageSize.columns);
+            markLineDirty(_lines[lineNumber]).reset(defaultLineFlags(), defaultAttributes, _pageSize.columns);
         }
     }
     else
@@ -526,7 +935,7 @@ void Grid<Cell>::scrollDown(LineCount vN, GraphicsAttributes const& defaultAttri
         rotateBuffersRight(n);
 
         for (Line<Cell>& line: mainPage().subspan(0, unbox<size_t>(n)))
-            line.reset(defaultLineFlags(), defaultAttributes);
+            markLineDirty(line).reset(defaultLineFlags(), defaultAttributes);
         return;
     }
 
@@ -538,7 +947,7 @@ void Grid<Cell>::scrollDown(LineCount vN, GraphicsAttributes const& defaultAttri
         auto c = std::next(begin(_lines), *margin.vertical.to + 1);
         std::rotate(a, b, c);
         for (auto const i: ranges::views::iota(*margin.vertical.from, *margin.vertical.from + *n))
-            _lines[i].reset(defaultLineFlags(), defaultAttributes);
+            markLineDirty(_lines[i]).reset(defaultLineFlags(), defaultAttributes);
     }
     else
     {
@@ -589,9 +998,14 @@ template <CellConcept Cell>
 void Grid<Cell>::reset()
 {
     _linesUsed = _pageSize.lines;
+    if (_spillFile)
+        _spillFile->clear();
+    _recalledLines.clear();
     _lines.rotate_right(_lines.zero_index());
+    _pageTopLineNumber = 0;
+    _searchIndex.clear();
     for (int i = 0; i < unbox(_pageSize.lines); ++i)
-        _lines[i].reset(defaultLineFlags(), GraphicsAttributes {});
+        markLineDirty(_lines[i]).reset(defaultLineFlags(), GraphicsAttributes {});
     verifyState();
 }
 
@@ -648,6 +1062,9 @@ CellLocation Grid<Cell>::resize(PageSize newSize, CellLocation currentCursorPos,
     if (_pageSize == newSize)
         return currentCursorPos;
 
+    // Recalled lines are not reflowed, but recalled again for the new page size when needed.
+    _recalledLines.clear();
+
     gridLog()("resize {} -> {} (cursor {})", _pageSize, newSize, currentCursorPos);
 
     // Growing in line count with scrollback lines present will move
@@ -729,64 +1146,110 @@ CellLocation Grid<Cell>::resize(PageSize newSize, CellLocation currentCursorPos,
             auto const extendCount = newColumnCount - _pageSize.columns;
             Require(*extendCount > 0);
 
-            Lines<Cell> grownLines;
-            LineBuffer
-                logicalLineBuffer; // Temporary state, representing wrapped columns from the line "below".
-            LineFlags logicalLineFlags = LineFlag::None;
+            // The chunks are reflowed in parallel, each beginning at a line that starts a logical line.
+            // Wrapped lines following a trivial line continue the last non-trivial logical line before them,
+            // which may be in a preceding chunk, so the chunks' initial flags are looked up beforehand.
+            auto const starts = detail::reflowChunkStarts(
+                -*historyLineCount(), *_pageSize.lines, [this](int i) { return !_lines[i].wrapped(); });
 
-            auto const appendToLogicalLine = [&logicalLineBuffer](gsl::span<Cell const> cells) {
-                for (auto const& cell: cells)
-                    logicalLineBuffer.push_back(cell);
+            auto initialLogicalLineFlags = std::vector<LineFlags>(starts.size(), LineFlag::None);
+            for (size_t k = 1; k < starts.size(); ++k)
+            {
+                initialLogicalLineFlags[k] = initialLogicalLineFlags[k - 1];
+                for (auto i = starts[k - 1]; i < starts[k]; ++i)
+                    if (!_lines[i].wrapped() && !_lines[i].isTrivialBuffer())
+                        initialLogicalLineFlags[k] = _lines[i].flags().without(LineFlag::Wrapped);
+            }
+
+            struct ReflowedChunk
+            {
+                Lines<Cell> lines;
+                LineBuffer logicalLineBuffer; // Wrapped columns of the chunk's last logical line.
+                LineFlags logicalLineFlags = LineFlag::None;
             };
 
-            auto const flushLogicalLine =
-                [newColumnCount, &grownLines, &logicalLineBuffer, &logicalLineFlags]() {
-                    if (!logicalLineBuffer.empty())
-                    {
-                        detail::addNewWrappedLines(
-                            grownLines, newColumnCount, std::move(logicalLineBuffer), logicalLineFlags, true);
-                        logicalLineBuffer.clear();
-                    }
-                };
+            auto const reflowChunk = [&](size_t chunk, int first, int last) -> ReflowedChunk {
+                auto result = ReflowedChunk { .logicalLineFlags = initialLogicalLineFlags[chunk] };
+                result.lines.reserve(static_cast<size_t>(last - first));
 
-            [[maybe_unused]] auto const logLogicalLine =
-                [&logicalLineBuffer]([[maybe_unused]] LineFlags lineFlags,
-                                     [[maybe_unused]] std::string_view msg) {
-                    gridLog()("{} |> \"{}\"", msg, Line<Cell>(lineFlags, logicalLineBuffer).toUtf8());
-                };
+                // Temporary state, representing wrapped columns from the line "below".
+                auto& logicalLineBuffer = result.logicalLineBuffer;
+                auto& logicalLineFlags = result.logicalLineFlags;
+                auto& grownLines = result.lines;
 
-            for (int i = -*historyLineCount(); i < *_pageSize.lines; ++i)
-            {
-                auto& line = _lines[i];
-                // logLogicalLine(line.flags(), std::format("Line[{:>2}]: next line: \"{}\"", i,
-                // line.toUtf8()));
-                Require(line.size() >= _pageSize.columns);
+                auto const appendToLogicalLine = [&logicalLineBuffer](gsl::span<Cell const> cells) {
+                    for (auto const& cell: cells)
+                        logicalLineBuffer.push_back(cell);
+                };
 
-                if (line.wrapped())
+                auto const flushLogicalLine =
+                    [newColumnCount, &grownLines, &logicalLineBuffer, &logicalLineFlags]() {
+                        if (!logicalLineBuffer.empty())
+                        {
+                            detail::addNewWrappedLines(grownLines,
+                                                       newColumnCount,
+                                                       std::move(logicalLineBuffer),
+                                                       logicalLineFlags,
+                                                       true);
+                            logicalLineBuffer.clear();
+                        }
+                    };
+
+                [[maybe_unused]] auto const logLogicalLine =
+                    [&logicalLineBuffer]([[maybe_unused]] LineFlags lineFlags,
+                                         [[maybe_unused]] std::string_view msg) {
+                        gridLog()("{} |> \"{}\"", msg, Line<Cell>(lineFlags, logicalLineBuffer).toUtf8());
+                    };
+
+                for (int i = first; i < last; ++i)
                 {
-                    // logLogicalLine(line.flags(), std::format(" - appending: \"{}\"",
-                    // line.toUtf8Trimmed()));
-                    appendToLogicalLine(line.trim_blank_right());
-                }
-                else // line is not wrapped
-                {
-                    flushLogicalLine();
-                    if (line.isTrivialBuffer())
+                    auto& line = _lines[i];
+                    // logLogicalLine(line.flags(), std::format("Line[{:>2}]: next line: \"{}\"", i,
+                    // line.toUtf8()));
+                    Require(line.size() >= _pageSize.columns);
+
+                    if (line.wrapped())
                     {
-                        auto& buffer = line.trivialBuffer();
-                        buffer.displayWidth = newColumnCount;
-                        grownLines.emplace_back(line);
+                        // logLogicalLine(line.flags(), std::format(" - appending: \"{}\"",
+                        // line.toUtf8Trimmed()));
+                        appendToLogicalLine(line.trim_blank_right());
                     }
-                    else
+                    else // line is not wrapped
                     {
-                        // logLogicalLine(line.flags(), " - start new logical line");
-                        appendToLogicalLine(line.cells());
-                        logicalLineFlags = line.flags().without(LineFlag::Wrapped);
+                        flushLogicalLine();
+                        if (line.isTrivialBuffer())
+                        {
+                            auto& buffer = line.trivialBuffer();
+                            buffer.displayWidth = newColumnCount;
+                            grownLines.emplace_back(line);
+                        }
+                        else
+                        {
+                            // logLogicalLine(line.flags(), " - start new logical line");
+                            appendToLogicalLine(line.cells());
+                            logicalLineFlags = line.flags().without(LineFlag::Wrapped);
+                        }
                     }
                 }
-            }
 
-            flushLogicalLine(); // Flush last (bottom) line, if anything pending.
+                return result;
+            };
+
+            // Stitch the chunks together, flushing the logical line pending at the end of each chunk,
+            // including the last (bottom) one.
+            Lines<Cell> grownLines;
+            grownLines.reserve(unbox<size_t>(_pageSize.lines + maxHistoryLineCount()));
+            for (auto& chunk: detail::reflowChunks<ReflowedChunk>(starts, *_pageSize.lines, reflowChunk))
+            {
+                for (auto& line: chunk.lines)
+                    grownLines.emplace_back(std::move(line));
+                if (!chunk.logicalLineBuffer.empty())
+                    detail::addNewWrappedLines(grownLines,
+                                               newColumnCount,
+                                               std::move(chunk.logicalLineBuffer),
+                                               chunk.logicalLineFlags,
+                                               true);
+            }
 
             // auto diff = int(_lines.size()) - unbox<int>(_pageSize.lines);
             auto cy = LineCount(0);
@@ -867,52 +1330,87 @@ CellLocation Grid<Cell>::resize(PageSize newSize, CellLocation currentCursorPos,
             // "e "     Wrapped
             // }}}
 
-            Lines<Cell> shrinkedLines;
-            LineBuffer wrappedColumns;
-            LineFlags previousFlags = _lines.front().inheritableFlags();
-
             auto const totalLineCount = unbox<size_t>(_pageSize.lines + maxHistoryLineCount());
-            shrinkedLines.reserve(totalLineCount);
             Require(totalLineCount == unbox<size_t>(this->totalLineCount()));
 
-            auto numLinesWritten = LineCount(0);
-            for (auto i = -*historyLineCount(); i < *_pageSize.lines; ++i)
+            // The chunks are reflowed in parallel, each beginning at a wrappable line that starts
+            // a logical line. Such a line is reflowed the same regardless of any columns carried over
+            // from the line above it, as those are inserted as new lines before it.
+            auto const starts =
+                detail::reflowChunkStarts(-*historyLineCount(), *_pageSize.lines, [this](int i) {
+                    return !_lines[i].wrapped() && _lines[i].wrappable();
+                });
+
+            struct ReflowedChunk
             {
-                auto& line = _lines[i];
+                Lines<Cell> lines;
+                LineBuffer wrappedColumns; // Columns carried over into the line following the chunk.
+                LineFlags previousFlags = LineFlag::None;
+            };
+
+            auto const initialFlags = _lines.front().inheritableFlags();
+            auto const reflowChunk = [&](size_t /*chunk*/, int first, int last) -> ReflowedChunk {
+                auto result = ReflowedChunk { .previousFlags = initialFlags };
+                result.lines.reserve(static_cast<size_t>(last - first));
 
-                // do we have previous columns carried?
-                if (!wrappedColumns.empty())
+                auto& shrinkedLines = result.lines;
+                auto& wrappedColumns = result.wrappedColumns;
+                auto& previousFlags = result.previousFlags;
+
+                for (auto i = first; i < last; ++i)
                 {
-                    if (line.wrapped() && line.inheritableFlags() == previousFlags)
+                    auto& line = _lines[i];
+
+                    // do we have previous columns carried?
+                    if (!wrappedColumns.empty())
                     {
-                        // Prepend previously wrapped columns into current line.
-                        auto& editable = line.inflatedBuffer();
-                        editable.insert(editable.begin(), wrappedColumns.begin(), wrappedColumns.end());
+                        if (line.wrapped() && line.inheritableFlags() == previousFlags)
+                        {
+                            // Prepend previously wrapped columns into current line.
+                            auto& editable = line.inflatedBuffer();
+                            editable.insert(editable.begin(), wrappedColumns.begin(), wrappedColumns.end());
+                        }
+                        else
+                        {
+                            // Insert NEW line(s) between previous and this line with previously wrapped
+                            // columns.
+                            detail::addNewWrappedLines(shrinkedLines,
+                                                       newColumnCount,
+                                                       std::move(wrappedColumns),
+                                                       previousFlags,
+                                                       false);
+                            previousFlags = line.inheritableFlags();
+                        }
                     }
                     else
                     {
-                        // Insert NEW line(s) between previous and this line with previously wrapped columns.
-                        auto const numLinesInserted = detail::addNewWrappedLines(
-                            shrinkedLines, newColumnCount, std::move(wrappedColumns), previousFlags, false);
-                        numLinesWritten += numLinesInserted;
+                        line.setWrappable(true);
                         previousFlags = line.inheritableFlags();
                     }
-                }
-                else
-                {
-                    line.setWrappable(true);
-                    previousFlags = line.inheritableFlags();
+
+                    wrappedColumns = line.reflow(newColumnCount);
+
+                    shrinkedLines.emplace_back(std::move(line));
+                    Ensures(shrinkedLines.back().size() >= newColumnCount);
                 }
 
-                wrappedColumns = line.reflow(newColumnCount);
+                return result;
+            };
 
-                shrinkedLines.emplace_back(std::move(line));
-                numLinesWritten++;
-                Ensures(shrinkedLines.back().size() >= newColumnCount);
+            // Stitch the chunks together, inserting the columns carried over from each chunk as new lines.
+            Lines<Cell> shrinkedLines;
+            shrinkedLines.reserve(totalLineCount);
+            for (auto& chunk: detail::reflowChunks<ReflowedChunk>(starts, *_pageSize.lines, reflowChunk))
+            {
+                for (auto& line: chunk.lines)
+                    shrinkedLines.emplace_back(std::move(line));
+                detail::addNewWrappedLines(shrinkedLines,
+                                           newColumnCount,
+                                           std::move(chunk.wrappedColumns),
+                                           chunk.previousFlags,
+                                           false);
             }
-            numLinesWritten += detail::addNewWrappedLines(
-                shrinkedLines, newColumnCount, std::move(wrappedColumns), previousFlags, false);
-            Require(unbox<size_t>(numLinesWritten) == shrinkedLines.size());
+            auto const numLinesWritten = LineCount::cast_from(shrinkedLines.size());
             Require(numLinesWritten >= _pageSize.lines);
 
             while (shrinkedLines.size() < totalLineCount)
@@ -963,6 +1461,10 @@ CellLocation Grid<Cell>::resize(PageSize newSize, CellLocation currentCursorPos,
     Ensures(_pageSize == newSize);
     verifyState();
 
+    // Lines may have been copied or rewrapped, so their generations are not unique anymore.
+    markAllLinesDirty();
+    _searchIndex.clear();
+
     return cursor;
 }
 
@@ -986,7 +1488,7 @@ void Grid<Cell>::appendNewLines(LineCount count, GraphicsAttributes attr)
         {
             auto line = std::move(_lines.front());
             _lines.pop_front();
-            line.reset(defaultLineFlags(), attr);
+            markLineDirty(line).reset(defaultLineFlags(), attr);
             _lines.emplace_back(std::move(line));
         }
         return;
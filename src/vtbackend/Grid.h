@@ -3,15 +3,19 @@
 
 #include <vtbackend/GraphicsAttributes.h>
 #include <vtbackend/Line.h>
+#include <vtbackend/ScrollbackFile.h>
+#include <vtbackend/SearchIndex.h>
 #include <vtbackend/cell/CellConcept.h>
 #include <vtbackend/primitives.h>
 
 #include <crispy/algorithm.h>
+#include <crispy/BufferObject.h>
 #include <crispy/assert.h>
 #include <crispy/defines.h>
 #include <crispy/ring.h>
 
 #include <libunicode/convert.h>
+#include <libunicode/width.h>
 
 #include <range/v3/algorithm/copy.hpp>
 #include <range/v3/iterator/insert_iterators.hpp>
@@ -21,8 +25,11 @@
 #include <gsl/span_ext>
 
 #include <algorithm>
+#include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 
 namespace vtbackend
 {
@@ -109,6 +116,15 @@ struct RenderPassHints
     bool containsBlinkingCells = false;
 };
 
+/// Inclusive range of lines to be searched, being empty once bottom is above top.
+struct SearchRange
+{
+    LineOffset top {};
+    LineOffset bottom {};
+
+    [[nodiscard]] bool empty() const noexcept { return bottom < top; }
+};
+
 /**
  * Represents a logical grid line, i.e. a sequence lines that were written without
  * an explicit linefeed, triggering an auto-wrap.
@@ -598,6 +614,8 @@ class Grid
 {
     // TODO: Rename all "History" to "Scrollback"?
   public:
+    static constexpr LineCount DefaultHotHistoryLineCount = LineCount(1000);
+
     Grid(PageSize pageSize, bool reflowOnResize, MaxHistoryLineCount maxHistoryLineCount);
 
     Grid(): Grid(PageSize { LineCount(25), ColumnCount(80) }, false, LineCount(0)) {}
@@ -622,6 +640,66 @@ class Grid
 
     [[nodiscard]] LineCount historyLineCount() const noexcept { return _linesUsed - _pageSize.lines; }
 
+    /// Number of most recent history lines that are kept in their editable (hot) form.
+    ///
+    /// History lines beyond that are frozen into a compact, read-only representation
+    /// as they scroll out of the hot area, and thawed on demand when accessed.
+    [[nodiscard]] LineCount hotHistoryLineCount() const noexcept { return _hotHistoryLineCount; }
+    void setHotHistoryLineCount(LineCount count) noexcept { _hotHistoryLineCount = count; }
+
+    /// Freezes all cold history lines that have been thawed, e.g. by searching or viewing them.
+    ///
+    /// Scrolling re-freezes such lines incrementally as well.
+    void freezeHistory() noexcept;
+
+    /// Approximates the number of bytes occupied by the history lines.
+    [[nodiscard]] size_t historyBytesUsed() const noexcept;
+
+    /// Relocates the text of trivial lines out of sparsely referenced PTY buffer objects,
+    /// so that those can be released.
+    ///
+    /// @returns the number of lines whose text has been relocated.
+    size_t compactText(crispy::buffer_fragment_compactor<char>& compactor);
+
+    /// Attaches a file that lines falling off the top of the history are spilled into.
+    void setSpillFile(std::unique_ptr<ScrollbackFile> file) noexcept
+    {
+        _spillFile = std::move(file);
+        _recalledLines.clear();
+    }
+    [[nodiscard]] ScrollbackFile const* spillFile() const noexcept { return _spillFile.get(); }
+
+    /// Number of lines that have been spilled into the spill file, if any.
+    [[nodiscard]] LineCount spilledLineCount() const noexcept
+    {
+        return _spillFile ? LineCount::cast_from(_spillFile->size()) : LineCount(0);
+    }
+
+    /// Retrieves a copy of a spilled line, with index 0 being the most recently spilled one,
+    /// i.e. the one right above the top-most history line.
+    [[nodiscard]] Line<Cell> spilledLineAt(size_t index) const;
+
+    /// Loads the spilled lines within the given range of lines, so that these can be accessed
+    /// like any other line, and releases the ones loaded before that are outside of the range.
+    ///
+    /// Spilled lines continue the line offsets of the history upwards, i.e. the most recently
+    /// spilled line is located at line offset -historyLineCount() - 1.
+    void recallSpilledLines(LineOffset top, LineCount count);
+
+    /// Searches the spilled lines in place, from the given position towards older lines.
+    ///
+    /// Matches spanning multiple lines are not found.
+    [[nodiscard]] std::optional<CellLocation> searchSpilledLinesReverse(std::u32string_view text,
+                                                                        CellLocation startPosition,
+                                                                        bool isCaseSensitive) const;
+
+    /// Searches the spilled lines in place, from the given position towards more recent lines.
+    ///
+    /// Matches spanning multiple lines are not found.
+    [[nodiscard]] std::optional<CellLocation> searchSpilledLines(std::u32string_view text,
+                                                                 CellLocation startPosition,
+                                                                 bool isCaseSensitive) const;
+
     [[nodiscard]] bool reflowOnResize() const noexcept { return _reflowOnResize; }
     void setReflowOnResize(bool enabled) { _reflowOnResize = enabled; }
 
@@ -639,9 +717,25 @@ class Grid
 
     // {{{ Line API
     /// @returns reference to Line at given relative offset @p line.
+    ///
+    /// The mutable overload marks the line dirty, as the caller is assumed to modify it.
     [[nodiscard]] Line<Cell>& lineAt(LineOffset line) noexcept;
     [[nodiscard]] Line<Cell> const& lineAt(LineOffset line) const noexcept;
 
+    /// Stamps the given line of this grid with a new generation number,
+    /// marking it as modified since the last time it has been rendered.
+    Line<Cell>& markLineDirty(Line<Cell>& line) noexcept
+    {
+        line.markDirty(++_generation);
+        return line;
+    }
+
+    /// Stamps all lines, including the history, with new generation numbers.
+    void markAllLinesDirty() noexcept;
+
+    /// Most recently handed out line generation number.
+    [[nodiscard]] uint64_t generation() const noexcept { return _generation; }
+
     [[nodiscard]] gsl::span<Cell const> lineBuffer(LineOffset line) const noexcept
     {
         return lineAt(line).cells();
@@ -701,6 +795,30 @@ class Grid
         return ReverseLogicalLines<Cell> { boxed_cast<LineOffset>(-historyLineCount()), offset, _lines };
     }
 
+    [[nodiscard]] LogicalLines<Cell> logicalLines(SearchRange range)
+    {
+        return LogicalLines<Cell> { range.top, range.bottom, _lines };
+    }
+
+    [[nodiscard]] ReverseLogicalLines<Cell> logicalLinesReverse(SearchRange range)
+    {
+        return ReverseLogicalLines<Cell> { range.top, range.bottom, _lines };
+    }
+
+    /// Returns the lines to search forward through next for the given text, starting at line @p from,
+    /// skipping the history lines that are known not to contain the text.
+    ///
+    /// The returned range starts at @p from, unless lines have been skipped,
+    /// and ends at the bottom of a logical line.
+    [[nodiscard]] SearchRange nextSearchRange(std::u32string_view text, LineOffset from);
+
+    /// Returns the lines to search backward through next for the given text, starting at line @p from,
+    /// skipping the history lines that are known not to contain the text.
+    ///
+    /// The returned range ends at @p from, unless lines have been skipped,
+    /// starts at the top of a logical line, and is empty once there is nothing left to search.
+    [[nodiscard]] SearchRange previousSearchRange(std::u32string_view text, LineOffset from);
+
     // {{{ buffer manipulation
 
     /// Completely deletes all scrollback lines.
@@ -806,6 +924,25 @@ class Grid
     CellLocation growLines(LineCount newHeight, CellLocation cursor);
     void appendNewLines(LineCount count, GraphicsAttributes attr);
     void clampHistory();
+    void freezeColdLines(LineCount count) noexcept;
+    void spillOldestLines(LineCount count);
+
+    /// Returns the recalled spilled line at the given offset above the history, if loaded.
+    [[nodiscard]] Line<Cell> const* recalledLineAt(LineOffset line) const noexcept
+    {
+        if (_recalledLines.empty())
+            return nullptr;
+        auto const spillIndex = -unbox<long>(line) - unbox<long>(historyLineCount()) - 1
+                                - static_cast<long>(_recalledLinesSpillIndex);
+        if (spillIndex < 0 || spillIndex >= static_cast<long>(_recalledLines.size()))
+            return nullptr;
+        return &_recalledLines[static_cast<size_t>(spillIndex)];
+    }
+
+    [[nodiscard]] Line<Cell>* recalledLineAt(LineOffset line) noexcept
+    {
+        return const_cast<Line<Cell>*>(std::as_const(*this).recalledLineAt(line));
+    }
 
     // {{{ buffer helpers
     void resizeBuffers(PageSize newSize)
@@ -819,9 +956,42 @@ class Grid
 
     void rotateBuffers(int offset) noexcept { _lines.rotate(offset); }
 
-    void rotateBuffersLeft(LineCount count) noexcept { _lines.rotate_left(unbox<size_t>(count)); }
+    void rotateBuffersLeft(LineCount count) noexcept
+    {
+        _lines.rotate_left(unbox<size_t>(count));
+        _pageTopLineNumber += unbox<int64_t>(count);
+    }
+
+    void rotateBuffersRight(LineCount count) noexcept
+    {
+        _lines.rotate_right(unbox<size_t>(count));
+        _pageTopLineNumber -= unbox<int64_t>(count);
+
+        // The page's bottom lines wrap around to the top of the history without being modified,
+        // so the generation numbers cannot tell that the indexed lines have been replaced.
+        _searchIndex.clear();
+    }
+    // }}}
+
+    // {{{ search index helpers
+    [[nodiscard]] int64_t absoluteLineNumber(LineOffset offset) const noexcept
+    {
+        return _pageTopLineNumber + unbox<int64_t>(offset);
+    }
 
-    void rotateBuffersRight(LineCount count) noexcept { _lines.rotate_right(unbox<size_t>(count)); }
+    [[nodiscard]] LineOffset lineOffsetOf(int64_t lineNumber) const noexcept
+    {
+        return LineOffset::cast_from(lineNumber - _pageTopLineNumber);
+    }
+
+    /// Absolute number of the first line not covered by the search index,
+    /// i.e. the first line of the block containing the top page line.
+    [[nodiscard]] int64_t searchIndexEnd() const noexcept
+    {
+        return SearchIndex::blockNumber(_pageTopLineNumber) * SearchIndex::BlockLineCount;
+    }
+
+    TrigramFilter const& searchFilter(int64_t blockNumber);
     // }}}
 
     // private fields
@@ -837,6 +1007,29 @@ class Grid
 
     // Number of lines used in the Lines buffer.
     LineCount _linesUsed;
+
+    LineCount _hotHistoryLineCount = DefaultHotHistoryLineCount;
+
+    // Number of cold lines checked for being thawed, per line scrolled into the history.
+    static constexpr int ColdLineSweepRate = 8;
+
+    // Absolute number of the next cold line to be checked for being thawed (see freezeColdLines()).
+    int64_t _coldLineSweepPosition = 0;
+
+    std::unique_ptr<ScrollbackFile> _spillFile;
+
+    // Spilled lines currently being accessed, e.g. for being displayed,
+    // starting with the one of spill index _recalledLinesSpillIndex and going upwards.
+    std::vector<Line<Cell>> _recalledLines;
+    size_t _recalledLinesSpillIndex = 0;
+
+    // Last generation number a line has been stamped with (see markLineDirty()).
+    uint64_t _generation = 0;
+
+    // Absolute number of the top page line, increasing as lines scroll into the history.
+    int64_t _pageTopLineNumber = 0;
+
+    SearchIndex _searchIndex;
 };
 
 template <CellConcept Cell>
@@ -872,14 +1065,21 @@ template <typename RendererT>
     ScrollOffset scrollOffset,
     HighlightSearchMatches highlightSearchMatches) const
 {
-    assert(!scrollOffset || unbox<LineCount>(scrollOffset) <= historyLineCount());
+    assert(!scrollOffset || unbox<LineCount>(scrollOffset) <= historyLineCount() + spilledLineCount());
 
     auto y = LineOffset(0);
     auto hints = RenderPassHints {};
     for (int i = -*scrollOffset, e = i + *_pageSize.lines; i != e; ++i, ++y)
     {
         auto x = ColumnOffset(0);
-        Line<Cell> const& line = _lines[i];
+        auto const* recalledLine = recalledLineAt(LineOffset(i));
+        Line<Cell> const& line = recalledLine ? *recalledLine : _lines[i];
+        if constexpr (requires { render.tryReuseLine(line, y, hints); })
+        {
+            // Lines that have not been modified since the previous frame need not be rebuilt.
+            if (render.tryReuseLine(line, y, hints))
+                continue;
+        }
         // NB: trivial liner rendering only works trivially if we don't do cell-based operations
         // on the text. Therefore, we only move to the trivial fast path here if we don't want to
         // highlight search matches.
@@ -892,13 +1092,41 @@ template <typename RendererT>
         }
         else
         {
-            render.startLine(y);
-            for (Cell const& cell: line.cells())
-            {
+            auto const renderCell = [&](Cell const& cell) {
                 hints.containsBlinkingCells = hints.containsBlinkingCells
                                               || (cell.flags() & CellFlag::Blinking)
                                               || (cell.flags() & CellFlag::RapidBlinking);
                 render.renderCell(cell, y, x++);
+            };
+
+            render.startLine(y);
+            if (line.isTrivialBuffer() && line.trivialBuffer().isAscii())
+            {
+                // Do not inflate trivial lines just for rendering them cell-wise,
+                // but synthesize their cells one by one, so the line stays in its compact form.
+                auto const& buffer = line.trivialBuffer();
+                auto textCell = Cell { buffer.textAttributes, buffer.hyperlink };
+                for (char const ch: buffer.text.view())
+                {
+                    textCell.writeTextOnly(static_cast<char32_t>(ch),
+                                           static_cast<uint8_t>(unicode::width(static_cast<char32_t>(ch))));
+                    renderCell(textCell);
+                }
+                auto const fillCell = Cell { buffer.fillAttributes };
+                while (x < boxed_cast<ColumnOffset>(buffer.displayWidth))
+                    renderCell(fillCell);
+            }
+            else if (line.isTrivialBuffer())
+            {
+                // Non-ASCII text, with its wide characters and grapheme clusters, is rare enough
+                // to go the long way.
+                for (Cell const& cell: inflate<Cell>(line.trivialBuffer()))
+                    renderCell(cell);
+            }
+            else
+            {
+                for (Cell const& cell: line.cells())
+                    renderCell(cell);
             }
             render.endLine();
         }
@@ -173,6 +173,215 @@ TEST_CASE("Grid.writeAndScrollUp", "[grid]")
     CHECK(grid.lineText(LineOffset(1)) == "     ");
 }
 
+TEST_CASE("Grid.scrollUp.freezeColdHistory", "[grid]")
+{
+    auto grid = Grid<Cell>(PageSize { LineCount(2), ColumnCount(5) }, true, LineCount(4));
+    grid.setHotHistoryLineCount(LineCount(1));
+    grid.setLineText(LineOffset(0), "ABCDE");
+    grid.setLineText(LineOffset(1), "abcde");
+
+    grid.scrollUp(LineCount(1));
+    CHECK(grid.lineAt(LineOffset(-1)).isInflatedBuffer());
+
+    grid.setLineText(LineOffset(1), "12345");
+    grid.scrollUp(LineCount(2));
+    REQUIRE(grid.historyLineCount() == LineCount(3));
+    CHECK(grid.lineAt(LineOffset(-3)).isFrozenBuffer());
+    CHECK(grid.lineAt(LineOffset(-2)).isFrozenBuffer());
+    CHECK(grid.lineAt(LineOffset(-1)).isInflatedBuffer());
+
+    // Accessing the cells of a frozen line thaws it transparently.
+    CHECK(grid.lineText(LineOffset(-3)) == "ABCDE");
+    CHECK(grid.lineText(LineOffset(-2)) == "abcde");
+    CHECK(grid.lineText(LineOffset(-1)) == "12345");
+    CHECK(grid.lineAt(LineOffset(-3)).isInflatedBuffer());
+
+    grid.freezeHistory();
+    CHECK(grid.lineAt(LineOffset(-3)).isFrozenBuffer());
+    CHECK(grid.lineAt(LineOffset(-2)).isFrozenBuffer());
+    CHECK(grid.lineAt(LineOffset(-1)).isInflatedBuffer());
+    CHECK(grid.lineText(LineOffset(-3)) == "ABCDE");
+
+    // Scrolling re-freezes thawed cold lines as well.
+    CHECK(grid.lineText(LineOffset(-2)) == "abcde");
+    REQUIRE(grid.lineAt(LineOffset(-2)).isInflatedBuffer());
+    grid.scrollUp(LineCount(1));
+    REQUIRE(grid.historyLineCount() == LineCount(4));
+    CHECK(grid.lineAt(LineOffset(-4)).isFrozenBuffer());
+    CHECK(grid.lineAt(LineOffset(-3)).isFrozenBuffer());
+    CHECK(grid.lineAt(LineOffset(-2)).isFrozenBuffer());
+    CHECK(grid.lineText(LineOffset(-3)) == "abcde");
+}
+
+TEST_CASE("Grid.scrollUp.spillFile", "[grid]")
+{
+    auto grid = Grid<Cell>(PageSize { LineCount(2), ColumnCount(5) }, false, LineCount(1));
+    grid.setSpillFile(ScrollbackFile::create(4096));
+    if (!grid.spillFile())
+    {
+        WARN("Spilling history lines is not supported on this platform.");
+        return;
+    }
+
+    grid.setLineText(LineOffset(0), "AAAAA");
+    grid.setLineText(LineOffset(1), "BBBBB");
+    grid.scrollUp(LineCount(1));
+    CHECK(grid.spilledLineCount() == LineCount(0));
+
+    grid.setLineText(LineOffset(1), "CCCCC");
+    grid.scrollUp(LineCount(1));
+    grid.setLineText(LineOffset(1), "DDDDD");
+    grid.scrollUp(LineCount(1));
+
+    REQUIRE(grid.historyLineCount() == LineCount(1));
+    CHECK(grid.lineText(LineOffset(-1)) == "CCCCC");
+    REQUIRE(grid.spilledLineCount() == LineCount(2));
+    CHECK(grid.spilledLineAt(0).toUtf8() == "BBBBB");
+    CHECK(grid.spilledLineAt(1).toUtf8() == "AAAAA");
+
+    grid.clearHistory();
+    CHECK(grid.spilledLineCount() == LineCount(0));
+}
+
+TEST_CASE("Grid.recallSpilledLines", "[grid]")
+{
+    auto grid = Grid<Cell>(PageSize { LineCount(2), ColumnCount(5) }, false, LineCount(1));
+    grid.setSpillFile(ScrollbackFile::create(4096));
+    if (!grid.spillFile())
+    {
+        WARN("Spilling history lines is not supported on this platform.");
+        return;
+    }
+
+    grid.setLineText(LineOffset(0), "AAAAA");
+    grid.setLineText(LineOffset(1), "BBBBB");
+    grid.scrollUp(LineCount(1));
+    grid.setLineText(LineOffset(1), "CCCCC");
+    grid.scrollUp(LineCount(1));
+    grid.setLineText(LineOffset(1), "DDDDD");
+    grid.scrollUp(LineCount(1));
+    REQUIRE(grid.spilledLineCount() == LineCount(2));
+
+    // The spilled lines continue above the history, without growing it.
+    grid.recallSpilledLines(LineOffset(-3), LineCount(2));
+    CHECK(grid.historyLineCount() == LineCount(1));
+    CHECK(grid.lineText(LineOffset(-1)) == "CCCCC");
+    CHECK(grid.lineText(LineOffset(-2)) == "BBBBB");
+    CHECK(grid.lineText(LineOffset(-3)) == "AAAAA");
+
+    // Recalled lines move up as more lines are spilled.
+    grid.setLineText(LineOffset(1), "EEEEE");
+    grid.scrollUp(LineCount(1));
+    CHECK(grid.lineText(LineOffset(-3)) == "BBBBB");
+    CHECK(grid.lineText(LineOffset(-4)) == "AAAAA");
+
+    grid.recallSpilledLines(LineOffset(-4), LineCount(3));
+    CHECK(grid.lineText(LineOffset(-2)) == "CCCCC");
+
+    SECTION("search")
+    {
+        auto const match = grid.searchSpilledLinesReverse(
+            U"AAA", CellLocation { .line = LineOffset(-2), .column = ColumnOffset(4) }, true);
+        REQUIRE(match.has_value());
+        CHECK(*match == CellLocation { .line = LineOffset(-4), .column = ColumnOffset(2) });
+
+        auto const nextMatch = grid.searchSpilledLines(
+            U"bb", CellLocation { .line = LineOffset(-4), .column = ColumnOffset(1) }, false);
+        REQUIRE(nextMatch.has_value());
+        CHECK(*nextMatch == CellLocation { .line = LineOffset(-3), .column = ColumnOffset(0) });
+
+        CHECK(!grid.searchSpilledLines(
+                   U"EEE", CellLocation { .line = LineOffset(-4), .column = ColumnOffset(0) }, true)
+                   .has_value());
+    }
+}
+
+TEST_CASE("Grid.scrollUp.spillFile.wrapAround", "[grid]")
+{
+    auto grid = Grid<Cell>(PageSize { LineCount(1), ColumnCount(5) }, false, LineCount(0));
+    grid.setSpillFile(ScrollbackFile::create(256));
+    if (!grid.spillFile())
+    {
+        WARN("Spilling history lines is not supported on this platform.");
+        return;
+    }
+
+    auto constexpr LineCountWritten = 20;
+    for (int i = 0; i < LineCountWritten; ++i)
+    {
+        grid.setLineText(LineOffset(0), std::format("{:05}", i));
+        grid.scrollUp(LineCount(1));
+    }
+
+    // The oldest lines have been dropped, but the most recent ones are still available.
+    auto const spilledLineCount = unbox<int>(grid.spilledLineCount());
+    REQUIRE(0 < spilledLineCount);
+    REQUIRE(spilledLineCount < LineCountWritten);
+    for (int i = 0; i < spilledLineCount; ++i)
+        CHECK(grid.spilledLineAt(static_cast<size_t>(i)).toUtf8()
+              == std::format("{:05}", LineCountWritten - 1 - i));
+}
+
+TEST_CASE("Grid.scrollUp.spillFile.wrapAround.varyingLineLength", "[grid]")
+{
+    auto grid = Grid<Cell>(PageSize { LineCount(1), ColumnCount(40) }, false, LineCount(0));
+    grid.setSpillFile(ScrollbackFile::create(1024));
+    if (!grid.spillFile())
+    {
+        WARN("Spilling history lines is not supported on this platform.");
+        return;
+    }
+
+    // Records of different sizes leave unused gaps of different sizes when the file wraps around.
+    auto const lineText = [](int i) {
+        return std::format("{:04}", i) + std::string(static_cast<size_t>((i * 7) % 37), 'x');
+    };
+
+    auto constexpr LineCountWritten = 200;
+    for (int i = 0; i < LineCountWritten; ++i)
+    {
+        grid.setLineText(LineOffset(0), lineText(i));
+        grid.scrollUp(LineCount(1));
+
+        auto const spilledLineCount = unbox<int>(grid.spilledLineCount());
+        REQUIRE(0 < spilledLineCount);
+        for (int k = 0; k < spilledLineCount; ++k)
+            REQUIRE(grid.spilledLineAt(static_cast<size_t>(k)).toUtf8Trimmed() == lineText(i - k));
+    }
+
+    CHECK(unbox<int>(grid.spilledLineCount()) < LineCountWritten);
+}
+
+TEST_CASE("Grid.markLineDirty", "[grid]")
+{
+    auto grid = Grid<Cell>(PageSize { LineCount(3), ColumnCount(5) }, true, LineCount(4));
+    auto const& constGrid = grid;
+    grid.setLineText(LineOffset(0), "ABCDE");
+    grid.setLineText(LineOffset(1), "abcde");
+    grid.setLineText(LineOffset(2), "12345");
+
+    auto const generation0 = constGrid.lineAt(LineOffset(0)).dirtyGeneration();
+    auto const generation1 = constGrid.lineAt(LineOffset(1)).dirtyGeneration();
+    CHECK(generation0 != 0);
+    CHECK(generation0 != generation1);
+
+    // Read-only access does not mark lines dirty.
+    CHECK(constGrid.lineText(LineOffset(1)) == "abcde");
+    CHECK(constGrid.at(LineOffset(1), ColumnOffset(0)).toUtf8() == "a");
+    CHECK(constGrid.lineAt(LineOffset(1)).dirtyGeneration() == generation1);
+
+    // Modifying a line marks it dirty.
+    grid.useCellAt(LineOffset(1), ColumnOffset(0)).write(GraphicsAttributes {}, U'X', 1);
+    CHECK(constGrid.lineAt(LineOffset(1)).dirtyGeneration() > generation1);
+
+    // Scrolling moves lines along with their generation.
+    auto const generation2 = constGrid.lineAt(LineOffset(2)).dirtyGeneration();
+    grid.scrollUp(LineCount(1));
+    CHECK(constGrid.lineAt(LineOffset(-1)).dirtyGeneration() == generation0);
+    CHECK(constGrid.lineAt(LineOffset(1)).dirtyGeneration() == generation2);
+    CHECK(constGrid.lineAt(LineOffset(2)).dirtyGeneration() != generation2);
+}
+
 TEST_CASE("iteratorAt", "[grid]")
 {
     auto grid = Grid<Cell>(PageSize { LineCount(3), ColumnCount(3) }, true, LineCount(0));
@@ -846,6 +1055,45 @@ TEST_CASE("Grid.reflow.tripple", "[grid]")
     }
 }
 
+TEST_CASE("Grid.reflow.large_history", "[grid]")
+{
+    // Enough lines for the reflow to be split into chunks, if there is more than one hardware thread.
+    auto constexpr LogicalLineCount = 10'000;
+    auto constexpr PageLineCount = 2;
+
+    auto grid = Grid<Cell>(PageSize { LineCount(PageLineCount), ColumnCount(6) }, true, LineCount(30'000));
+    for (auto i = 0; i < LogicalLineCount; ++i)
+    {
+        if (i >= PageLineCount)
+            grid.scrollUp(LineCount(1));
+        grid.setLineText(LineOffset(std::min(i, PageLineCount - 1)), std::format("{:06}", i));
+    }
+    REQUIRE(*grid.historyLineCount() == LogicalLineCount - PageLineCount);
+
+    (void) grid.resize(PageSize { LineCount(PageLineCount), ColumnCount(3) }, CellLocation {}, false);
+
+    REQUIRE(*grid.historyLineCount() == 2 * LogicalLineCount - PageLineCount);
+    auto const top = -*grid.historyLineCount();
+    for (auto i = 0; i < LogicalLineCount; ++i)
+    {
+        auto const text = std::format("{:06}", i);
+        REQUIRE(grid.lineText(LineOffset(top + 2 * i)) == text.substr(0, 3));
+        REQUIRE(grid.lineText(LineOffset(top + 2 * i + 1)) == text.substr(3));
+        REQUIRE(!grid.lineAt(LineOffset(top + 2 * i)).wrapped());
+        REQUIRE(grid.lineAt(LineOffset(top + 2 * i + 1)).wrapped());
+    }
+
+    (void) grid.resize(PageSize { LineCount(PageLineCount), ColumnCount(6) }, CellLocation {}, false);
+
+    REQUIRE(*grid.historyLineCount() == LogicalLineCount - PageLineCount);
+    for (auto i = 0; i < LogicalLineCount; ++i)
+    {
+        auto const line = LineOffset(i - (LogicalLineCount - PageLineCount));
+        REQUIRE(grid.lineText(line) == std::format("{:06}", i));
+        REQUIRE(!grid.lineAt(line).wrapped());
+    }
+}
+
 TEST_CASE("Grid infinite", "[grid]")
 {
     auto gridFinite = Grid<Cell>(PageSize { LineCount(2), ColumnCount(8) }, true, LineCount(0));
@@ -911,6 +1159,48 @@ TEST_CASE("Grid resize", "[grid]")
     REQUIRE(grid.lineAt(LineOffset(1)).isTrivialBuffer());
 }
 
+TEST_CASE("Grid.render.trivialLine_cellwise", "[grid]")
+{
+    struct CellCollector
+    {
+        string text;
+        std::vector<CellFlags> flags;
+
+        void startLine(LineOffset) {}
+        void renderCell(Cell const& cell, LineOffset, ColumnOffset)
+        {
+            text += cell.empty() ? " " : cell.toUtf8();
+            flags.push_back(cell.flags());
+        }
+        void endLine() { text += '\n'; }
+        void renderTrivialLine(TrivialLineBuffer const&, LineOffset) { text += "trivial\n"; }
+        void finish() {}
+    };
+
+    auto grid = Grid<Cell>(PageSize { LineCount(1), ColumnCount(4) }, true, LineCount(0));
+    auto pool = crispy::buffer_object_pool<char>(32);
+    auto bufferObject = pool.allocateBufferObject();
+    bufferObject->writeAtEnd("ab"sv);
+    grid.lineAt(LineOffset(0)) =
+        Line<Cell>(LineFlag::None,
+                   TrivialLineBuffer { .displayWidth = ColumnCount(4),
+                                       .textAttributes = GraphicsAttributes { .flags = CellFlag::Blinking },
+                                       .fillAttributes = GraphicsAttributes {},
+                                       .hyperlink = HyperlinkId {},
+                                       .usedColumns = ColumnCount(2),
+                                       .text = bufferObject->ref(0, 2) });
+
+    // Highlighting search matches requires rendering cell-wise, without inflating the line.
+    auto collector = CellCollector {};
+    auto const hints = grid.render(collector, ScrollOffset(0), HighlightSearchMatches::Yes);
+    CHECK(collector.text == "ab  \n");
+    REQUIRE(collector.flags.size() == 4);
+    CHECK(collector.flags[1] == CellFlag::Blinking);
+    CHECK(collector.flags[2] == CellFlag::None);
+    CHECK(hints.containsBlinkingCells);
+    CHECK(grid.lineAt(LineOffset(0)).isTrivialBuffer());
+}
+
 TEST_CASE("Grid resize with wrap and spaces", "[grid]")
 {
     auto width = ColumnCount(7);
@@ -0,0 +1,203 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtbackend/LatencyTelemetry.h>
+
+#include <algorithm>
+#include <format>
+
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+
+namespace vtbackend
+{
+
+namespace
+{
+    double milliseconds(microseconds value) noexcept
+    {
+        return static_cast<double>(value.count()) / 1000.0;
+    }
+} // namespace
+
+// {{{ RollingHistogram
+void RollingHistogram::add(microseconds sample) noexcept
+{
+    _samples[_next] = sample;
+    _next = (_next + 1) % Capacity;
+    _size = std::min(_size + 1, Capacity);
+}
+
+RollingHistogram::Summary RollingHistogram::summary() const
+{
+    if (_size == 0)
+        return {};
+
+    auto sorted = samples();
+    auto const percentile = [&](size_t percent) {
+        // Nearest-rank method.
+        auto const rank = std::max<size_t>((percent * sorted.size() + 99) / 100, 1);
+        auto const nth = std::next(sorted.begin(), static_cast<std::ptrdiff_t>(rank - 1));
+        std::ranges::nth_element(sorted, nth);
+        return *nth;
+    };
+
+    return Summary {
+        .count = _size,
+        .p50 = percentile(50),
+        .p99 = percentile(99),
+        .max = *std::ranges::max_element(sorted),
+    };
+}
+
+std::vector<microseconds> RollingHistogram::samples() const
+{
+    auto result = std::vector<microseconds> {};
+    result.reserve(_size);
+    auto const first = (_next + Capacity - _size) % Capacity;
+    for (size_t i = 0; i < _size; ++i)
+        result.push_back(_samples[(first + i) % Capacity]);
+    return result;
+}
+// }}}
+
+std::string_view name(LatencyMetric metric) noexcept
+{
+    switch (metric)
+    {
+        case LatencyMetric::KeyToEcho: return "key_to_echo";
+        case LatencyMetric::KeyToPhoton: return "key_to_photon";
+        case LatencyMetric::RenderBuffer: return "render_buffer";
+        case LatencyMetric::GpuExecute: return "gpu_execute";
+        case LatencyMetric::Frame: return "frame";
+    }
+    return "unknown";
+}
+
+// {{{ LatencyTelemetry
+void LatencyTelemetry::keyPressed(Timestamp now)
+{
+    auto const _ = std::lock_guard { _mutex };
+    if (_keyState != KeyState::None && now - _keyTime < MaxPendingTime)
+        return;
+
+    _keyState = KeyState::WaitingForEcho;
+    _keyTime = now;
+}
+
+void LatencyTelemetry::ptyDataReceived(Timestamp now)
+{
+    auto const _ = std::lock_guard { _mutex };
+    if (_keyState != KeyState::WaitingForEcho)
+        return;
+
+    if (now - _keyTime >= MaxPendingTime)
+    {
+        // The key event was not answered by the application.
+        _keyState = KeyState::None;
+        return;
+    }
+
+    record(LatencyMetric::KeyToEcho, _keyTime, now);
+    _keyState = KeyState::EchoReceived;
+    _echoTime = now;
+}
+
+void LatencyTelemetry::renderBufferRefreshed(Timestamp start, Timestamp end)
+{
+    auto const _ = std::lock_guard { _mutex };
+    record(LatencyMetric::RenderBuffer, start, end);
+
+    if (_keyState == KeyState::EchoReceived && start >= _echoTime)
+        _keyState = KeyState::EchoRendered;
+}
+
+void LatencyTelemetry::gpuExecutionStarted(Timestamp now)
+{
+    auto const _ = std::lock_guard { _mutex };
+    _frameStart = now;
+
+    if (_keyState == KeyState::EchoRendered)
+        _keyState = KeyState::EchoInFrame;
+}
+
+void LatencyTelemetry::gpuExecutionFinished(Timestamp now)
+{
+    auto const _ = std::lock_guard { _mutex };
+    if (_frameStart)
+        record(LatencyMetric::GpuExecute, *_frameStart, now);
+}
+
+void LatencyTelemetry::frameSwapped(Timestamp now)
+{
+    auto const _ = std::lock_guard { _mutex };
+    if (_frameStart)
+    {
+        record(LatencyMetric::Frame, *_frameStart, now);
+        _frameStart.reset();
+    }
+
+    if (_keyState == KeyState::EchoInFrame)
+    {
+        record(LatencyMetric::KeyToPhoton, _keyTime, now);
+        _keyState = KeyState::None;
+    }
+}
+
+RollingHistogram::Summary LatencyTelemetry::summary(LatencyMetric metric) const
+{
+    auto const _ = std::lock_guard { _mutex };
+    return _histograms[static_cast<size_t>(metric)].summary();
+}
+
+std::string LatencyTelemetry::statusText() const
+{
+    auto const keyToPhoton = summary(LatencyMetric::KeyToPhoton);
+    auto const frame = summary(LatencyMetric::Frame);
+
+    auto text = std::string {};
+    if (keyToPhoton.count != 0)
+        text += std::format("key->photon {:.1f}/{:.1f}/{:.1f} ms",
+                            milliseconds(keyToPhoton.p50),
+                            milliseconds(keyToPhoton.p99),
+                            milliseconds(keyToPhoton.max));
+    if (frame.count != 0)
+        text += std::format("{}frame {:.1f}/{:.1f}/{:.1f} ms",
+                            text.empty() ? "" : ", ",
+                            milliseconds(frame.p50),
+                            milliseconds(frame.p99),
+                            milliseconds(frame.max));
+    return text;
+}
+
+std::string LatencyTelemetry::toJson() const
+{
+    auto const _ = std::lock_guard { _mutex };
+
+    auto json = std::string("{");
+    for (size_t i = 0; i < LatencyMetricCount; ++i)
+    {
+        auto const& histogram = _histograms[i];
+        auto const summary = histogram.summary();
+        json += std::format("{}\n  \"{}\": {{ \"count\": {}, \"p50_us\": {}, \"p99_us\": {}, \"max_us\": {}, "
+                            "\"samples_us\": [",
+                            i != 0 ? "," : "",
+                            name(static_cast<LatencyMetric>(i)),
+                            summary.count,
+                            summary.p50.count(),
+                            summary.p99.count(),
+                            summary.max.count());
+        auto const samples = histogram.samples();
+        for (size_t k = 0; k < samples.size(); ++k)
+            json += std::format("{}{}", k != 0 ? ", " : "", samples[k].count());
+        json += "] }";
+    }
+    json += "\n}\n";
+    return json;
+}
+
+void LatencyTelemetry::record(LatencyMetric metric, Timestamp start, Timestamp end)
+{
+    _histograms[static_cast<size_t>(metric)].add(duration_cast<microseconds>(end - start));
+}
+// }}}
+
+} // namespace vtbackend
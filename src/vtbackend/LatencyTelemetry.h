@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vtbackend
+{
+
+/// Keeps the most recent samples of a duration, to report their distribution.
+class RollingHistogram
+{
+  public:
+    static constexpr size_t Capacity = 1024;
+
+    struct Summary
+    {
+        size_t count = 0;
+        std::chrono::microseconds p50 {};
+        std::chrono::microseconds p99 {};
+        std::chrono::microseconds max {};
+    };
+
+    void add(std::chrono::microseconds sample) noexcept;
+
+    [[nodiscard]] size_t size() const noexcept { return _size; }
+
+    /// Summarizes the samples currently within the window.
+    [[nodiscard]] Summary summary() const;
+
+    /// Returns the samples currently within the window, oldest first.
+    [[nodiscard]] std::vector<std::chrono::microseconds> samples() const;
+
+  private:
+    std::array<std::chrono::microseconds, Capacity> _samples {};
+    size_t _next = 0;
+    size_t _size = 0;
+};
+
+enum class LatencyMetric : uint8_t
+{
+    KeyToEcho,    // key event until the PTY output that followed it has arrived
+    KeyToPhoton,  // key event until a frame showing that PTY output has been swapped onto the screen
+    RenderBuffer, // refreshing the render buffer
+    GpuExecute,   // executing a frame's GPU commands
+    Frame,        // start of executing a frame's GPU commands until its buffer swap
+};
+
+constexpr inline size_t LatencyMetricCount = 5;
+
+[[nodiscard]] std::string_view name(LatencyMetric metric) noexcept;
+
+/**
+ * Measures frame times and keypress-to-photon latency of a single terminal session.
+ *
+ * The events are timestamped by the GUI thread (key events), the terminal thread (PTY output,
+ * render buffer refreshes) and the render thread (GPU execution, buffer swaps), and are tracked
+ * in rolling histograms per metric.
+ *
+ * Only one key event is tracked at a time. Further key events are ignored until the tracked one
+ * has been shown on screen, or has not been answered by the application within MaxPendingTime.
+ */
+class LatencyTelemetry
+{
+  public:
+    using Timestamp = std::chrono::steady_clock::time_point;
+
+    static constexpr auto MaxPendingTime = std::chrono::seconds(1);
+
+    void keyPressed(Timestamp now);
+
+    /// Invoked after PTY output has been processed, i.e. is visible to the next render buffer refresh.
+    void ptyDataReceived(Timestamp now);
+    void renderBufferRefreshed(Timestamp start, Timestamp end);
+    void gpuExecutionStarted(Timestamp now);
+    void gpuExecutionFinished(Timestamp now);
+    void frameSwapped(Timestamp now);
+
+    [[nodiscard]] RollingHistogram::Summary summary(LatencyMetric metric) const;
+
+    /// Formats a compact one-line summary, e.g. for the status line.
+    [[nodiscard]] std::string statusText() const;
+
+    /// Serializes all metrics, including their samples, as JSON.
+    [[nodiscard]] std::string toJson() const;
+
+  private:
+    enum class KeyState : uint8_t
+    {
+        None,           // no key event being tracked
+        WaitingForEcho, // key event seen, waiting for PTY output
+        EchoReceived,   // PTY output arrived, waiting for a render buffer containing it
+        EchoRendered,   // render buffer contains the output, waiting for a frame to be executed
+        EchoInFrame,    // a frame containing the output is executing, waiting for its buffer swap
+    };
+
+    void record(LatencyMetric metric, Timestamp start, Timestamp end);
+
+    mutable std::mutex _mutex;
+    std::array<RollingHistogram, LatencyMetricCount> _histograms {};
+    KeyState _keyState = KeyState::None;
+    Timestamp _keyTime {};
+    Timestamp _echoTime {};
+    std::optional<Timestamp> _frameStart;
+};
+
+} // namespace vtbackend
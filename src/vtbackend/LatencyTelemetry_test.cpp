@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtbackend/LatencyTelemetry.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace std::chrono_literals;
+using namespace vtbackend;
+
+namespace
+{
+auto const T0 = LatencyTelemetry::Timestamp {} + 1h;
+}
+
+TEST_CASE("RollingHistogram.summary", "[LatencyTelemetry]")
+{
+    auto histogram = RollingHistogram {};
+    CHECK(histogram.summary().count == 0);
+
+    for (auto i = 1; i <= 100; ++i)
+        histogram.add(std::chrono::microseconds(i));
+
+    auto const summary = histogram.summary();
+    CHECK(summary.count == 100);
+    CHECK(summary.p50 == 50us);
+    CHECK(summary.p99 == 99us);
+    CHECK(summary.max == 100us);
+}
+
+TEST_CASE("RollingHistogram.window", "[LatencyTelemetry]")
+{
+    auto histogram = RollingHistogram {};
+    for (size_t i = 0; i < RollingHistogram::Capacity + 2; ++i)
+        histogram.add(std::chrono::microseconds(i));
+
+    auto const samples = histogram.samples();
+    REQUIRE(samples.size() == RollingHistogram::Capacity);
+    CHECK(samples.front() == 2us);
+    CHECK(samples.back() == std::chrono::microseconds(RollingHistogram::Capacity + 1));
+}
+
+TEST_CASE("LatencyTelemetry.keyToPhoton", "[LatencyTelemetry]")
+{
+    auto telemetry = LatencyTelemetry {};
+
+    telemetry.keyPressed(T0);
+    telemetry.keyPressed(T0 + 1ms); // ignored, as the first key event is still being tracked
+    telemetry.ptyDataReceived(T0 + 2ms);
+
+    // A frame that was already being rendered before the echo arrived must not count.
+    telemetry.gpuExecutionStarted(T0 + 3ms);
+    telemetry.frameSwapped(T0 + 4ms);
+    CHECK(telemetry.summary(LatencyMetric::KeyToPhoton).count == 0);
+
+    telemetry.renderBufferRefreshed(T0 + 5ms, T0 + 6ms);
+    telemetry.gpuExecutionStarted(T0 + 7ms);
+    telemetry.gpuExecutionFinished(T0 + 8ms);
+    telemetry.frameSwapped(T0 + 10ms);
+
+    CHECK(telemetry.summary(LatencyMetric::KeyToEcho).max == 2ms);
+    CHECK(telemetry.summary(LatencyMetric::KeyToPhoton).max == 10ms);
+    CHECK(telemetry.summary(LatencyMetric::RenderBuffer).max == 1ms);
+    CHECK(telemetry.summary(LatencyMetric::GpuExecute).max == 1ms);
+    CHECK(telemetry.summary(LatencyMetric::Frame).count == 2);
+    CHECK(telemetry.summary(LatencyMetric::Frame).max == 3ms);
+}
+
+TEST_CASE("LatencyTelemetry.unansweredKey", "[LatencyTelemetry]")
+{
+    auto telemetry = LatencyTelemetry {};
+
+    telemetry.keyPressed(T0);
+    telemetry.ptyDataReceived(T0 + LatencyTelemetry::MaxPendingTime);
+    CHECK(telemetry.summary(LatencyMetric::KeyToEcho).count == 0);
+
+    telemetry.keyPressed(T0 + 2s);
+    telemetry.ptyDataReceived(T0 + 2s + 3ms);
+    CHECK(telemetry.summary(LatencyMetric::KeyToEcho).max == 3ms);
+}
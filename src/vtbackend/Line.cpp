@@ -7,6 +7,8 @@
 #include <libunicode/utf8.h>
 #include <libunicode/width.h>
 
+#include <limits>
+
 using std::get;
 using std::holds_alternative;
 using std::min;
@@ -88,10 +90,36 @@ inline void Line<Cell>::resize(ColumnCount count)
             buffer.displayWidth = count;
             return;
         }
+        if (auto* frozen = std::get_if<FrozenLineBuffer>(&_storage); frozen && frozen->usedColumns() <= count)
+        {
+            frozen->displayWidth = count;
+            return;
+        }
     }
     inflatedBuffer().resize(unbox<size_t>(count));
 }
 
+template <CellConcept Cell>
+bool Line<Cell>::freeze()
+{
+    if (auto const* cells = std::get_if<InflatedBuffer>(&_storage))
+        if (auto frozen = vtbackend::freeze<Cell>(*cells))
+            _storage = std::move(*frozen);
+
+    return isFrozenBuffer();
+}
+
+template <CellConcept Cell>
+size_t Line<Cell>::bytesUsed() const noexcept
+{
+    if (auto const* trivial = std::get_if<TrivialBuffer>(&_storage))
+        return sizeof(Line) + trivial->text.size();
+    else if (auto const* frozen = std::get_if<FrozenLineBuffer>(&_storage))
+        return sizeof(Line) + frozen->heapBytesUsed();
+    else
+        return sizeof(Line) + std::get<InflatedBuffer>(_storage).capacity() * sizeof(Cell);
+}
+
 template <CellConcept Cell>
 gsl::span<Cell const> Line<Cell>::trim_blank_right() const noexcept
 {
@@ -116,6 +144,13 @@ std::string Line<Cell>::toUtf8() const
         return str;
     }
 
+    if (auto const* frozen = std::get_if<FrozenLineBuffer>(&_storage); frozen && frozen->layout.empty())
+    {
+        auto str = frozen->text;
+        str.append(unbox<size_t>(frozen->displayWidth - frozen->usedColumns()), ' ');
+        return str;
+    }
+
     std::string str;
     for (Cell const& cell: inflatedBuffer())
     {
@@ -220,6 +255,117 @@ InflatedLineBuffer<Cell> inflate(TrivialLineBuffer const& input)
 
     return columns;
 }
+
+namespace
+{
+    // Layout byte of a cell holding exactly one codepoint of width 1.
+    constexpr uint8_t SimpleCellLayout = (1 << 4) | 1;
+
+    template <CellConcept Cell>
+    GraphicsAttributes attributesOf(Cell const& cell) noexcept
+    {
+        return GraphicsAttributes {
+            .foregroundColor = cell.foregroundColor(),
+            .backgroundColor = cell.backgroundColor(),
+            .underlineColor = cell.underlineColor(),
+            .flags = cell.flags(),
+        };
+    }
+} // namespace
+
+template <CellConcept Cell>
+std::optional<FrozenLineBuffer> freeze(InflatedLineBuffer<Cell> const& input)
+{
+    auto output = FrozenLineBuffer { .displayWidth = ColumnCount::cast_from(input.size()) };
+    if (!input.empty())
+        output.fillAttributes = attributesOf(input.back());
+
+    auto usedCells = input.size();
+    while (usedCells > 0)
+    {
+        Cell const& cell = input[usedCells - 1];
+        if (cell.codepointCount() != 0 || cell.width() != 1 || cell.hyperlink() != HyperlinkId {}
+            || attributesOf(cell) != output.fillAttributes)
+            break;
+        --usedCells;
+    }
+
+    for (size_t i = 0; i < usedCells; ++i)
+    {
+        Cell const& cell = input[i];
+        if (cell.imageFragment())
+            return std::nullopt;
+
+        auto const attributes = attributesOf(cell);
+        auto const hyperlink = cell.hyperlink();
+        if (output.spans.empty() || output.spans.back().attributes != attributes
+            || output.spans.back().hyperlink != hyperlink
+            || output.spans.back().cellCount == std::numeric_limits<uint16_t>::max())
+            output.spans.emplace_back(FrozenLineBuffer::Span { .attributes = attributes, .hyperlink = hyperlink });
+        ++output.spans.back().cellCount;
+
+        auto const codepointCount = cell.codepointCount();
+        for (size_t k = 0; k < codepointCount; ++k)
+            output.text += unicode::convert_to<char>(cell.codepoint(k));
+
+        auto const cellLayout = static_cast<uint8_t>((cell.width() << 4) | codepointCount);
+        if (output.layout.empty() && cellLayout != SimpleCellLayout)
+            output.layout.assign(i, SimpleCellLayout);
+        if (!output.layout.empty())
+            output.layout.push_back(cellLayout);
+    }
+
+    output.text.shrink_to_fit();
+    output.spans.shrink_to_fit();
+    return output;
+}
+
+template <CellConcept Cell>
+InflatedLineBuffer<Cell> inflate(FrozenLineBuffer const& input)
+{
+    static constexpr char32_t ReplacementCharacter { 0xFFFD };
+
+    auto columns = InflatedLineBuffer<Cell> {};
+    columns.reserve(unbox<size_t>(input.displayWidth));
+
+    auto utf8DecoderState = unicode::utf8_decoder_state {};
+    auto textPosition = input.text.begin();
+    auto const nextCodepoint = [&]() -> char32_t {
+        while (textPosition != input.text.end())
+        {
+            auto const r = unicode::from_utf8(utf8DecoderState, static_cast<uint8_t>(*textPosition++));
+            if (holds_alternative<unicode::Incomplete>(r))
+                continue;
+            return holds_alternative<unicode::Success>(r) ? get<unicode::Success>(r).value
+                                                          : ReplacementCharacter;
+        }
+        return ReplacementCharacter;
+    };
+
+    for (auto const& span: input.spans)
+    {
+        for (uint16_t i = 0; i < span.cellCount; ++i)
+        {
+            auto const cellLayout = input.layout.empty() ? SimpleCellLayout : input.layout[columns.size()];
+            auto const width = static_cast<uint8_t>(cellLayout >> 4);
+            auto const codepointCount = cellLayout & 0x0F;
+
+            Cell& cell = columns.emplace_back(span.attributes, span.hyperlink);
+            if (codepointCount != 0)
+            {
+                cell.write(span.attributes, nextCodepoint(), width, span.hyperlink);
+                for (int k = 1; k < codepointCount; ++k)
+                    (void) cell.appendCharacter(nextCodepoint());
+            }
+            cell.setWidth(width);
+        }
+    }
+
+    while (columns.size() < unbox<size_t>(input.displayWidth))
+        columns.emplace_back(Cell { input.fillAttributes });
+
+    return columns;
+}
 } // end namespace vtbackend
 
 #include <vtbackend/cell/CompactCell.h>
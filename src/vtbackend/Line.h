@@ -18,6 +18,7 @@
 #include <gsl/span_ext>
 
 #include <algorithm>
+#include <optional>
 #include <string>
 #include <variant>
 #include <vector>
@@ -56,6 +57,10 @@ struct TrivialLineBuffer
     ColumnCount usedColumns {};
     crispy::buffer_fragment<char> text {};
 
+    /// Tests whether every used column is backed by exactly one byte of text,
+    /// which is the case iff the text consists of US-ASCII characters only.
+    [[nodiscard]] bool isAscii() const noexcept { return text.size() == unbox<size_t>(usedColumns); }
+
     void reset(GraphicsAttributes attributes) noexcept
     {
         textAttributes = attributes;
@@ -73,14 +78,77 @@ using InflatedLineBuffer = std::vector<Cell>;
 template <CellConcept Cell>
 InflatedLineBuffer<Cell> inflate(TrivialLineBuffer const& input);
 
+/**
+ * Compact, read-only line storage for scrollback lines that are no longer hot.
+ *
+ * The cells' codepoints are stored as one UTF-8 string, and their graphics attributes
+ * as run-length encoded spans. Trailing empty cells are not stored at all but implied by
+ * displayWidth and fillAttributes.
+ */
+struct FrozenLineBuffer
+{
+    /// A run of consecutive cells sharing the same graphics attributes and hyperlink.
+    struct Span
+    {
+        GraphicsAttributes attributes;
+        HyperlinkId hyperlink {};
+        uint16_t cellCount = 0;
+    };
+
+    ColumnCount displayWidth;
+    GraphicsAttributes fillAttributes;
+
+    /// UTF-8 encoded codepoints of all stored cells, in column order.
+    std::string text;
+
+    std::vector<Span> spans;
+
+    /// Per stored cell: (width << 4) | codepointCount.
+    /// Empty if every stored cell holds exactly one codepoint of width 1.
+    std::vector<uint8_t> layout;
+
+    [[nodiscard]] ColumnCount usedColumns() const noexcept
+    {
+        size_t count = 0;
+        for (auto const& span: spans)
+            count += span.cellCount;
+        return ColumnCount::cast_from(count);
+    }
+
+    /// Returns the number of heap bytes allocated by this buffer.
+    [[nodiscard]] size_t heapBytesUsed() const noexcept
+    {
+        return text.capacity() + spans.capacity() * sizeof(Span) + layout.capacity();
+    }
+};
+
+/// Packs the given cells into a FrozenLineBuffer.
+///
+/// @returns std::nullopt if the line cannot be represented in frozen form,
+///          i.e. if it holds image fragments.
+template <CellConcept Cell>
+std::optional<FrozenLineBuffer> freeze(InflatedLineBuffer<Cell> const& input);
+
+/// Unpacks a FrozenLineBuffer into an InflatedLineBuffer<Cell>.
 template <CellConcept Cell>
-using LineStorage = std::variant<TrivialLineBuffer, InflatedLineBuffer<Cell>>;
+InflatedLineBuffer<Cell> inflate(FrozenLineBuffer const& input);
+
+template <CellConcept Cell>
+using LineStorage = std::variant<TrivialLineBuffer, InflatedLineBuffer<Cell>, FrozenLineBuffer>;
 
 /**
  * Line<Cell> API.
  *
+ * A line is kept in its compact TrivialLineBuffer form for as long as it was only written
+ * left-to-right with a single set of graphics attributes. It is inflated into a vector of cells
+ * only when being edited cell-wise (e.g. by cursor-addressed writes). Read-only queries that can be
+ * answered from the trivial form (such as cellWidthAt()) must not inflate the line.
+ *
+ * Lines that have scrolled far enough into the history may be frozen into a FrozenLineBuffer
+ * (see Grid<Cell>::setHotHistoryLineCount()). A frozen line is transparently thawed back
+ * into its inflated form as soon as its cells are accessed.
+ *
  * TODO: Use custom allocator for ensuring cache locality of Cells to sibling lines.
- * TODO: Make the line optimization work.
  */
 template <CellConcept Cell>
 class Line
@@ -104,13 +172,15 @@ class Line
 
     Line(LineFlags flags, InflatedBuffer buffer): _storage { std::move(buffer) }, _flags { flags } {}
 
+    Line(LineFlags flags, FrozenLineBuffer buffer): _storage { std::move(buffer) }, _flags { flags } {}
+
     void reset(LineFlags flags, GraphicsAttributes attributes) noexcept
     {
         _flags = flags;
         if (isTrivialBuffer())
             trivialBuffer().reset(attributes);
         else
-            setBuffer(TrivialBuffer { ColumnCount::cast_from(inflatedBuffer().size()), attributes });
+            setBuffer(TrivialBuffer { size(), attributes });
     }
 
     void reset(LineFlags flags, GraphicsAttributes attributes, ColumnCount count) noexcept
@@ -143,6 +213,9 @@ class Line
         if (isTrivialBuffer())
             return trivialBuffer().text.empty();
 
+        if (auto const* frozen = std::get_if<FrozenLineBuffer>(&_storage))
+            return frozen->text.empty();
+
         for (auto const& cell: inflatedBuffer())
             if (!cell.empty())
                 return false;
@@ -179,6 +252,8 @@ class Line
     {
         if (isTrivialBuffer())
             return trivialBuffer().displayWidth;
+        else if (auto const* frozen = std::get_if<FrozenLineBuffer>(&_storage))
+            return frozen->displayWidth;
         else
             return ColumnCount::cast_from(inflatedBuffer().size());
     }
@@ -213,8 +288,11 @@ class Line
         {
             Require(ColumnOffset(0) <= column);
             Require(column < ColumnOffset::cast_from(size()));
-            return unbox<size_t>(column) >= trivialBuffer().text.size()
-                   || trivialBuffer().text[column.as<size_t>()] == 0x20;
+            auto const& buffer = trivialBuffer();
+            if (column >= boxed_cast<ColumnOffset>(buffer.usedColumns))
+                return true;
+            if (buffer.isAscii())
+                return buffer.text[column.as<size_t>()] == 0x20;
         }
         auto const& cell = inflatedBuffer().at(unbox<size_t>(column));
         return cell.empty() || (cell.codepointCount() == 1 && cell.codepoint(0) == 0x20);
@@ -222,17 +300,32 @@ class Line
 
     [[nodiscard]] uint8_t cellWidthAt(ColumnOffset column) const noexcept
     {
-#if 0 // TODO: This optimization - but only when we return actual widths and not always 1.
         if (isTrivialBuffer())
         {
             Require(ColumnOffset(0) <= column);
             Require(column < ColumnOffset::cast_from(size()));
-            return 1; // TODO: When trivial line is to support Unicode, this should be adapted here.
+            auto const& buffer = trivialBuffer();
+            if (buffer.isAscii() || column >= boxed_cast<ColumnOffset>(buffer.usedColumns))
+                return 1;
         }
-#endif
         return inflatedBuffer().at(unbox<size_t>(column)).width();
     }
 
+    [[nodiscard]] CellFlags cellFlagsAt(ColumnOffset column) const noexcept
+    {
+        if (isTrivialBuffer())
+        {
+            Require(ColumnOffset(0) <= column);
+            Require(column < ColumnOffset::cast_from(size()));
+            auto const& buffer = trivialBuffer();
+            if (column >= boxed_cast<ColumnOffset>(buffer.usedColumns))
+                return buffer.fillAttributes.flags;
+            if (buffer.isAscii())
+                return buffer.textAttributes.flags;
+        }
+        return inflatedBuffer().at(unbox<size_t>(column)).flags();
+    }
+
     [[nodiscard]] LineFlags flags() const noexcept { return static_cast<LineFlags>(_flags); }
 
     [[nodiscard]] bool marked() const noexcept { return isFlagEnabled(LineFlag::Marked); }
@@ -295,10 +388,43 @@ class Line
     {
         return std::holds_alternative<TrivialBuffer>(_storage);
     }
-    [[nodiscard]] bool isInflatedBuffer() const noexcept { return !isTrivialBuffer(); }
+    [[nodiscard]] bool isInflatedBuffer() const noexcept
+    {
+        return std::holds_alternative<InflatedBuffer>(_storage);
+    }
+
+    [[nodiscard]] bool isFrozenBuffer() const noexcept
+    {
+        return std::holds_alternative<FrozenLineBuffer>(_storage);
+    }
+
+    [[nodiscard]] FrozenLineBuffer const& frozenBuffer() const noexcept
+    {
+        return std::get<FrozenLineBuffer>(_storage);
+    }
+
+    /// Packs an inflated line into its compact frozen form.
+    ///
+    /// Trivial lines are left as they are, since they are compact already.
+    ///
+    /// @returns true if the line is in frozen form afterwards.
+    bool freeze();
+
+    /// Approximates the number of bytes this line occupies, including its heap allocations.
+    [[nodiscard]] size_t bytesUsed() const noexcept;
 
     void setBuffer(Storage buffer) noexcept { _storage = std::move(buffer); }
 
+    /// Returns the generation number this line has been stamped with on its most recent modification.
+    ///
+    /// Generation numbers are handed out by the owning Grid and are unique within that grid,
+    /// so that they identify a line's contents across frames, even if the line has been moved.
+    /// A value of zero means that the line has not been stamped yet.
+    ///
+    /// @see Grid::markLineDirty()
+    [[nodiscard]] uint64_t dirtyGeneration() const noexcept { return _dirtyGeneration; }
+    void markDirty(uint64_t generation) noexcept { _dirtyGeneration = generation; }
+
     // Tests if the given text can be matched in this line at the exact given start column, in sensetive
     // or insensitive mode.
     [[nodiscard]] bool matchTextAtWithSensetivityMode(std::u32string_view text,
@@ -446,6 +572,7 @@ class Line
   private:
     Storage _storage;
     LineFlags _flags;
+    uint64_t _dirtyGeneration = 0;
 };
 
 template <CellConcept Cell>
@@ -453,6 +580,8 @@ inline typename Line<Cell>::InflatedBuffer& Line<Cell>::inflatedBuffer()
 {
     if (auto trivialbuffer = std::get_if<TrivialBuffer>(&_storage))
         _storage = inflate<Cell>(*trivialbuffer);
+    else if (auto frozenBuffer = std::get_if<FrozenLineBuffer>(&_storage))
+        _storage = inflate<Cell>(*frozenBuffer);
     return std::get<InflatedBuffer>(_storage);
 }
 
@@ -6,6 +6,9 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
+#include <thread>
+
 using namespace std;
 
 using namespace vtbackend;
@@ -235,3 +238,166 @@ TEST_CASE("Line.inflate.Unicode.FamilyEmoji", "[Line]")
     REQUIRE(cell.backgroundColor() == fillSGR.backgroundColor);
     REQUIRE(cell.underlineColor() == fillSGR.underlineColor);
 }
+
+TEST_CASE("Line.freeze", "[Line]")
+{
+    auto sgr = GraphicsAttributes {};
+    sgr.foregroundColor = RGBColor(0x123456);
+    sgr.flags |= CellFlag::Bold;
+
+    auto fillSGR = GraphicsAttributes {};
+    fillSGR.backgroundColor = Color::Indexed(IndexedColor::Yellow);
+
+    auto cells = InflatedLineBuffer<Cell>(8, Cell { fillSGR });
+    cells[0].write(sgr, U'A', 1);
+    cells[1].write(GraphicsAttributes {}, U'B', 1);
+    cells[2].write(sgr, U'\u4E2D', 2); // CJK wide character
+    cells[3].reset(sgr.with(CellFlag::WideCharContinuation));
+    cells[4].write(sgr, U'e', 1);
+    (void) cells[4].appendCharacter(U'\u0301'); // combining acute accent
+
+    auto line = Line<Cell>(LineFlag::None, cells);
+    REQUIRE(line.freeze());
+    REQUIRE(line.isFrozenBuffer());
+    CHECK(line.size() == ColumnCount(8));
+    CHECK(line.frozenBuffer().usedColumns() == ColumnCount(5));
+    CHECK(line.frozenBuffer().spans.size() == 5);
+    CHECK(!line.empty());
+
+    auto const& thawed = line.inflatedBuffer();
+    REQUIRE(line.isInflatedBuffer());
+    REQUIRE(thawed.size() == cells.size());
+    for (size_t i = 0; i < cells.size(); ++i)
+    {
+        INFO(std::format("column {}", i));
+        CHECK(thawed[i].codepoints() == cells[i].codepoints());
+        CHECK(thawed[i].width() == cells[i].width());
+        CHECK(thawed[i].flags() == cells[i].flags());
+        CHECK(thawed[i].foregroundColor() == cells[i].foregroundColor());
+        CHECK(thawed[i].backgroundColor() == cells[i].backgroundColor());
+    }
+}
+
+TEST_CASE("Line.freeze.ASCII", "[Line]")
+{
+    auto cells = InflatedLineBuffer<Cell>(10, Cell {});
+    auto constexpr Text = "Hello"sv;
+    for (size_t i = 0; i < Text.size(); ++i)
+        cells[i].write(GraphicsAttributes {}, static_cast<char32_t>(Text[i]), 1);
+
+    auto line = Line<Cell>(LineFlag::None, cells);
+    REQUIRE(line.freeze());
+    CHECK(line.frozenBuffer().text == "Hello");
+    CHECK(line.frozenBuffer().layout.empty());
+    CHECK(line.toUtf8() == "Hello     ");
+    CHECK(line.isFrozenBuffer()); // toUtf8() must not thaw a frozen line.
+
+    line.resize(ColumnCount(12));
+    CHECK(line.isFrozenBuffer());
+    CHECK(line.size() == ColumnCount(12));
+    CHECK(line.toUtf8Trimmed() == "Hello");
+}
+
+TEST_CASE("CompactCell.CellExtraPool", "[Line]")
+{
+    auto& pool = CellExtraPool::instance();
+    auto const sizeBefore = pool.size();
+
+    auto cell = CompactCell {};
+    cell.write(GraphicsAttributes {}, U'a', 1);
+    CHECK(pool.size() == sizeBefore);
+
+    cell.setUnderlineColor(RGBColor { 0x10, 0x20, 0x30 });
+    cell.resetFlags(CellFlag::CurlyUnderlined);
+    CHECK(pool.size() == sizeBefore + 1);
+
+    SECTION("copy")
+    {
+        auto copy = cell;
+        CHECK(pool.size() == sizeBefore + 2);
+        CHECK(copy.underlineColor() == cell.underlineColor());
+        CHECK(copy.flags() == cell.flags());
+
+        copy.setUnderlineColor(DefaultColor());
+        CHECK(cell.underlineColor() == Color(RGBColor { 0x10, 0x20, 0x30 }));
+
+        copy = CompactCell {};
+        CHECK(pool.size() == sizeBefore + 1);
+        CHECK(copy.flags() == CellFlag::None);
+    }
+
+    SECTION("move")
+    {
+        auto moved = std::move(cell);
+        CHECK(pool.size() == sizeBefore + 1);
+        CHECK(moved.flags() == CellFlag::CurlyUnderlined);
+    }
+
+    SECTION("reset")
+    {
+        cell.reset();
+        CHECK(pool.size() == sizeBefore);
+        CHECK(cell.underlineColor() == DefaultColor());
+    }
+
+    SECTION("reset with attributes")
+    {
+        // The present slot is reused rather than released and allocated again.
+        cell.reset(GraphicsAttributes { .flags = CellFlag::Bold });
+        CHECK(pool.size() == sizeBefore + 1);
+        CHECK(cell.flags() == CellFlag::Bold);
+        CHECK(cell.underlineColor() == DefaultColor());
+
+        cell.reset(GraphicsAttributes {});
+        CHECK(pool.size() == sizeBefore);
+    }
+}
+
+TEST_CASE("CellExtraPool.release_chunks", "[Line]")
+{
+    auto pool = std::make_unique<CellExtraPool>();
+
+    auto ids = std::vector<CellExtraId> {};
+    for (auto i = 0u; i < 3 * CellExtraPool::ChunkSize; ++i)
+        ids.push_back(pool->allocate());
+    CHECK(pool->size() == ids.size());
+    CHECK(pool->capacity() == 3 * CellExtraPool::ChunkSize);
+
+    for (auto const id: ids)
+        pool->release(id);
+    CHECK(pool->size() == 0);
+
+    // Only the chunk holding the slots that are still cached for this thread is kept.
+    CHECK(pool->capacity() == CellExtraPool::ChunkSize);
+
+    // Released ids are handed out again, recreating the chunks they live in.
+    ids.clear();
+    for (auto i = 0u; i < 2 * CellExtraPool::ChunkSize; ++i)
+        ids.push_back(pool->allocate());
+    CHECK(pool->at(ids.back()).width == 1);
+    CHECK(pool->capacity() == 2 * CellExtraPool::ChunkSize);
+
+    for (auto const id: ids)
+        pool->release(id);
+}
+
+TEST_CASE("CellExtraPool.threads", "[Line]")
+{
+    auto pool = std::make_unique<CellExtraPool>();
+
+    // Slots allocated on one thread may be released on another one.
+    auto ids = std::vector<CellExtraId> {};
+    std::thread([&]() {
+        for (auto i = 0u; i < 4 * CellExtraPool::BatchSize; ++i)
+            ids.push_back(pool->allocate());
+    }).join();
+    CHECK(pool->size() == ids.size());
+
+    for (auto const id: ids)
+        pool->release(id);
+    CHECK(pool->size() == 0);
+
+    auto const id = pool->allocate();
+    CHECK(std::ranges::find(ids, id) != ids.end());
+    pool->release(id);
+}
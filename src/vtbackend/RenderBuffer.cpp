@@ -7,29 +7,23 @@
 namespace vtbackend
 {
 
-bool RenderDoubleBuffer::swapBuffers(std::chrono::steady_clock::time_point now) noexcept
+RenderBufferRef RenderTripleBuffer::frontBuffer() const
 {
-    // If the terminal thread (writer) cannot try_lock (w/o wait time)
-    // the front buffer, it'll just flush back buffer instead of swapping
-    // buffers as the front buffer is apparently still in use by the
-    // renderer thread and we want to avoid render-thread imposed
-    // wait times in the terminal thread as much as possible.
+    auto lock = std::unique_lock(_readerLock);
 
-    if (!readerLock.try_lock())
-        return false;
+    if (_readyBufferIndex.load(std::memory_order_relaxed) & FreshBit)
+        _frontBufferIndex = _readyBufferIndex.exchange(_frontBufferIndex, std::memory_order_acq_rel) & IndexMask;
 
-    auto const _ = std::lock_guard<decltype(readerLock)>(readerLock, std::adopt_lock);
+    return RenderBufferRef(buffers[_frontBufferIndex], std::move(lock));
+}
 
-    for (;;)
-    {
-        auto current = currentBackBufferIndex.load();
-        if (currentBackBufferIndex.compare_exchange_weak(current, (current + 1) % 2))
-            break;
-    }
+void RenderTripleBuffer::swapBuffers(std::chrono::steady_clock::time_point now) noexcept
+{
+    _backBufferIndex =
+        _readyBufferIndex.exchange(_backBufferIndex | FreshBit, std::memory_order_acq_rel) & IndexMask;
 
     lastUpdate = now;
     state = RenderBufferState::WaitingForRefresh;
-    return true;
 }
 
 } // namespace vtbackend
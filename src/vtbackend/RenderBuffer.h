@@ -3,7 +3,9 @@
 
 #include <vtbackend/CellFlags.h>
 #include <vtbackend/Color.h>
+#include <vtbackend/ColorPalette.h>
 #include <vtbackend/Grid.h>
+#include <vtbackend/Hyperlink.h>
 #include <vtbackend/Image.h>
 #include <vtbackend/primitives.h>
 
@@ -13,8 +15,11 @@
 
 #include <atomic>
 #include <chrono>
+#include <limits>
+#include <memory>
 #include <mutex>
 #include <optional>
+#include <string_view>
 #include <vector>
 
 namespace vtbackend
@@ -31,11 +36,20 @@ struct RenderAttributes
 /**
  * Renderable representation of a grid cell with color-altering pre-applied and
  * additional information for cell ranges that can be text-shaped together.
+ *
+ * The cell's codepoints and image fragment are stored in the owning RenderBuffer,
+ * which keeps RenderCell trivially copyable and free of per-cell heap allocations.
+ *
+ * @see RenderBuffer::codepointsOf()
+ * @see RenderBuffer::imageOf()
  */
 struct RenderCell
 {
-    std::u32string codepoints;
-    std::shared_ptr<ImageFragment> image;
+    static constexpr uint32_t NoImage = std::numeric_limits<uint32_t>::max();
+
+    uint32_t codepointsOffset = 0;  // offset into RenderBuffer::codepoints
+    uint32_t codepointCount = 0;    // number of codepoints in RenderBuffer::codepoints
+    uint32_t imageIndex = NoImage;  // index into RenderBuffer::images
     CellLocation position;
     RenderAttributes attributes;
     uint8_t width = 1;
@@ -68,36 +82,143 @@ struct RenderBuffer
 {
     std::vector<RenderCell> cells {};
     std::vector<RenderLine> lines {};
+
+    /// Codepoints of all cells, referenced by RenderCell::codepointsOffset and RenderCell::codepointCount.
+    std::vector<char32_t> codepoints {};
+
+    /// Image fragments of all cells, referenced by RenderCell::imageIndex.
+    std::vector<std::shared_ptr<ImageFragment>> images {};
+
     std::optional<RenderCursor> cursor {};
     uint64_t frameID {};
 
+    /// Screen lines whose contents differ from the frame with ID frameID - 1.
+    ///
+    /// A renderer that did not render that very frame (e.g. because it has been superseded
+    /// before it could be picked up) must consider all lines dirty.
+    std::vector<LineOffset> dirtyLines {};
+
+    /// Indicates that all lines must be considered dirty, regardless of dirtyLines.
+    bool allLinesDirty = true;
+
+    [[nodiscard]] std::u32string_view codepointsOf(RenderCell const& cell) const noexcept
+    {
+        return { codepoints.data() + cell.codepointsOffset, cell.codepointCount };
+    }
+
+    [[nodiscard]] ImageFragment const* imageOf(RenderCell const& cell) const noexcept
+    {
+        return cell.imageIndex != RenderCell::NoImage ? images[cell.imageIndex].get() : nullptr;
+    }
+
+    /// Appends the given codepoints to the given cell.
+    ///
+    /// The cell's existing codepoints, if any, must be the most recently appended ones.
+    void appendCodepoints(RenderCell& cell, std::u32string_view text)
+    {
+        if (cell.codepointCount == 0)
+            cell.codepointsOffset = static_cast<uint32_t>(codepoints.size());
+        codepoints.insert(codepoints.end(), text.begin(), text.end());
+        cell.codepointCount += static_cast<uint32_t>(text.size());
+    }
+
+    void setImage(RenderCell& cell, std::shared_ptr<ImageFragment> image)
+    {
+        cell.imageIndex = static_cast<uint32_t>(images.size());
+        images.emplace_back(std::move(image));
+    }
+
     void clear()
     {
         cells.clear();
         lines.clear();
+        codepoints.clear();
+        images.clear();
         cursor.reset();
+        dirtyLines.clear();
+        allLinesDirty = false;
+    }
+};
+
+/**
+ * Keeps the render cells of the grid lines of the most recently built frame,
+ * so that lines that have not been modified since need not be rebuilt.
+ *
+ * Grid lines are identified by their dirty generation (see Grid::markLineDirty()),
+ * which allows reusing a line's render cells even if it has been moved to another
+ * screen line, e.g. by scrolling.
+ */
+struct RenderLineCache
+{
+    /// Terminal state that affects the rendering of all lines alike.
+    ///
+    /// Any change to it invalidates the whole cache.
+    struct Key
+    {
+        bool primaryScreen = true;
+        LineOffset baseLine {};
+        PageSize pageSize {};
+        bool reverseVideo = false;
+        bool blinkState = false;
+        bool rapidBlinkState = false;
+        HyperlinkId hoveringHyperlink {};
+        ColorPalette::Palette palette {};
+        RGBColor defaultForeground {};
+        RGBColor defaultBackground {};
+        RGBColor defaultForegroundBright {};
+        RGBColor defaultForegroundDimmed {};
+        bool useBrightColors = false;
+        RGBColor hyperlinkNormal {};
+        RGBColor hyperlinkHover {};
+
+        bool operator==(Key const&) const noexcept = default;
+    };
+
+    struct Entry
+    {
+        uint64_t generation = 0; // zero if the line is not cached
+        LineOffset lineOffset {};
+        bool containsBlinkingCells = false;
+        std::vector<RenderCell> cells {}; // empty for lines rendered as RenderLine
+
+        // Codepoints and image fragments of the cells above, which refer to them relative
+        // to the beginning of these tables rather than to those of a RenderBuffer.
+        std::vector<char32_t> codepoints {};
+        std::vector<std::shared_ptr<ImageFragment>> images {};
+    };
+
+    std::optional<Key> key {};
+    std::vector<Entry> previousFrame {}; // indexed by screen line offset
+    std::vector<Entry> currentFrame {};  // indexed by screen line offset
+
+    void clear()
+    {
+        key.reset();
+        previousFrame.clear();
+        currentFrame.clear();
     }
 };
 
 /// Lock-guarded handle to a read-only RenderBuffer object.
 ///
+/// The lock only serializes readers among each other. It is never acquired by the writer.
+///
 /// @see RenderBuffer
+/// @see RenderTripleBuffer
 struct RenderBufferRef
 {
     gsl::not_null<RenderBuffer const*> buffer;
-    gsl::not_null<std::mutex*> guard;
+    std::unique_lock<std::mutex> guard;
 
     [[nodiscard]] RenderBuffer const& get() const noexcept { return *buffer; }
 
-    RenderBufferRef(RenderBuffer const& buf, std::mutex& lock): buffer { &buf }, guard { &lock }
+    RenderBufferRef(RenderBuffer const& buf, std::unique_lock<std::mutex> lock):
+        buffer { &buf }, guard { std::move(lock) }
     {
-        guard->lock();
     }
-
-    ~RenderBufferRef() { guard->unlock(); }
 };
 
-/// Reflects the current state of a RenderDoubleBuffer object.
+/// Reflects the current state of a RenderTripleBuffer object.
 ///
 enum class RenderBufferState : uint8_t
 {
@@ -117,28 +238,46 @@ constexpr std::string_view to_string(RenderBufferState state) noexcept
     return "INVALID";
 }
 
-struct RenderDoubleBuffer
+/**
+ * Lock-free triple buffer of RenderBuffer objects.
+ *
+ * The writer (terminal) thread owns the back buffer and the reader (render) thread owns the front buffer.
+ * The third buffer is the ready buffer that is handed over between both threads by a single atomic exchange:
+ *
+ * - the writer publishes a completely filled back buffer by exchanging it with the ready buffer,
+ * - the reader picks up the most recently published buffer by exchanging its front buffer with
+ *   the ready buffer, iff the ready buffer has been published since the reader's last pick-up.
+ *
+ * This way the writer never waits for the reader, and the reader always renders the newest complete frame.
+ * Frames that were published but superseded before the reader picked them up are dropped.
+ */
+struct RenderTripleBuffer
 {
-    std::mutex mutable readerLock;
-    std::atomic<size_t> currentBackBufferIndex = 0;
-    std::array<RenderBuffer, 2> buffers {};
+    std::array<RenderBuffer, 3> buffers {};
     std::atomic<RenderBufferState> state = RenderBufferState::WaitingForRefresh;
     std::chrono::steady_clock::time_point lastUpdate {};
 
-    RenderBuffer& backBuffer() noexcept { return buffers[currentBackBufferIndex]; }
+    RenderBuffer& backBuffer() noexcept { return buffers[_backBufferIndex]; }
 
-    RenderBufferRef frontBuffer() const
-    {
-        // if (state == RenderBufferState::TrySwapBuffers)
-        //     const_cast<RenderDoubleBuffer*>(this)->swapBuffers(lastUpdate);
-        RenderBuffer const& frontBuffer = buffers.at((currentBackBufferIndex + 1) % 2);
-        return RenderBufferRef(frontBuffer, readerLock);
-    }
+    /// Acquires the most recently published buffer for reading. May only be invoked by the reader thread.
+    RenderBufferRef frontBuffer() const;
 
     void clear() { backBuffer().clear(); }
 
-    // Swaps front with back buffer. May only be invoked by the writer thread.
-    bool swapBuffers(std::chrono::steady_clock::time_point now) noexcept;
+    /// Publishes the back buffer to the reader. May only be invoked by the writer thread.
+    ///
+    /// This never blocks and always succeeds.
+    void swapBuffers(std::chrono::steady_clock::time_point now) noexcept;
+
+  private:
+    // Marks the ready buffer as published by the writer but not yet picked up by the reader.
+    static constexpr uint8_t FreshBit = 0x04;
+    static constexpr uint8_t IndexMask = 0x03;
+
+    uint8_t _backBufferIndex = 0;
+    uint8_t mutable _frontBufferIndex = 1;
+    std::atomic<uint8_t> mutable _readyBufferIndex = 2;
+    std::mutex mutable _readerLock;
 };
 
 } // namespace vtbackend
@@ -109,7 +109,8 @@ RenderBufferBuilder<Cell>::RenderBufferBuilder(Terminal const& terminal,
                                                HighlightSearchMatches highlightSearchMatches,
                                                InputMethodData inputMethodData,
                                                optional<CellLocation> theCursorPosition,
-                                               bool includeSelection):
+                                               bool includeSelection,
+                                               RenderLineCache* lineCache):
     _output { &output },
     _terminal { &terminal },
     _cursorPosition { theCursorPosition },
@@ -117,12 +118,176 @@ RenderBufferBuilder<Cell>::RenderBufferBuilder(Terminal const& terminal,
     _reverseVideo { theReverseVideo },
     _highlightSearchMatches { highlightSearchMatches },
     _inputMethodData { std::move(inputMethodData) },
-    _includeSelection { includeSelection }
+    _includeSelection { includeSelection },
+    _lineCache { lineCache }
 {
     output.frameID = terminal.lastFrameID();
 
     if (_cursorPosition)
         output.cursor = renderCursor();
+
+    if (_lineCache)
+        prepareLineCache();
+}
+
+template <CellConcept Cell>
+RenderLineCache::Key RenderBufferBuilder<Cell>::makeLineCacheKey() const noexcept
+{
+    auto const& colors = _terminal->colorPalette();
+    return RenderLineCache::Key {
+        .primaryScreen = _terminal->isPrimaryScreen(),
+        .baseLine = _baseLine,
+        .pageSize = _terminal->pageSize(),
+        .reverseVideo = _reverseVideo,
+        .blinkState = _terminal->blinkState(),
+        .rapidBlinkState = _terminal->rapidBlinkState(),
+        .hoveringHyperlink = _terminal->hoveringHyperlinkId(),
+        .palette = colors.palette,
+        .defaultForeground = colors.defaultForeground,
+        .defaultBackground = colors.defaultBackground,
+        .defaultForegroundBright = colors.defaultForegroundBright,
+        .defaultForegroundDimmed = colors.defaultForegroundDimmed,
+        .useBrightColors = colors.useBrightColors,
+        .hyperlinkNormal = colors.hyperlinkDecoration.normal,
+        .hyperlinkHover = colors.hyperlinkDecoration.hover,
+    };
+}
+
+template <CellConcept Cell>
+void RenderBufferBuilder<Cell>::prepareLineCache()
+{
+    // Search matches, selections, and highlights are not reflected by the lines' generations,
+    // so all lines are rebuilt as long as any of them is present.
+    auto const cacheable = _terminal->search().pattern.empty()
+                           && !(_includeSelection && _terminal->selectionAvailable())
+                           && !_terminal->isHighlightActive();
+    auto const key = makeLineCacheKey();
+
+    if (!cacheable || _lineCache->key != key)
+    {
+        _lineCache->clear();
+        _output->allLinesDirty = true;
+    }
+
+    if (!cacheable)
+    {
+        _lineCache = nullptr;
+        return;
+    }
+
+    _lineCache->key = key;
+    std::swap(_lineCache->previousFrame, _lineCache->currentFrame);
+    _lineCache->previousFrame.resize(unbox<size_t>(key.pageSize.lines));
+    _lineCache->currentFrame.resize(unbox<size_t>(key.pageSize.lines));
+    for (auto& entry: _lineCache->currentFrame)
+    {
+        entry.generation = 0;
+        entry.cells.clear();
+        entry.codepoints.clear();
+        entry.images.clear();
+    }
+}
+
+template <CellConcept Cell>
+RenderLineCache::Entry* RenderBufferBuilder<Cell>::findCachedLine(uint64_t generation) noexcept
+{
+    for (auto& entry: _lineCache->previousFrame)
+        if (entry.generation == generation)
+            return &entry;
+    return nullptr;
+}
+
+template <CellConcept Cell>
+bool RenderBufferBuilder<Cell>::tryReuseLine(Line<Cell> const& line,
+                                             LineOffset lineOffset,
+                                             RenderPassHints& hints)
+{
+    _lineGeneration = 0;
+    _lineContainsBlinkingCells = false;
+
+    if (!_lineCache || line.dirtyGeneration() == 0 || lineContainsCursor(lineOffset))
+        return false;
+
+    _lineGeneration = line.dirtyGeneration();
+
+    // Trivial lines are cheap to render, so they are always rebuilt.
+    if (line.isTrivialBuffer())
+        return false;
+
+    auto* cachedLine = findCachedLine(_lineGeneration);
+    if (!cachedLine)
+        return false;
+
+    // The line may have moved to another screen line since, e.g. due to scrolling.
+    auto const lineDelta = lineOffset - cachedLine->lineOffset;
+    auto const codepointsOffset = static_cast<uint32_t>(_output->codepoints.size());
+    auto const imagesOffset = static_cast<uint32_t>(_output->images.size());
+    for (RenderCell const& cachedCell: cachedLine->cells)
+    {
+        auto& cell = _output->cells.emplace_back(cachedCell);
+        cell.position.line += lineDelta;
+        cell.codepointsOffset += codepointsOffset;
+        if (cell.imageIndex != RenderCell::NoImage)
+            cell.imageIndex += imagesOffset;
+    }
+    _output->codepoints.insert(
+        _output->codepoints.end(), cachedLine->codepoints.begin(), cachedLine->codepoints.end());
+    _output->images.insert(_output->images.end(), cachedLine->images.begin(), cachedLine->images.end());
+
+    if (lineDelta != LineOffset(0))
+        _output->dirtyLines.emplace_back(_baseLine + lineOffset);
+
+    hints.containsBlinkingCells = hints.containsBlinkingCells || cachedLine->containsBlinkingCells;
+
+    auto& entry = _lineCache->currentFrame[unbox<size_t>(lineOffset)];
+    std::swap(entry, *cachedLine);
+    entry.lineOffset = lineOffset;
+    cachedLine->generation = 0;
+    return true;
+}
+
+template <CellConcept Cell>
+void RenderBufferBuilder<Cell>::finishLine(LineOffset lineOffset, bool renderedAsLine)
+{
+    auto const row = unbox<size_t>(lineOffset);
+
+    // Lines rendered from the cache have been taken care of already, so an unmodified line
+    // can only be a trivial line that is rebuilt at the very same screen line.
+    auto const unchanged = _lineCache && _lineGeneration != 0 && renderedAsLine
+                           && _lineCache->previousFrame[row].generation == _lineGeneration;
+    if (!unchanged)
+        _output->dirtyLines.emplace_back(_baseLine + lineOffset);
+
+    if (!_lineCache || _lineGeneration == 0)
+        return;
+
+    auto& entry = _lineCache->currentFrame[row];
+    entry.generation = _lineGeneration;
+    entry.lineOffset = lineOffset;
+    entry.containsBlinkingCells = _lineContainsBlinkingCells;
+    if (renderedAsLine)
+    {
+        entry.cells.clear();
+        entry.codepoints.clear();
+        entry.images.clear();
+        return;
+    }
+
+    entry.cells.assign(std::next(_output->cells.begin(), static_cast<ptrdiff_t>(_lineFrontIndex)),
+                       _output->cells.end());
+    entry.codepoints.assign(
+        std::next(_output->codepoints.begin(), static_cast<ptrdiff_t>(_lineCodepointsFrontIndex)),
+        _output->codepoints.end());
+    entry.images.assign(std::next(_output->images.begin(), static_cast<ptrdiff_t>(_lineImagesFrontIndex)),
+                        _output->images.end());
+
+    // Make the cells refer to the entry's own codepoints and images.
+    for (RenderCell& cell: entry.cells)
+    {
+        cell.codepointsOffset -= static_cast<uint32_t>(_lineCodepointsFrontIndex);
+        if (cell.imageIndex != RenderCell::NoImage)
+            cell.imageIndex -= static_cast<uint32_t>(_lineImagesFrontIndex);
+    }
 }
 
 template <CellConcept Cell>
@@ -149,7 +314,7 @@ optional<RenderCursor> RenderBufferBuilder<Cell>::renderCursor() const
 
 template <CellConcept Cell>
 RenderCell RenderBufferBuilder<Cell>::makeRenderCellExplicit(ColorPalette const& colorPalette,
-                                                             u32string graphemeCluster,
+                                                             u32string_view graphemeCluster,
                                                              ColumnCount width,
                                                              CellFlags flags,
                                                              RGBColor fg,
@@ -166,7 +331,7 @@ RenderCell RenderBufferBuilder<Cell>::makeRenderCellExplicit(ColorPalette const&
     renderCell.position.line = line;
     renderCell.position.column = column;
     renderCell.width = unbox<uint8_t>(width);
-    renderCell.codepoints = std::move(graphemeCluster);
+    _output->appendCodepoints(renderCell, graphemeCluster);
     return renderCell;
 }
 
@@ -189,7 +354,7 @@ RenderCell RenderBufferBuilder<Cell>::makeRenderCellExplicit(ColorPalette const&
     renderCell.position.column = column;
     renderCell.width = 1;
     if (codepoint)
-        renderCell.codepoints.push_back(codepoint);
+        _output->appendCodepoints(renderCell, u32string_view(&codepoint, 1));
     return renderCell;
 }
 
@@ -213,11 +378,14 @@ RenderCell RenderBufferBuilder<Cell>::makeRenderCell(ColorPalette const& colorPa
 
     if (screenCell.codepointCount() != 0)
     {
+        renderCell.codepointsOffset = static_cast<uint32_t>(_output->codepoints.size());
+        renderCell.codepointCount = static_cast<uint32_t>(screenCell.codepointCount());
         for (size_t i = 0; i < screenCell.codepointCount(); ++i)
-            renderCell.codepoints.push_back(screenCell.codepoint(i));
+            _output->codepoints.push_back(screenCell.codepoint(i));
     }
 
-    renderCell.image = screenCell.imageFragment();
+    if (auto image = screenCell.imageFragment())
+        _output->setImage(renderCell, std::move(image));
 
     if (auto href = hyperlinks.hyperlinkById(screenCell.hyperlink()))
     {
@@ -321,6 +489,14 @@ bool RenderBufferBuilder<Cell>::gridLineContainsCursor(LineOffset lineOffset) co
     return false;
 }
 
+template <CellConcept Cell>
+bool RenderBufferBuilder<Cell>::lineContainsCursor(LineOffset lineOffset) const noexcept
+{
+    return gridLineContainsCursor(lineOffset)
+           || (_cursorPosition
+               && _terminal->viewport().translateGridToScreenCoordinate(_cursorPosition->line) == lineOffset);
+}
+
 template <CellConcept Cell>
 void RenderBufferBuilder<Cell>::renderTrivialLine(TrivialLineBuffer const& lineBuffer, LineOffset lineOffset)
 {
@@ -336,6 +512,11 @@ void RenderBufferBuilder<Cell>::renderTrivialLine(TrivialLineBuffer const& lineB
     _useCursorlineColoring = false;
 
     auto const frontIndex = _output->cells.size();
+    _lineFrontIndex = frontIndex;
+    _lineCodepointsFrontIndex = _output->codepoints.size();
+    _lineImagesFrontIndex = _output->images.size();
+    _lineContainsBlinkingCells = (lineBuffer.textAttributes.flags & CellFlag::Blinking)
+                                 || (lineBuffer.textAttributes.flags & CellFlag::RapidBlinking);
 
     // Visual selection can alter colors for some columns in this line.
     // In that case, it seems like we cannot just pass it bare over but have to take the slower path.
@@ -354,6 +535,7 @@ void RenderBufferBuilder<Cell>::renderTrivialLine(TrivialLineBuffer const& lineB
         _lineNr = lineOffset;
         _prevWidth = 0;
         _prevHasCursor = false;
+        finishLine(lineOffset, true);
         return;
     }
 
@@ -390,6 +572,8 @@ void RenderBufferBuilder<Cell>::renderTrivialLine(TrivialLineBuffer const& lineB
 
     _output->cells[frontIndex].groupStart = true;
     _output->cells[backIndex].groupEnd = true;
+
+    finishLine(lineOffset, false);
 }
 
 template <CellConcept Cell>
@@ -476,6 +660,9 @@ void RenderBufferBuilder<Cell>::startLine(LineOffset line) noexcept
     _lineNr = line;
     _prevWidth = 0;
     _prevHasCursor = false;
+    _lineFrontIndex = _output->cells.size();
+    _lineCodepointsFrontIndex = _output->codepoints.size();
+    _lineImagesFrontIndex = _output->images.size();
 
     _useCursorlineColoring = isCursorLine(line);
 }
@@ -492,12 +679,14 @@ bool RenderBufferBuilder<Cell>::isCursorLine(LineOffset line) const noexcept
 }
 
 template <CellConcept Cell>
-void RenderBufferBuilder<Cell>::endLine() noexcept
+void RenderBufferBuilder<Cell>::endLine()
 {
     if (!_output->cells.empty())
     {
         _output->cells.back().groupEnd = true;
     }
+
+    finishLine(_lineNr, false);
 }
 
 template <CellConcept Cell>
@@ -610,6 +799,8 @@ void RenderBufferBuilder<Cell>::renderCell(Cell const& screenCell, LineOffset li
 
     _prevWidth = screenCell.width();
     _prevHasCursor = _cursorPosition && gridPosition == *_cursorPosition;
+    _lineContainsBlinkingCells = _lineContainsBlinkingCells || (screenCell.flags() & CellFlag::Blinking)
+                                 || (screenCell.flags() & CellFlag::RapidBlinking);
 
     _output->cells.emplace_back(makeRenderCell(
         _terminal->colorPalette(), _terminal->hyperlinks(), screenCell, fg, bg, _baseLine + line, column));
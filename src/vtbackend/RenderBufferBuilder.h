@@ -16,6 +16,9 @@ namespace vtbackend
 
 /**
  * RenderBufferBuilder<Cell> renders the current screen state into a RenderBuffer.
+ *
+ * If a RenderLineCache is passed, only the lines that have been modified since the previous
+ * frame are rebuilt, and the render cells of all other lines are taken over from the cache.
  */
 template <CellConcept Cell>
 class RenderBufferBuilder
@@ -28,7 +31,16 @@ class RenderBufferBuilder
                         HighlightSearchMatches highlightSearchMatches,
                         InputMethodData inputMethodData,
                         std::optional<CellLocation> theCursorPosition,
-                        bool includeSelection);
+                        bool includeSelection,
+                        RenderLineCache* lineCache = nullptr);
+
+    /// Tries to render the given grid line from the line cache.
+    ///
+    /// This call is invoked for every line prior to rendering it.
+    ///
+    /// @returns true if the line has been rendered from the cache,
+    ///          false if it is to be rendered via renderTrivialLine() or renderCell().
+    bool tryReuseLine(Line<Cell> const& line, LineOffset lineOffset, RenderPassHints& hints);
 
     /// Renders a single grid cell.
     /// This call is guaranteed to be invoked sequencially, from top line
@@ -39,7 +51,7 @@ class RenderBufferBuilder
     /// @see renderTrivialLine
     void renderCell(Cell const& cell, LineOffset line, ColumnOffset column);
     void startLine(LineOffset line) noexcept;
-    void endLine() noexcept;
+    void endLine();
 
     /// Renders a trivial line.
     ///
@@ -59,33 +71,36 @@ class RenderBufferBuilder
 
     [[nodiscard]] std::optional<RenderCursor> renderCursor() const;
 
-    [[nodiscard]] static RenderCell makeRenderCellExplicit(ColorPalette const& colorPalette,
-                                                           std::u32string graphemeCluster,
-                                                           ColumnCount width,
-                                                           CellFlags flags,
-                                                           RGBColor fg,
-                                                           RGBColor bg,
-                                                           Color ul,
-                                                           LineOffset line,
-                                                           ColumnOffset column);
-
-    [[nodiscard]] static RenderCell makeRenderCellExplicit(ColorPalette const& colorPalette,
-                                                           char32_t codepoint,
-                                                           CellFlags flags,
-                                                           RGBColor fg,
-                                                           RGBColor bg,
-                                                           Color ul,
-                                                           LineOffset line,
-                                                           ColumnOffset column);
+    // The functions below construct a RenderCell and store its codepoints and image (if any)
+    // in the output render buffer.
+
+    [[nodiscard]] RenderCell makeRenderCellExplicit(ColorPalette const& colorPalette,
+                                                    std::u32string_view graphemeCluster,
+                                                    ColumnCount width,
+                                                    CellFlags flags,
+                                                    RGBColor fg,
+                                                    RGBColor bg,
+                                                    Color ul,
+                                                    LineOffset line,
+                                                    ColumnOffset column);
+
+    [[nodiscard]] RenderCell makeRenderCellExplicit(ColorPalette const& colorPalette,
+                                                    char32_t codepoint,
+                                                    CellFlags flags,
+                                                    RGBColor fg,
+                                                    RGBColor bg,
+                                                    Color ul,
+                                                    LineOffset line,
+                                                    ColumnOffset column);
 
     /// Constructs a RenderCell for the given screen Cell.
-    [[nodiscard]] static RenderCell makeRenderCell(ColorPalette const& colorPalette,
-                                                   HyperlinkStorage const& hyperlinks,
-                                                   Cell const& cell,
-                                                   RGBColor fg,
-                                                   RGBColor bg,
-                                                   LineOffset line,
-                                                   ColumnOffset column);
+    [[nodiscard]] RenderCell makeRenderCell(ColorPalette const& colorPalette,
+                                            HyperlinkStorage const& hyperlinks,
+                                            Cell const& cell,
+                                            RGBColor fg,
+                                            RGBColor bg,
+                                            LineOffset line,
+                                            ColumnOffset column);
 
     /// Constructs the final foreground/background colors to be displayed on the screen.
     ///
@@ -116,6 +131,17 @@ class RenderBufferBuilder
     /// on the given line offset.
     [[nodiscard]] bool gridLineContainsCursor(LineOffset screenLineOffset) const noexcept;
 
+    /// Tests if the given screen line offset contains the ANSI cursor or vi cursor.
+    /// Such lines are never taken from the line cache.
+    [[nodiscard]] bool lineContainsCursor(LineOffset screenLineOffset) const noexcept;
+
+    [[nodiscard]] RenderLineCache::Key makeLineCacheKey() const noexcept;
+    void prepareLineCache();
+    [[nodiscard]] RenderLineCache::Entry* findCachedLine(uint64_t generation) noexcept;
+
+    /// Records the line that has just been rendered into the dirty line set and the line cache.
+    void finishLine(LineOffset lineOffset, bool renderedAsLine);
+
     // clang-format off
     enum class State : uint8_t { Gap, Sequence };
     // clang-format on
@@ -137,6 +163,13 @@ class RenderBufferBuilder
 
     // Offset into the search pattern that has been already matched.
     size_t _searchPatternOffset = 0;
+
+    RenderLineCache* _lineCache;
+    uint64_t _lineGeneration = 0;  // Generation of the line being rendered, or zero if not to be cached.
+    size_t _lineFrontIndex = 0;    // Index of the first render cell of the line being rendered.
+    size_t _lineCodepointsFrontIndex = 0; // Index of the first codepoint of the line being rendered.
+    size_t _lineImagesFrontIndex = 0;     // Index of the first image of the line being rendered.
+    bool _lineContainsBlinkingCells = false;
 };
 
 } // namespace vtbackend
@@ -13,6 +13,7 @@
 #include <crispy/algorithm.h>
 #include <crispy/base64.h>
 #include <crispy/escape.h>
+#include <crispy/instrumentation.h>
 #include <crispy/size.h>
 #include <crispy/times.h>
 #include <crispy/utils.h>
@@ -32,6 +33,7 @@
 #include <string_view>
 #include <tuple>
 #include <type_traits>
+#include <utility>
 #include <variant>
 
 #if defined(_WIN32)
@@ -386,7 +388,7 @@ string_view Screen<Cell>::tryEmplaceChars(string_view chars, size_t cellCount) n
 
     if (_cursor.position.column.value == 0)
     {
-        if (currentLine().empty())
+        if (currentLine().isTrivialBuffer() && currentLine().empty())
         {
             auto const numberOfBytesEmplaced = emplaceCharsIntoCurrentLine(chars, cellCount);
             _terminal->currentPtyBuffer()->advanceHotEndUntil(chars.data() + numberOfBytesEmplaced);
@@ -396,7 +398,8 @@ string_view Screen<Cell>::tryEmplaceChars(string_view chars, size_t cellCount) n
         return chars;
     }
 
-    if (isContiguousToCurrentLine(chars))
+    if (isContiguousToCurrentLine(chars)
+        && currentLine().trivialBuffer().usedColumns == boxed_cast<ColumnCount>(_cursor.position.column))
     {
         // We can append the chars to a pre-existing non-empty line.
         assert(static_cast<int>(cellCount) <= columnsAvailable);
@@ -445,6 +448,70 @@ size_t Screen<Cell>::emplaceCharsIntoCurrentLine(string_view chars, size_t cellC
     return chars.size();
 }
 
+template <CellConcept Cell>
+bool Screen<Cell>::tryWriteTextBulk(string_view chars, size_t cellCount) noexcept
+{
+    // Only US-ASCII has a one-to-one mapping between bytes and cells.
+    if (chars.empty() || chars.size() != cellCount)
+        return false;
+
+    crlfIfWrapPending();
+
+    if (!unicode::grapheme_segmenter::breakable(_terminal->parser().precedingGraphicCharacter(),
+                                                static_cast<char32_t>(chars.front())))
+        return false;
+
+    bool const cursorInsideMargin =
+        _terminal->isModeEnabled(DECMode::LeftRightMargin) && isCursorInsideMargins();
+    auto const rightEdge = cursorInsideMargin ? margin().horizontal.to
+                                              : boxed_cast<ColumnOffset>(pageSize().columns - 1);
+    auto const startColumn = _cursor.position.column;
+    auto const lastColumn = startColumn + ColumnOffset::cast_from(cellCount - 1);
+    if (lastColumn > rightEdge)
+        return false;
+
+    auto& line = currentLine();
+    auto const cells = line.useRange(startColumn, ColumnCount::cast_from(cellCount));
+
+    // Writing into the right half of a wide character erases its left half.
+    if (cells.front().isFlagEnabled(CellFlag::WideCharContinuation) && startColumn > ColumnOffset(0))
+        line.useCellAt(startColumn - 1).reset(_cursor.graphicsRendition);
+
+    // Writing into the left half of a wide character erases its right half.
+    bool const erasesWideCharContinuation = cells.back().width() > 1 && lastColumn < rightEdge;
+
+    auto constexpr AsciiWidth = uint8_t { 1 };
+    auto const* input = chars.data();
+    for (Cell& cell: cells)
+        cell.write(_cursor.graphicsRendition,
+                   _cursor.charsets.map(static_cast<char32_t>(*input++)),
+                   AsciiWidth,
+                   _cursor.hyperlink);
+
+    if (erasesWideCharContinuation)
+        line.useCellAt(lastColumn + 1).reset(_cursor.graphicsRendition, _cursor.hyperlink);
+
+    _lastCursorPosition = CellLocation { .line = _cursor.position.line, .column = lastColumn };
+
+    if (lastColumn < rightEdge)
+        _cursor.position.column = lastColumn + 1;
+    else
+    {
+        _cursor.position.column = lastColumn;
+        if (_cursor.autoWrap)
+            _cursor.wrapPending = true;
+    }
+
+    auto const area = Rect { .top = unbox<Top>(_cursor.position.line),
+                             .left = unbox<Left>(startColumn),
+                             .bottom = unbox<Bottom>(_cursor.position.line),
+                             .right = unbox<Right>(lastColumn) };
+    _terminal->markRegionDirty(area);
+    _terminal->resetInstructionCounter();
+
+    return true;
+}
+
 template <CellConcept Cell>
 void Screen<Cell>::advanceCursorAfterWrite(ColumnCount n) noexcept
 {
@@ -456,13 +523,14 @@ void Screen<Cell>::advanceCursorAfterWrite(ColumnCount n) noexcept
     else
     {
         _cursor.position.column.value += n.value - 1;
-        _cursor.wrapPending = true;
+        _cursor.wrapPending = _cursor.autoWrap;
     }
 }
 
 template <CellConcept Cell>
 void Screen<Cell>::writeText(string_view text, size_t cellCount)
 {
+    CRISPY_INSTRUMENT_STAGE(write_text, text.size());
 #if defined(LIBTERMINAL_LOG_TRACE)
     if (vtTraceSequenceLog)
         vtTraceSequenceLog()(
@@ -481,6 +549,9 @@ void Screen<Cell>::writeText(string_view text, size_t cellCount)
     if (text.empty())
         return;
 
+    if (tryWriteTextBulk(text, cellCount))
+        return;
+
     // Making use of the optimized code path for the input characters did NOT work, so we need to first
     // convert UTF-8 to UTF-32 codepoints (reusing the logic in VT parser) and pass these codepoints
     // to the grapheme cluster processor.
@@ -531,6 +602,7 @@ void Screen<Cell>::crlfIfWrapPending()
 template <CellConcept Cell>
 void Screen<Cell>::writeText(char32_t codepoint)
 {
+    CRISPY_INSTRUMENT_STAGE(write_text, 0);
 #if defined(LIBTERMINAL_LOG_TRACE)
     if (vtTraceSequenceLog && _logCharTrace.load())
         _pendingCharTraceLog += unicode::convert_to<char>(codepoint);
@@ -3133,6 +3205,7 @@ namespace impl
 template <CellConcept Cell>
 void Screen<Cell>::executeControlCode(char controlCode)
 {
+    CRISPY_INSTRUMENT_STAGE(dispatch, 1);
 #if defined(LIBTERMINAL_LOG_TRACE)
     if (vtTraceSequenceLog)
         vtTraceSequenceLog()(
@@ -3207,10 +3280,11 @@ void Screen<Cell>::reply(std::string_view text)
 template <CellConcept Cell>
 void Screen<Cell>::processSequence(Sequence const& seq)
 {
+    CRISPY_INSTRUMENT_STAGE(dispatch, 0);
 #if defined(LIBTERMINAL_LOG_TRACE)
     if (vtTraceSequenceLog)
     {
-        if (auto const* fd = seq.functionDefinition(_terminal->activeSequences()))
+        if (auto const* fd = seq.functionDefinition(_terminal->supportedSequences()))
         {
             vtTraceSequenceLog()("[{}] Processing {:<14} {}", _name, fd->documentation.mnemonic, seq.text());
         }
@@ -3223,16 +3297,68 @@ void Screen<Cell>::processSequence(Sequence const& seq)
     //         seq.functionDefinition() ? seq.functionDefinition()->comment : ""sv);
 
     _terminal->incrementInstructionCounter();
-    if (Function const* funcSpec = seq.functionDefinition(_terminal->activeSequences()); funcSpec != nullptr)
+    if (Function const* funcSpec = seq.functionDefinition(_terminal->supportedSequences());
+        funcSpec != nullptr)
         applyAndLog(*funcSpec, seq);
     else if (vtParserLog)
         vtParserLog()("Unknown VT sequence: {}", seq);
 }
 
+template <CellConcept Cell>
+bool Screen<Cell>::processFastSequence(Sequence const& seq)
+{
+#if defined(LIBTERMINAL_LOG_TRACE)
+    if (vtTraceSequenceLog)
+        return false;
+#endif
+
+    // SGR, CUP, ED and EL are of the lowest conformance level and thus always supported.
+    auto const accepts = [&](Function const& function) {
+        return seq.parameterCount() <= function.maximumParameters;
+    };
+
+    CRISPY_INSTRUMENT_STAGE(dispatch, 0);
+    auto result = ApplyResult::Ok;
+    switch (seq.finalChar())
+    {
+        case 'm':
+            if (!accepts(SGR))
+                return false;
+            result = impl::applySGR(*this, seq, 0, seq.parameterCount());
+            break;
+        case 'H':
+            if (!accepts(CUP))
+                return false;
+            moveCursorTo(LineOffset::cast_from(seq.param_or<int>(0, 1) - 1),
+                         ColumnOffset::cast_from(seq.param_or<int>(1, 1) - 1));
+            break;
+        case 'J':
+            if (!accepts(ED))
+                return false;
+            result = apply(ED, seq);
+            break;
+        case 'K':
+            if (!accepts(EL))
+                return false;
+            result = impl::EL(seq, *this);
+            break;
+        default: return false;
+    }
+
+    _terminal->incrementInstructionCounter();
+    logApplyResult(result, seq);
+    return true;
+}
+
 template <CellConcept Cell>
 void Screen<Cell>::applyAndLog(Function const& function, Sequence const& seq)
 {
-    auto const result = apply(function, seq);
+    logApplyResult(apply(function, seq), seq);
+}
+
+template <CellConcept Cell>
+void Screen<Cell>::logApplyResult(ApplyResult result, Sequence const& seq)
+{
     switch (result)
     {
         case ApplyResult::Invalid: {
@@ -3831,18 +3957,27 @@ optional<CellLocation> Screen<Cell>::search(std::u32string_view searchText, Cell
         return nullopt;
 
     // First try match at start location.
-    if (_grid.lineAt(startPosition.line)
+    if (std::as_const(_grid)
+            .lineAt(startPosition.line)
             .matchTextAtWithSensetivityMode(searchText, startPosition.column, isCaseSensitive))
         return startPosition;
 
-    // Search reverse until found or exhausted.
-    auto const lines = _grid.logicalLinesFrom(startPosition.line);
-    for (auto const& line: lines)
+    // Search forward until found or exhausted, skipping history lines known not to contain the text.
+    auto range = _grid.nextSearchRange(searchText, startPosition.line);
+    while (!range.empty())
     {
-        auto const result = line.search(searchText, startPosition.column, isCaseSensitive);
-        if (result.has_value())
-            return result; // new match found
-        startPosition.column = ColumnOffset(0);
+        if (range.top != startPosition.line)
+            startPosition.column = ColumnOffset(0);
+        for (auto const& line: _grid.logicalLines(range))
+        {
+            auto const result = line.search(searchText, startPosition.column, isCaseSensitive);
+            if (result.has_value())
+                return result; // new match found
+            startPosition.column = ColumnOffset(0);
+        }
+        if (range.bottom >= boxed_cast<LineOffset>(pageSize().lines) - 1)
+            break;
+        range = _grid.nextSearchRange(searchText, range.bottom + 1);
     }
     return nullopt;
 }
@@ -3858,18 +3993,25 @@ optional<CellLocation> Screen<Cell>::searchReverse(std::u32string_view searchTex
         return nullopt;
 
     // First try match at start location.
-    if (_grid.lineAt(startPosition.line)
+    if (std::as_const(_grid)
+            .lineAt(startPosition.line)
             .matchTextAtWithSensetivityMode(searchText, startPosition.column, isCaseSensitive))
         return startPosition;
 
-    // Search reverse until found or exhausted.
-    auto const lines = _grid.logicalLinesReverseFrom(startPosition.line);
-    for (auto const& line: lines)
+    // Search reverse until found or exhausted, skipping history lines known not to contain the text.
+    auto const lastColumn = boxed_cast<ColumnOffset>(pageSize().columns) - 1;
+    for (auto range = _grid.previousSearchRange(searchText, startPosition.line); !range.empty();
+         range = _grid.previousSearchRange(searchText, range.top - 1))
     {
-        auto const result = line.searchReverse(searchText, startPosition.column, isCaseSensitive);
-        if (result.has_value())
-            return result; // new match found
-        startPosition.column = boxed_cast<ColumnOffset>(pageSize().columns) - 1;
+        if (range.bottom != startPosition.line)
+            startPosition.column = lastColumn;
+        for (auto const& line: _grid.logicalLinesReverse(range))
+        {
+            auto const result = line.searchReverse(searchText, startPosition.column, isCaseSensitive);
+            if (result.has_value())
+                return result; // new match found
+            startPosition.column = lastColumn;
+        }
     }
     return nullopt;
 }
@@ -161,6 +161,7 @@ class Screen final: public ScreenBase, public capabilities::StaticDatabase
     void writeTextEnd() override;
     void executeControlCode(char controlCode) override;
     void processSequence(Sequence const& seq) override;
+    bool processFastSequence(Sequence const& seq) override;
     // }}}
 
     void writeTextFromExternal(std::string_view text);
@@ -453,7 +454,7 @@ class Screen final: public ScreenBase, public capabilities::StaticDatabase
 
     void updateCursorIterator() noexcept override { _currentLine = &_grid.lineAt(_cursor.position.line); }
 
-    [[nodiscard]] Line<Cell>& currentLine() noexcept { return *_currentLine; }
+    [[nodiscard]] Line<Cell>& currentLine() noexcept { return _grid.markLineDirty(*_currentLine); }
 
     [[nodiscard]] Line<Cell> const& currentLine() const noexcept { return *_currentLine; }
 
@@ -528,8 +529,7 @@ class Screen final: public ScreenBase, public capabilities::StaticDatabase
 
     [[nodiscard]] CellFlags cellFlagsAt(CellLocation position) const noexcept override
     {
-        // TODO: This is not efficient. We should have a direct access to the flags.
-        return _grid.lineAt(position.line).inflatedBuffer().at(position.column.as<size_t>()).flags();
+        return _grid.lineAt(position.line).cellFlagsAt(position.column);
     }
 
     [[nodiscard]] LineFlags lineFlagsAt(LineOffset line) const noexcept override
@@ -580,6 +580,7 @@ class Screen final: public ScreenBase, public capabilities::StaticDatabase
     [[nodiscard]] std::shared_ptr<HyperlinkInfo const> hyperlinkAt(CellLocation pos) const noexcept override;
 
     void applyAndLog(Function const& function, Sequence const& seq);
+    void logApplyResult(ApplyResult result, Sequence const& seq);
     [[nodiscard]] ApplyResult apply(Function const& function, Sequence const& seq);
 
     void fail(std::string const& message) const override;
@@ -611,6 +612,12 @@ class Screen final: public ScreenBase, public capabilities::StaticDatabase
     /// @returns the string view of the UTF-8 text that could not be emplaced.
     std::string_view tryEmplaceChars(std::string_view chars, size_t cellCount) noexcept;
     size_t emplaceCharsIntoCurrentLine(std::string_view chars, size_t cellCount) noexcept;
+
+    /// Writes the given US-ASCII character sequence at the current cursor position into the
+    /// (possibly inflated) current line in one go, without decoding it again.
+    ///
+    /// @returns false if the input cannot be written in bulk and must be processed codepoint-wise.
+    bool tryWriteTextBulk(std::string_view chars, size_t cellCount) noexcept;
     [[nodiscard]] bool isContiguousToCurrentLine(std::string_view continuationChars) const noexcept;
     void advanceCursorAfterWrite(ColumnCount n) noexcept;
 
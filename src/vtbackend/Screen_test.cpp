@@ -290,6 +290,68 @@ TEST_CASE("writeText.bulk.H", "[screen]")
     CHECK(screen.cursor().position == CellLocation { LineOffset(1), ColumnOffset(9) });
 }
 
+// Text overwrites the middle of an inflated line.
+TEST_CASE("writeText.bulk.I", "[screen]")
+{
+    auto mock = MockTerm { PageSize { LineCount(2), ColumnCount(10) }, LineCount(1) };
+    auto& screen = mock.terminal.primaryScreen();
+    mock.writeToScreen("ABCDEFGHIJ");
+    mock.writeToScreen(CHA(3));
+    mock.writeToScreen("xyz");
+    logScreenText(screen, "final state");
+    CHECK(screen.grid().lineAt(LineOffset(0)).isInflatedBuffer());
+    CHECK(screen.grid().lineText(LineOffset(0)) == "ABxyzFGHIJ");
+    CHECK(screen.cursor().position == CellLocation { LineOffset(0), ColumnOffset(5) });
+}
+
+// Text starts in the right half and ends in the left half of wide characters.
+TEST_CASE("writeText.bulk.J", "[screen]")
+{
+    auto mock = MockTerm { PageSize { LineCount(2), ColumnCount(8) }, LineCount(1) };
+    auto& screen = mock.terminal.primaryScreen();
+    mock.writeToScreen(U"\U0001F600\U0001F600\U0001F600");
+
+    SECTION("right half at start")
+    {
+        mock.writeToScreen(CHA(2));
+        mock.writeToScreen("xyz");
+        CHECK(screen.grid().lineText(LineOffset(0)) == unicode::convert_to<char>(U" xyz\U0001F600  "sv));
+        CHECK(screen.cursor().position == CellLocation { LineOffset(0), ColumnOffset(4) });
+    }
+
+    SECTION("left half at end")
+    {
+        mock.writeToScreen(CHA(1));
+        mock.writeToScreen("xyz");
+        CHECK(screen.grid().lineText(LineOffset(0)) == unicode::convert_to<char>(U"xyz \U0001F600  "sv));
+        CHECK(screen.cursor().position == CellLocation { LineOffset(0), ColumnOffset(3) });
+    }
+}
+
+// Lines written left-to-right, up to the last column, stay in their trivial form.
+TEST_CASE("writeText.bulk.K", "[screen]")
+{
+    auto mock = MockTerm { PageSize { LineCount(3), ColumnCount(10) }, LineCount(5) };
+    auto& screen = mock.terminal.primaryScreen();
+    mock.writeToScreen("0123456789\r\n"
+                       "\033[31mabcdefghij\033[m\r\n"
+                       "ABCDEF");
+    CHECK(screen.grid().lineAt(LineOffset(0)).isTrivialBuffer());
+    CHECK(screen.grid().lineAt(LineOffset(1)).isTrivialBuffer());
+    CHECK(screen.grid().lineAt(LineOffset(2)).isTrivialBuffer());
+
+    // Read-only queries must not inflate the line.
+    CHECK(screen.cellWidthAt(CellLocation { LineOffset(2), ColumnOffset(6) }) == 1);
+    CHECK(screen.isCellEmpty(CellLocation { LineOffset(2), ColumnOffset(6) }));
+    CHECK(!screen.isCellEmpty(CellLocation { LineOffset(2), ColumnOffset(5) }));
+    CHECK(screen.grid().lineAt(LineOffset(2)).isTrivialBuffer());
+
+    mock.writeToScreen("\r\n");
+    CHECK(screen.grid().lineAt(LineOffset(-1)).isTrivialBuffer());
+    CHECK(screen.grid().lineAt(LineOffset(1)).isTrivialBuffer());
+    CHECK(screen.grid().lineText(LineOffset(1)) == "ABCDEF    ");
+}
+
 // TODO: Test spanning writes over all history and then reusing old lines.
 // Verify we do not leak any old cell attribs.
 
@@ -3744,6 +3806,32 @@ TEST_CASE("SGRSAVE and SGRRESTORE", "[screen]")
     REQUIRE(cursor.graphicsRendition.flags.contains(CellFlag::Underline));
 }
 
+TEST_CASE("FastSequence", "[screen]")
+{
+    auto mock = MockTerm { ColumnCount(8), LineCount(4) };
+    auto& cursor = mock.terminal.currentScreen().cursor();
+
+    mock.writeToScreen("\033[1;38:2::10:20:30;48;5;42m");
+    CHECK(cursor.graphicsRendition.foregroundColor == Color(RGBColor { 10, 20, 30 }));
+    CHECK(cursor.graphicsRendition.backgroundColor == Color(IndexedColor(42)));
+    CHECK(cursor.graphicsRendition.flags.contains(CellFlag::Bold));
+
+    mock.writeToScreen("\033[3;4H");
+    CHECK(cursor.position == CellLocation { LineOffset(2), ColumnOffset(3) });
+
+    // Too many parameters: not a CUP, and thus ignored, just like without the fast path.
+    mock.writeToScreen("\033[1;1;1H");
+    CHECK(cursor.position == CellLocation { LineOffset(2), ColumnOffset(3) });
+
+    // Sequences with leader or intermediate characters are not taken by the fast path.
+    mock.writeToScreen("\033[?1m");
+    CHECK(cursor.graphicsRendition.flags.contains(CellFlag::Bold));
+
+    mock.writeToScreen("\033[m");
+    CHECK(cursor.graphicsRendition.foregroundColor == DefaultColor());
+    CHECK(!cursor.graphicsRendition.flags.contains(CellFlag::Bold));
+}
+
 TEST_CASE("LS1 and LS0", "[screen]")
 {
     auto mock = MockTerm { ColumnCount(8), LineCount(4) };
@@ -3779,6 +3867,34 @@ TEST_CASE("LS1 and LS0", "[screen]")
     REQUIRE(trimmedTextScreenshot(mock) == "ab▒␉ab");
 }
 
+TEST_CASE("Screen.search.large_history", "[screen]")
+{
+    // Enough history lines for the search to skip most of them by means of the search index.
+    auto mock = MockTerm { PageSize { LineCount(4), ColumnCount(10) }, LineCount(2000) };
+    auto& screen = mock.terminal.primaryScreen();
+    mock.writeToScreen("needle\r\n");
+    for (auto i = 1; i <= 1500; ++i)
+        mock.writeToScreen(i == 700 ? "a needle\r\n"s : std::format("{:04}\r\n", i));
+
+    auto const top = -boxed_cast<LineOffset>(screen.historyLineCount());
+    auto const middle = top + LineOffset(700);
+
+    auto match = screen.searchReverse(U"needle", CellLocation { LineOffset(3), ColumnOffset(9) });
+    REQUIRE(match.has_value());
+    CHECK(*match == CellLocation { middle, ColumnOffset(2) });
+
+    match = screen.searchReverse(U"needle", CellLocation { middle - 1, ColumnOffset(9) });
+    REQUIRE(match.has_value());
+    CHECK(*match == CellLocation { top, ColumnOffset(0) });
+
+    match = screen.search(U"needle", CellLocation { top + 1, ColumnOffset(0) });
+    REQUIRE(match.has_value());
+    CHECK(*match == CellLocation { middle, ColumnOffset(2) });
+
+    CHECK(!screen.search(U"needle", CellLocation { middle + 1, ColumnOffset(0) }).has_value());
+    CHECK(!screen.search(U"haystack", CellLocation { top, ColumnOffset(0) }).has_value());
+}
+
 // TODO: Sixel: image that exceeds available lines
 
 // TODO: SetForegroundColor
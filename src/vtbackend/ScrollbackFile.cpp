@@ -0,0 +1,259 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtbackend/ScrollbackFile.h>
+
+#include <crispy/logstore.h>
+
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#if !defined(_WIN32)
+    #include <sys/mman.h>
+
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace vtbackend
+{
+
+namespace
+{
+    struct RecordHeader
+    {
+        uint32_t flags;
+        uint32_t displayWidth;
+        GraphicsAttributes fillAttributes;
+        uint32_t textSize;
+        uint32_t spanCount;
+        uint32_t layoutSize;
+    };
+
+    constexpr size_t RecordAlignment = 8;
+
+    static_assert(std::is_trivially_copyable_v<RecordHeader>);
+    static_assert(std::is_trivially_copyable_v<FrozenLineBuffer::Span>);
+    static_assert(alignof(RecordHeader) <= RecordAlignment);
+    static_assert(alignof(FrozenLineBuffer::Span) <= RecordAlignment);
+
+    constexpr size_t alignUp(size_t value) noexcept
+    {
+        return (value + RecordAlignment - 1) & ~(RecordAlignment - 1);
+    }
+
+    // Records are laid out as: header, spans, text, layout.
+    constexpr size_t SpansOffset = alignUp(sizeof(RecordHeader));
+
+    size_t recordSize(FrozenLineBuffer const& line) noexcept
+    {
+        return alignUp(SpansOffset + line.spans.size() * sizeof(FrozenLineBuffer::Span) + line.text.size()
+                       + line.layout.size());
+    }
+} // namespace
+
+FrozenLineBuffer SpilledLineView::toFrozenLineBuffer() const
+{
+    return FrozenLineBuffer {
+        .displayWidth = displayWidth,
+        .fillAttributes = fillAttributes,
+        .text = std::string(text),
+        .spans = std::vector<FrozenLineBuffer::Span>(spans.begin(), spans.end()),
+        .layout = std::vector<uint8_t>(layout.begin(), layout.end()),
+    };
+}
+
+bool SpilledLineView::matchesAt(size_t byteOffset,
+                                std::string_view needle,
+                                bool isCaseSensitive) const noexcept
+{
+    for (size_t i = 0; i < needle.size(); ++i)
+    {
+        auto ch = text[byteOffset + i];
+        if (!isCaseSensitive && 'A' <= ch && ch <= 'Z')
+            ch = static_cast<char>(ch - 'A' + 'a');
+        if (ch != needle[i])
+            return false;
+    }
+    return true;
+}
+
+ColumnOffset SpilledLineView::columnOf(size_t byteOffset) const noexcept
+{
+    // Counts the codepoints in front of the given offset, by skipping UTF-8 continuation bytes.
+    auto codepoints = size_t { 0 };
+    for (size_t i = 0; i < byteOffset; ++i)
+        if ((static_cast<uint8_t>(text[i]) & 0xC0) != 0x80)
+            ++codepoints;
+
+    if (layout.empty())
+        return ColumnOffset::cast_from(codepoints);
+
+    // Cells may hold any number of codepoints, including none.
+    auto column = size_t { 0 };
+    while (column < layout.size() && codepoints >= (layout[column] & 0x0Fu))
+        codepoints -= layout[column++] & 0x0Fu;
+    return ColumnOffset::cast_from(column);
+}
+
+std::optional<ColumnOffset> SpilledLineView::find(std::string_view needle,
+                                                  ColumnOffset from,
+                                                  bool isCaseSensitive) const noexcept
+{
+    if (needle.empty() || needle.size() > text.size())
+        return std::nullopt;
+
+    for (size_t i = 0; i <= text.size() - needle.size(); ++i)
+        if (matchesAt(i, needle, isCaseSensitive))
+            if (auto const column = columnOf(i); column >= from)
+                return column;
+    return std::nullopt;
+}
+
+std::optional<ColumnOffset> SpilledLineView::findReverse(std::string_view needle,
+                                                         ColumnOffset until,
+                                                         bool isCaseSensitive) const noexcept
+{
+    if (needle.empty() || needle.size() > text.size())
+        return std::nullopt;
+
+    for (auto i = text.size() - needle.size() + 1; i > 0; --i)
+        if (matchesAt(i - 1, needle, isCaseSensitive))
+            if (auto const column = columnOf(i - 1); column <= until)
+                return column;
+    return std::nullopt;
+}
+
+ScrollbackFile::ScrollbackFile(int fd, uint8_t* data, size_t sizeLimit) noexcept:
+    _fd { fd }, _data { data }, _sizeLimit { sizeLimit }
+{
+}
+
+ScrollbackFile::~ScrollbackFile()
+{
+#if !defined(_WIN32)
+    munmap(_data, _sizeLimit);
+    close(_fd);
+#endif
+}
+
+std::unique_ptr<ScrollbackFile> ScrollbackFile::create(size_t sizeLimit)
+{
+#if !defined(_WIN32)
+    sizeLimit = alignUp(sizeLimit);
+    if (sizeLimit == 0)
+        return nullptr;
+
+    auto ec = std::error_code {};
+    auto const directory = std::filesystem::temp_directory_path(ec);
+    if (ec)
+        return nullptr;
+
+    auto path = (directory / "contour-scrollback-XXXXXX").string();
+    auto const fd = mkstemp(path.data());
+    if (fd < 0)
+    {
+        errorLog()("Failed to create scrollback file {}. {}", path, strerror(errno));
+        return nullptr;
+    }
+
+    // The file is not needed to be accessible by name, and unlinking it right away
+    // ensures that it is removed once closed, even if the process terminates abnormally.
+    unlink(path.c_str());
+
+    if (ftruncate(fd, static_cast<off_t>(sizeLimit)) < 0)
+    {
+        errorLog()("Failed to resize scrollback file to {} bytes. {}", sizeLimit, strerror(errno));
+        close(fd);
+        return nullptr;
+    }
+
+    auto* data = mmap(nullptr, sizeLimit, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED)
+    {
+        errorLog()("Failed to memory-map scrollback file of {} bytes. {}", sizeLimit, strerror(errno));
+        close(fd);
+        return nullptr;
+    }
+
+    return std::unique_ptr<ScrollbackFile>(new ScrollbackFile(fd, static_cast<uint8_t*>(data), sizeLimit));
+#else
+    (void) sizeLimit;
+    return nullptr;
+#endif
+}
+
+void ScrollbackFile::append(LineFlags flags, FrozenLineBuffer const& line)
+{
+    auto const size = recordSize(line);
+    if (size > _sizeLimit)
+        return;
+
+    if (_writeOffset + size > _sizeLimit)
+    {
+        // Wrapping around leaves the tail behind the write offset unused, so the lines
+        // stored there are the oldest ones and must go first, before overwriting any others.
+        while (!_index.empty() && _index.front() >= _writeOffset)
+            _index.pop_front();
+        _writeOffset = 0;
+    }
+
+    // Drop the oldest lines that are about to be overwritten. Those are stored right
+    // at (or after) the write offset, since the file is filled in a ring-buffer fashion.
+    while (!_index.empty() && _index.front() >= _writeOffset && _index.front() < _writeOffset + size)
+        _index.pop_front();
+
+    auto const header = RecordHeader {
+        .flags = flags.value(),
+        .displayWidth = unbox<uint32_t>(line.displayWidth),
+        .fillAttributes = line.fillAttributes,
+        .textSize = static_cast<uint32_t>(line.text.size()),
+        .spanCount = static_cast<uint32_t>(line.spans.size()),
+        .layoutSize = static_cast<uint32_t>(line.layout.size()),
+    };
+
+    auto* record = _data + _writeOffset;
+    std::memcpy(record, &header, sizeof(header));
+    auto* out = record + SpansOffset;
+    if (!line.spans.empty())
+        std::memcpy(out, line.spans.data(), line.spans.size() * sizeof(FrozenLineBuffer::Span));
+    out += line.spans.size() * sizeof(FrozenLineBuffer::Span);
+    if (!line.text.empty())
+        std::memcpy(out, line.text.data(), line.text.size());
+    out += line.text.size();
+    if (!line.layout.empty())
+        std::memcpy(out, line.layout.data(), line.layout.size());
+
+    _index.push_back(_writeOffset);
+    _writeOffset += size;
+}
+
+SpilledLineView ScrollbackFile::at(size_t index) const noexcept
+{
+    auto const* record = _data + _index[_index.size() - 1 - index];
+
+    auto header = RecordHeader {};
+    std::memcpy(&header, record, sizeof(header));
+
+    auto const* spans = reinterpret_cast<FrozenLineBuffer::Span const*>(record + SpansOffset);
+    auto const* text = reinterpret_cast<char const*>(spans + header.spanCount);
+    auto const* layout = reinterpret_cast<uint8_t const*>(text + header.textSize);
+
+    return SpilledLineView {
+        .flags = LineFlags::from_value(static_cast<LineFlags::value_type>(header.flags)),
+        .displayWidth = ColumnCount::cast_from(header.displayWidth),
+        .fillAttributes = header.fillAttributes,
+        .text = std::string_view(text, header.textSize),
+        .spans = gsl::span(spans, header.spanCount),
+        .layout = gsl::span(layout, header.layoutSize),
+    };
+}
+
+void ScrollbackFile::clear() noexcept
+{
+    _index.clear();
+    _writeOffset = 0;
+}
+
+} // namespace vtbackend
@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <vtbackend/GraphicsAttributes.h>
+#include <vtbackend/Line.h>
+#include <vtbackend/primitives.h>
+
+#include <gsl/span>
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+namespace vtbackend
+{
+
+/// Read-only view of a line stored in a ScrollbackFile.
+///
+/// All members point directly into the memory-mapped file and remain valid
+/// until the next modification of the file.
+struct SpilledLineView
+{
+    LineFlags flags;
+    ColumnCount displayWidth;
+    GraphicsAttributes fillAttributes;
+    std::string_view text;
+    gsl::span<FrozenLineBuffer::Span const> spans;
+    gsl::span<uint8_t const> layout;
+
+    /// Copies the line out of the file.
+    [[nodiscard]] FrozenLineBuffer toFrozenLineBuffer() const;
+
+    /// Finds the given UTF-8 encoded text in place, without copying the line out of the file.
+    ///
+    /// If not case sensitive, the text is expected to be in lower case.
+    ///
+    /// @returns the column of the left-most match starting at or right of @p from.
+    [[nodiscard]] std::optional<ColumnOffset> find(std::string_view needle,
+                                                   ColumnOffset from,
+                                                   bool isCaseSensitive) const noexcept;
+
+    /// Same as find(), but returns the column of the right-most match starting at or left of @p until.
+    [[nodiscard]] std::optional<ColumnOffset> findReverse(std::string_view needle,
+                                                          ColumnOffset until,
+                                                          bool isCaseSensitive) const noexcept;
+
+  private:
+    [[nodiscard]] bool matchesAt(size_t byteOffset,
+                                 std::string_view needle,
+                                 bool isCaseSensitive) const noexcept;
+    [[nodiscard]] ColumnOffset columnOf(size_t byteOffset) const noexcept;
+};
+
+/**
+ * Out-of-core storage for history lines that fell off the top of a Grid's line ring.
+ *
+ * Lines are appended in their frozen form to a memory-mapped temporary file and indexed
+ * by their file offset. The file is unlinked right after creation, so that it is removed
+ * as soon as it is closed, be it on session close or on process termination.
+ *
+ * Once the size limit is reached, the file is reused in a ring-buffer fashion,
+ * dropping the oldest lines first.
+ */
+class ScrollbackFile
+{
+  public:
+    /// Creates a new scrollback file of at most @p sizeLimit bytes in the temporary directory.
+    ///
+    /// @returns nullptr if the file could not be created or memory-mapped,
+    ///          or if the platform does not support it.
+    static std::unique_ptr<ScrollbackFile> create(size_t sizeLimit);
+
+    ScrollbackFile(ScrollbackFile const&) = delete;
+    ScrollbackFile(ScrollbackFile&&) = delete;
+    ScrollbackFile& operator=(ScrollbackFile const&) = delete;
+    ScrollbackFile& operator=(ScrollbackFile&&) = delete;
+    ~ScrollbackFile();
+
+    /// Appends the given line as the most recent line.
+    void append(LineFlags flags, FrozenLineBuffer const& line);
+
+    /// Returns the line at the given @p index, with index 0 being the most recently appended line.
+    [[nodiscard]] SpilledLineView at(size_t index) const noexcept;
+
+    /// Number of lines currently stored.
+    [[nodiscard]] size_t size() const noexcept { return _index.size(); }
+    [[nodiscard]] bool empty() const noexcept { return _index.empty(); }
+
+    [[nodiscard]] size_t sizeLimit() const noexcept { return _sizeLimit; }
+
+    void clear() noexcept;
+
+  private:
+    ScrollbackFile(int fd, uint8_t* data, size_t sizeLimit) noexcept;
+
+    int _fd;
+    uint8_t* _data;
+    size_t _sizeLimit;
+    size_t _writeOffset = 0;
+
+    // File offsets of all stored lines, oldest first.
+    std::deque<size_t> _index;
+};
+
+} // namespace vtbackend
@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtbackend/SearchIndex.h>
+
+namespace vtbackend
+{
+
+// {{{ TrigramFilter
+size_t TrigramFilter::bitIndex(char32_t a, char32_t b, char32_t c) noexcept
+{
+    static_assert(BitCount == 1 << 12);
+
+    // Codepoints fit into 21 bits, so the trigram is mapped injectively before being hashed,
+    // taking the top bits of a multiplicative hash.
+    auto const trigram = (uint64_t(fold(a)) << 42) | (uint64_t(fold(b)) << 21) | uint64_t(fold(c));
+    return static_cast<size_t>((trigram * 0x9E3779B97F4A7C15ull) >> (64 - 12));
+}
+
+void TrigramFilter::insert(char32_t a, char32_t b, char32_t c) noexcept
+{
+    auto const i = bitIndex(a, b, c);
+    _bits[i / 64] |= uint64_t { 1 } << (i % 64);
+}
+
+void TrigramFilter::merge(TrigramFilter const& other) noexcept
+{
+    for (size_t i = 0; i < _bits.size(); ++i)
+        _bits[i] |= other._bits[i];
+}
+
+bool TrigramFilter::mayContain(std::u32string_view text) const noexcept
+{
+    for (size_t k = 2; k < text.size(); ++k)
+    {
+        auto const i = bitIndex(text[k - 2], text[k - 1], text[k]);
+        if (!(_bits[i / 64] & (uint64_t { 1 } << (i % 64))))
+            return false;
+    }
+    return true;
+}
+// }}}
+
+// {{{ TrigramCollector
+void TrigramCollector::push(char32_t codepoint) noexcept
+{
+    if (!codepoint)
+    {
+        _count = 0;
+        return;
+    }
+
+    if (_count >= 2)
+        _filter->insert(_previous[0], _previous[1], codepoint);
+
+    _previous[0] = _previous[1];
+    _previous[1] = codepoint;
+    ++_count;
+}
+// }}}
+
+// {{{ SearchIndex
+SearchIndex::Block& SearchIndex::block(int64_t number)
+{
+    if (_blocks.empty())
+        _firstBlock = number;
+
+    while (number < _firstBlock)
+    {
+        _blocks.emplace_front();
+        --_firstBlock;
+    }
+
+    while (number >= _firstBlock + static_cast<int64_t>(_blocks.size()))
+        _blocks.emplace_back();
+
+    return _blocks[static_cast<size_t>(number - _firstBlock)];
+}
+
+void SearchIndex::dropBlocksBefore(int64_t number)
+{
+    while (!_blocks.empty() && _firstBlock < number)
+    {
+        _blocks.pop_front();
+        ++_firstBlock;
+    }
+}
+
+void SearchIndex::clear() noexcept
+{
+    _blocks.clear();
+    _firstBlock = 0;
+}
+// }}}
+
+} // namespace vtbackend
@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string_view>
+
+namespace vtbackend
+{
+
+/**
+ * Bloom filter over the trigrams of consecutive cells' codepoints.
+ *
+ * Tells whether some text cannot be contained in the indexed cells,
+ * with false positives but without false negatives.
+ *
+ * Codepoints are case-folded the way the case insensitive search compares them,
+ * so that the same filter serves case sensitive and case insensitive searches.
+ */
+class TrigramFilter
+{
+  public:
+    static constexpr size_t BitCount = 4096;
+
+    [[nodiscard]] static constexpr char32_t fold(char32_t codepoint) noexcept
+    {
+        return U'A' <= codepoint && codepoint <= U'Z' ? codepoint + (U'a' - U'A') : codepoint;
+    }
+
+    void insert(char32_t a, char32_t b, char32_t c) noexcept;
+    void merge(TrigramFilter const& other) noexcept;
+
+    /// Tests whether all trigrams of the given text may be contained.
+    ///
+    /// Always true for texts shorter than three codepoints, as those have no trigrams.
+    [[nodiscard]] bool mayContain(std::u32string_view text) const noexcept;
+
+  private:
+    [[nodiscard]] static size_t bitIndex(char32_t a, char32_t b, char32_t c) noexcept;
+
+    std::array<uint64_t, BitCount / 64> _bits {};
+};
+
+/// Feeds the codepoints of consecutive cells into a TrigramFilter.
+class TrigramCollector
+{
+  public:
+    explicit TrigramCollector(TrigramFilter& filter) noexcept: _filter { &filter } {}
+
+    /// Adds the (first) codepoint of the next cell.
+    ///
+    /// Empty cells, passed as 0, never match any search text, so no trigram spans them.
+    void push(char32_t codepoint) noexcept;
+
+    /// Forgets the previous cells, e.g. at the beginning of a logical line.
+    void reset() noexcept { _count = 0; }
+
+  private:
+    TrigramFilter* _filter;
+    std::array<char32_t, 2> _previous {};
+    size_t _count = 0;
+};
+
+/**
+ * Trigram filters over fixed-size blocks of history lines, used to skip blocks of lines
+ * that cannot contain a search text.
+ *
+ * Blocks are addressed by absolute line numbers, which do not change while lines scroll
+ * through the history. The filters are built by the owning Grid the first time a search
+ * reaches a block, and are rebuilt once any of the block's lines has been modified since,
+ * which is detected by comparing the lines' generation numbers with the grid's generation
+ * number at the time the filter has been built.
+ */
+class SearchIndex
+{
+  public:
+    static constexpr int64_t BlockLineCount = 64;
+
+    struct Block
+    {
+        TrigramFilter filter;
+        bool built = false;
+        uint64_t generation = 0;
+    };
+
+    /// Returns the number of the block containing the given absolute line number.
+    [[nodiscard]] static constexpr int64_t blockNumber(int64_t lineNumber) noexcept
+    {
+        return lineNumber >= 0 ? lineNumber / BlockLineCount
+                               : -((-lineNumber + BlockLineCount - 1) / BlockLineCount);
+    }
+
+    /// Returns the given block, creating it (unbuilt) if needed.
+    [[nodiscard]] Block& block(int64_t number);
+
+    /// Drops all blocks before the given block number, e.g. as their lines fell off the history.
+    void dropBlocksBefore(int64_t number);
+
+    void clear() noexcept;
+
+    [[nodiscard]] size_t blockCount() const noexcept { return _blocks.size(); }
+
+  private:
+    std::deque<Block> _blocks;
+    int64_t _firstBlock = 0;
+};
+
+} // namespace vtbackend
@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtbackend/Grid.h>
+#include <vtbackend/SearchIndex.h>
+#include <vtbackend/cell/CellConfig.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <format>
+
+using namespace vtbackend;
+using namespace std::string_view_literals;
+
+// Default cell type for testing.
+using Cell = PrimaryScreenCell;
+
+namespace
+{
+
+auto constexpr HistoryLineCount = 998;
+
+/// Creates a grid whose lines read their absolute line numbers, with the page at lines 998 and 999.
+Grid<Cell> createNumberedGrid()
+{
+    auto grid = Grid<Cell>(PageSize { LineCount(2), ColumnCount(10) }, false, LineCount(1000));
+    for (auto i = 0; i < 1000; ++i)
+    {
+        if (i >= 2)
+            grid.scrollUp(LineCount(1));
+        grid.setLineText(LineOffset(std::min(i, 1)), std::format("{:04}", i));
+    }
+    return grid;
+}
+
+LineOffset offsetOf(int lineNumber)
+{
+    return LineOffset(lineNumber - HistoryLineCount);
+}
+
+} // namespace
+
+TEST_CASE("SearchIndex.TrigramFilter", "[search]")
+{
+    auto filter = TrigramFilter {};
+    auto collector = TrigramCollector { filter };
+    for (auto const ch: U"Hello, World"sv)
+        collector.push(ch);
+
+    CHECK(filter.mayContain(U"Hello"));
+    CHECK(filter.mayContain(U"hello")); // case insensitive search
+    CHECK(filter.mayContain(U"o, W"));
+    CHECK(filter.mayContain(U"Wo")); // no trigrams to test
+    CHECK(!filter.mayContain(U"Help"));
+    CHECK(!filter.mayContain(U"World!"));
+}
+
+TEST_CASE("SearchIndex.TrigramCollector.empty_cells", "[search]")
+{
+    auto filter = TrigramFilter {};
+    auto collector = TrigramCollector { filter };
+    for (auto const ch: U"ab"sv)
+        collector.push(ch);
+    collector.push(0);
+    collector.push(U'c');
+    collector.push(U'd');
+    collector.reset();
+    collector.push(U'e');
+
+    CHECK(!filter.mayContain(U"abc"));
+    CHECK(!filter.mayContain(U"bcd"));
+    CHECK(!filter.mayContain(U"cde"));
+
+    collector.push(U'f');
+    collector.push(U'g');
+    CHECK(filter.mayContain(U"efg"));
+}
+
+TEST_CASE("SearchIndex.blocks", "[search]")
+{
+    CHECK(SearchIndex::blockNumber(0) == 0);
+    CHECK(SearchIndex::blockNumber(SearchIndex::BlockLineCount - 1) == 0);
+    CHECK(SearchIndex::blockNumber(SearchIndex::BlockLineCount) == 1);
+    CHECK(SearchIndex::blockNumber(-1) == -1);
+    CHECK(SearchIndex::blockNumber(-SearchIndex::BlockLineCount) == -1);
+    CHECK(SearchIndex::blockNumber(-SearchIndex::BlockLineCount - 1) == -2);
+
+    auto index = SearchIndex {};
+    index.block(3).built = true;
+    (void) index.block(1);
+    CHECK(index.blockCount() == 3);
+    CHECK(index.block(3).built);
+    CHECK(!index.block(2).built);
+
+    index.dropBlocksBefore(3);
+    CHECK(index.blockCount() == 1);
+    CHECK(index.block(3).built);
+}
+
+TEST_CASE("Grid.nextSearchRange", "[search]")
+{
+    auto grid = createNumberedGrid();
+    grid.setLineText(offsetOf(500), "needle");
+
+    // Line 500 is in the block of lines [448, 512), and lines [960, 1000) are not indexed.
+    auto range = grid.nextSearchRange(U"needle", offsetOf(0));
+    CHECK(range.top == offsetOf(448));
+    CHECK(range.bottom == offsetOf(511));
+
+    range = grid.nextSearchRange(U"needle", offsetOf(512));
+    CHECK(range.top == offsetOf(960));
+    CHECK(range.bottom == offsetOf(999));
+
+    // Starting within the page, there is nothing to skip.
+    range = grid.nextSearchRange(U"needle", LineOffset(0));
+    CHECK(range.top == LineOffset(0));
+    CHECK(range.bottom == LineOffset(1));
+
+    // Modified lines are indexed again.
+    grid.setLineText(offsetOf(500), "hayhay");
+    grid.setLineText(offsetOf(10), "needle");
+    range = grid.nextSearchRange(U"needle", offsetOf(0));
+    CHECK(range.top == offsetOf(0));
+    CHECK(range.bottom == offsetOf(63));
+
+    range = grid.nextSearchRange(U"needle", offsetOf(64));
+    CHECK(range.top == offsetOf(960));
+}
+
+TEST_CASE("Grid.previousSearchRange", "[search]")
+{
+    auto grid = createNumberedGrid();
+    grid.setLineText(offsetOf(500), "needle");
+
+    auto range = grid.previousSearchRange(U"needle", LineOffset(1));
+    CHECK(range.top == offsetOf(960));
+    CHECK(range.bottom == LineOffset(1));
+
+    range = grid.previousSearchRange(U"needle", range.top - 1);
+    CHECK(range.top == offsetOf(448));
+    CHECK(range.bottom == offsetOf(511));
+
+    range = grid.previousSearchRange(U"needle", range.top - 1);
+    CHECK(range.empty());
+}
+
+TEST_CASE("Grid.searchRange.wrapped", "[search]")
+{
+    auto grid = createNumberedGrid();
+
+    // "needle" wrapped across lines 575 and 576, i.e. across the blocks [512, 576) and [576, 640).
+    grid.setLineText(offsetOf(575), "0575   nee");
+    grid.setLineText(offsetOf(576), "dle");
+    grid.lineAt(offsetOf(576)).setWrapped(true);
+
+    auto range = grid.nextSearchRange(U"needle", offsetOf(0));
+    CHECK(range.top == offsetOf(512));
+    CHECK(range.bottom == offsetOf(639));
+
+    range = grid.previousSearchRange(U"needle", offsetOf(959));
+    CHECK(range.top == offsetOf(512));
+    CHECK(range.bottom == offsetOf(639));
+}
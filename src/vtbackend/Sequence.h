@@ -261,6 +261,12 @@ class Sequence
         return select(selector(), availableDefinitions);
     }
 
+    [[nodiscard]] Function const* functionDefinition(
+        SupportedSequences const& supportedSequences) const noexcept
+    {
+        return supportedSequences.select(selector());
+    }
+
     /// Converts a FunctionSpinto a FunctionSelector, applicable for finding the corresponding
     /// FunctionDefinition.
     [[nodiscard]] FunctionSelector selector() const noexcept
@@ -364,6 +370,14 @@ class SequenceHandler
 
     virtual void executeControlCode(char controlCode) = 0;
     virtual void processSequence(Sequence const& sequence) = 0;
+
+    /// Processes a CSI sequence without leader and intermediate characters directly,
+    /// if it is one of the few very frequent ones (such as SGR), bypassing the function selection.
+    ///
+    /// @retval true the sequence has been processed.
+    /// @retval false the sequence must be processed via processSequence() instead.
+    virtual bool processFastSequence(Sequence const& /*sequence*/) { return false; }
+
     virtual void writeText(char32_t codepoint) = 0;
     virtual void writeText(std::string_view codepoints, size_t cellCount) = 0;
     virtual void writeTextEnd() = 0;
@@ -378,4 +392,11 @@ concept SequenceHandlerConcept = requires(T t) {
     { t.writeTextEnd() } -> std::same_as<void>;
 };
 
+/// Sequence handlers that provide a fast path for very frequent sequences,
+/// see SequenceHandler::processFastSequence().
+template <typename T>
+concept FastSequenceHandlerConcept = requires(T t) {
+    { t.processFastSequence(Sequence {}) } -> std::same_as<bool>;
+};
+
 } // namespace vtbackend
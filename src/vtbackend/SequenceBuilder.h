@@ -116,6 +116,19 @@ class SequenceBuilder
     {
         _sequence.setCategory(FunctionCategory::CSI);
         _sequence.setFinalChar(finalChar);
+
+        if constexpr (FastSequenceHandlerConcept<Handler>)
+        {
+            if (!_sequence.leaderSymbol() && _sequence.intermediateCharacters().empty())
+            {
+                _parameterBuilder.fixiate();
+                if (_handler.processFastSequence(_sequence))
+                    return;
+                _handler.processSequence(_sequence);
+                return;
+            }
+        }
+
         handleSequence();
     }
 
@@ -45,6 +45,11 @@ struct Settings
     PageSize pageSize = PageSize { LineCount(25), ColumnCount(80) };
 
     MaxHistoryLineCount maxHistoryLineCount;
+
+    // Maximum size in bytes of the file that lines falling off the top of the history are spilled into.
+    // A value of 0 disables spilling history lines to disk.
+    size_t historySpillFileSizeLimit = 0;
+
     ImageSize maxImageSize { Width(800), Height(600) };
     unsigned maxImageRegisterCount = 256;
     StatusDisplayType statusDisplayType = StatusDisplayType::None;
@@ -126,6 +126,9 @@ std::optional<StatusLineDefinitions::Item> makeStatusLineItem(
     if (interpolation.name == "InputMode")
         return StatusLineDefinitions::InputMode { styles };
 
+    if (interpolation.name == "Latency")
+        return StatusLineDefinitions::Latency { styles };
+
     if (interpolation.name == "ProtectedMode")
         return StatusLineDefinitions::ProtectedMode { styles };
 
@@ -371,6 +374,8 @@ struct VTSerializer
         return std::string(modeString(vt.inputHandler().mode()));
     }
 
+    std::string visit(StatusLineDefinitions::Latency const&) { return vt.latencyTelemetry().statusText(); }
+
     std::string visit(StatusLineDefinitions::ProtectedMode const&)
     {
         if (vt.allowInput())
@@ -32,6 +32,7 @@ namespace StatusLineDefinitions
     struct HistoryLineCount: Styles {};
     struct Hyperlink: Styles {};
     struct InputMode: Styles {};
+    struct Latency: Styles {};
     struct ProtectedMode: Styles {};
     struct SearchMode: Styles {};
     struct SearchPrompt: Styles {};
@@ -55,6 +56,7 @@ namespace StatusLineDefinitions
         HistoryLineCount,
         Hyperlink,
         InputMode,
+        Latency,
         ProtectedMode,
         SearchMode,
         SearchPrompt,
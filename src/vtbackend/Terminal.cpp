@@ -15,6 +15,7 @@
 
 #include <crispy/assert.h>
 #include <crispy/escape.h>
+#include <crispy/instrumentation.h>
 #include <crispy/utils.h>
 
 #include <libunicode/convert.h>
@@ -23,6 +24,8 @@
 
 #include <sys/types.h>
 
+#include <algorithm>
+#include <cctype>
 #include <chrono>
 #include <cstdlib>
 #include <format>
@@ -52,22 +55,34 @@ namespace // {{{ helpers
 {
     constexpr size_t MaxColorPaletteSaveStackSize = 10;
 
+    // Size of the buffer objects that text is relocated into when compacting PTY buffers.
+    constexpr size_t HistoryTextBufferSize = 64 * 1024;
+
+    // Minimum time between two compactions of PTY buffers.
+    constexpr auto PtyBufferCompactionInterval = std::chrono::seconds(1);
+
     void trimSpaceRight(string& value)
     {
         while (!value.empty() && value.back() == ' ')
             value.pop_back();
     }
 
+    // Searching is case sensitive as soon as the search text contains an upper case letter.
+    bool isCaseSensitiveSearch(u32string_view text) noexcept
+    {
+        auto const isUpper = [](char32_t ch) {
+            return ch < 0x80 && std::isupper(static_cast<int>(ch));
+        };
+        return std::ranges::any_of(text, isUpper);
+    }
+
 #if defined(CONTOUR_PERF_STATS)
-    void logRenderBufferSwap(bool success, uint64_t frameID)
+    void logRenderBufferSwap(uint64_t frameID)
     {
         if (!renderBufferLog)
             return;
 
-        if (success)
-            renderBufferLog()("Render buffer {} swapped.", frameID);
-        else
-            renderBufferLog()("Render buffer {} swapping failed.", frameID);
+        renderBufferLog()("Render buffer {} swapped.", frameID);
     }
 #endif
 
@@ -108,6 +123,8 @@ Terminal::Terminal(Events& eventListener,
     _currentTime { now },
     _ptyBufferPool { crispy::nextPowerOfTwo(_settings.ptyBufferObjectSize) },
     _currentPtyBuffer { _ptyBufferPool.allocateBufferObject() },
+    _historyTextPool { HistoryTextBufferSize },
+    _historyTextCompactor { _historyTextPool },
     _ptyReadBufferSize { crispy::nextPowerOfTwo(_settings.ptyReadBufferSize) },
     _pty { std::move(pty) },
     _lastCursorBlink { now },
@@ -173,6 +190,7 @@ Terminal::Terminal(Events& eventListener,
     setMode(DECMode::SixelCursorNextToGraphic, true);
     setMode(DECMode::TextReflow, _settings.primaryScreen.allowReflowOnResize);
     setMode(DECMode::Unicode, true);
+    setHistorySpillFileSizeLimit(_settings.historySpillFileSizeLimit);
     setMode(DECMode::VisibleCursor, true);
     setMode(DECMode::LeftRightMargin, false);
 
@@ -200,16 +218,20 @@ void Terminal::setLastMarkRangeOffset(LineOffset value) noexcept
     _settings.copyLastMarkRangeOffset = value;
 }
 
-std::optional<vtpty::Pty::ReadResult> Terminal::readFromPty()
+std::optional<std::chrono::milliseconds> Terminal::blockingReadTimeout() const noexcept
 {
-    auto const timeout =
 #if defined(LIBTERMINAL_PASSIVE_RENDER_BUFFER_UPDATE)
-        (_renderBuffer.state == RenderBufferState::WaitingForRefresh && !_screenDirty)
-            ? std::optional { _refreshInterval.value }
-            : std::chrono::milliseconds(0);
+    if (_renderBuffer.state == RenderBufferState::WaitingForRefresh && !_screenDirty)
+        return _refreshInterval.value;
+    return std::chrono::milliseconds(0);
 #else
-        std::optional<std::chrono::milliseconds> { std::nullopt };
+    return std::nullopt;
 #endif
+}
+
+std::optional<vtpty::Pty::ReadResult> Terminal::readFromPty(bool nonBlocking)
+{
+    auto const timeout = nonBlocking ? std::optional { std::chrono::milliseconds(0) } : blockingReadTimeout();
 
     // Request a new Buffer Object if the current one cannot sufficiently
     // store a single text line.
@@ -218,12 +240,48 @@ std::optional<vtpty::Pty::ReadResult> Terminal::readFromPty()
         if (vtpty::ptyInLog)
             vtpty::ptyInLog()("Only {} bytes left in TBO. Allocating new buffer from pool.",
                               _currentPtyBuffer->bytesAvailable());
-        _currentPtyBuffer = _ptyBufferPool.allocateBufferObject();
+        allocatePtyBuffer();
     }
 
     return _pty->read(*_currentPtyBuffer, timeout, _ptyReadBufferSize);
 }
 
+void Terminal::allocatePtyBuffer()
+{
+    _currentPtyBuffer = _ptyBufferPool.allocateBufferObject();
+
+    // Compaction needs to visit every line, so only do it once retired buffer objects
+    // became mostly unreferenced, and not too often.
+    auto const now = std::chrono::steady_clock::now();
+    if (now - _lastPtyBufferCompaction < PtyBufferCompactionInterval)
+        return;
+
+    auto const statistics = _ptyBufferPool.statistics();
+    if (statistics.liveBytes * 2 >= statistics.usedBytes)
+        return;
+
+    _lastPtyBufferCompaction = now;
+
+    // Buffer objects emptied by the previous compaction are only freed now, as render buffers
+    // that have been built before may still be referring to their contents.
+    _ptyBufferPool.releaseUnusedBuffers();
+    _historyTextPool.releaseUnusedBuffers();
+
+    auto const _ = std::lock_guard { *this };
+    auto const lineCount = compactPtyBuffers();
+    terminalLog()("Relocated text of {} lines out of sparse PTY buffers ({} live of {} used bytes).",
+                  lineCount,
+                  statistics.liveBytes,
+                  statistics.usedBytes);
+}
+
+size_t Terminal::compactPtyBuffers()
+{
+    _historyTextCompactor.exclude(_currentPtyBuffer.get());
+    return _primaryScreen.grid().compactText(_historyTextCompactor)
+           + _alternateScreen.grid().compactText(_historyTextCompactor);
+}
+
 void Terminal::setExecutionMode(ExecutionMode mode)
 {
     auto _ = std::unique_lock(_breakMutex);
@@ -233,6 +291,28 @@ void Terminal::setExecutionMode(ExecutionMode mode)
 }
 
 bool Terminal::processInputOnce()
+{
+    return processInput(false) != InputStatus::Closed;
+}
+
+bool Terminal::processAvailableInput()
+{
+    // Bounds the time spent per dispatch, so that other sessions get their turn, too.
+    constexpr auto MaxReadsPerDispatch = 16;
+
+    for (auto i = 0; i < MaxReadsPerDispatch; ++i)
+    {
+        switch (processInput(true))
+        {
+            case InputStatus::Processed: break;
+            case InputStatus::Idle: return true;
+            case InputStatus::Closed: return false;
+        }
+    }
+    return true;
+}
+
+Terminal::InputStatus Terminal::processInput(bool nonBlocking)
 {
     // clang-format off
     switch (_executionMode.load())
@@ -245,14 +325,21 @@ bool Terminal::processInputOnce()
             {
                 auto const _ = std::lock_guard { *this };
                 _traceHandler.flushAllPending();
-                return true;
+                return InputStatus::Processed;
             }
             break;
         case ExecutionMode::Waiting:
         {
             auto lock = std::unique_lock(_breakMutex);
-            _breakCondition.wait(lock, [this]() { return _executionMode != ExecutionMode::Waiting; });
-            return true;
+            auto const resumed = [this]() { return _executionMode != ExecutionMode::Waiting; };
+            if (!nonBlocking)
+            {
+                _breakCondition.wait(lock, resumed);
+                return InputStatus::Processed;
+            }
+            // Do not hold on to a shared worker for longer than a frame.
+            return _breakCondition.wait_for(lock, _refreshInterval.value, resumed) ? InputStatus::Processed
+                                                                                   : InputStatus::Idle;
         }
         case ExecutionMode::SingleStep:
             if (!_traceHandler.pendingSequences().empty())
@@ -260,22 +347,22 @@ bool Terminal::processInputOnce()
                 auto const _ = std::lock_guard { *this };
                 _executionMode = ExecutionMode::Waiting;
                 _traceHandler.flushOne();
-                return true;
+                return InputStatus::Processed;
             }
             break;
     }
     // clang-format on
 
-    auto const readResult = readFromPty();
+    auto const readResult = readFromPty(nonBlocking);
 
     if (!readResult)
     {
         terminalLog()("PTY read failed. {}", strerror(errno));
         if (errno == EINTR || errno == EAGAIN)
-            return true;
+            return InputStatus::Idle;
 
         _pty->close();
-        return false;
+        return InputStatus::Closed;
     }
     string_view const buf = readResult->data;
     _usingStdoutFastPipe = readResult->fromStdoutFastPipe;
@@ -284,13 +371,15 @@ bool Terminal::processInputOnce()
     {
         terminalLog()("PTY read returned with zero bytes. Closing PTY.");
         _pty->close();
-        return false;
+        return InputStatus::Closed;
     }
 
     {
         auto const _ = std::lock_guard { *this };
+        CRISPY_INSTRUMENT_STAGE(parser, buf.size());
         _parser.parseFragment(buf);
     }
+    _latencyTelemetry.ptyDataReceived(std::chrono::steady_clock::now());
 
     if (!_modes.enabled(DECMode::BatchedRendering))
         screenUpdated();
@@ -299,7 +388,7 @@ bool Terminal::processInputOnce()
     ensureFreshRenderBuffer();
 #endif
 
-    return true;
+    return InputStatus::Processed;
 }
 
 // {{{ RenderBuffer synchronization
@@ -342,30 +431,33 @@ bool Terminal::ensureFreshRenderBuffer(bool locked)
             [[fallthrough]];
         case RenderBufferState::RefreshBuffersAndTrySwap: {
             auto& backBuffer = _renderBuffer.backBuffer();
-            auto const lastCursorPos = backBuffer.cursor;
+            auto const refreshStart = std::chrono::steady_clock::now();
             if (!locked)
-                fillRenderBuffer(_renderBuffer.backBuffer(), true);
+                fillRenderBuffer(backBuffer, true);
             else
-                fillRenderBufferInternal(_renderBuffer.backBuffer(), true);
-            auto const cursorChanged =
-                lastCursorPos.has_value() != backBuffer.cursor.has_value()
-                || (backBuffer.cursor.has_value() && backBuffer.cursor->position != lastCursorPos->position);
-            if (cursorChanged)
+                fillRenderBufferInternal(backBuffer, true);
+            _latencyTelemetry.renderBufferRefreshed(refreshStart, std::chrono::steady_clock::now());
+            auto const cursorPosition = backBuffer.cursor.has_value()
+                                            ? std::optional { backBuffer.cursor->position }
+                                            : std::nullopt;
+            if (cursorPosition != _lastRenderedCursorPosition)
+            {
+                _lastRenderedCursorPosition = cursorPosition;
                 _eventListener.cursorPositionChanged();
+            }
             _renderBuffer.state = RenderBufferState::TrySwapBuffers;
             [[fallthrough]];
         }
         case RenderBufferState::TrySwapBuffers: {
-            [[maybe_unused]] auto const success = _renderBuffer.swapBuffers(_currentTime);
+            _renderBuffer.swapBuffers(_currentTime);
 
 #if defined(CONTOUR_PERF_STATS)
-            logRenderBufferSwap(success, _lastFrameID);
+            logRenderBufferSwap(_lastFrameID);
 #endif
 
 #if defined(LIBTERMINAL_PASSIVE_RENDER_BUFFER_UPDATE)
             // Passively invoked by the terminal thread -> do inform render thread about updates.
-            if (success)
-                _eventListener.renderBufferUpdated();
+            _eventListener.renderBufferUpdated();
 #endif
         }
         break;
@@ -438,6 +530,7 @@ void Terminal::fillRenderBuffer(RenderBuffer& output, bool includeSelection)
 
 void Terminal::fillRenderBufferInternal(RenderBuffer& output, bool includeSelection)
 {
+    CRISPY_INSTRUMENT_STAGE(render_buffer, 0);
     verifyState();
 
     output.clear();
@@ -472,6 +565,10 @@ void Terminal::fillRenderBufferInternal(RenderBuffer& output, bool includeSelect
     }();
 
     if (isPrimaryScreen())
+    {
+        // Spilled lines are only kept in memory for as long as they are being displayed.
+        _primaryScreen.grid().recallSpilledLines(-boxed_cast<LineOffset>(_viewport.scrollOffset()),
+                                                 pageSize().lines);
         _lastRenderPassHints =
             _primaryScreen.render(RenderBufferBuilder<PrimaryScreenCell> { *this,
                                                                            output,
@@ -480,9 +577,11 @@ void Terminal::fillRenderBufferInternal(RenderBuffer& output, bool includeSelect
                                                                            HighlightSearchMatches::Yes,
                                                                            _inputMethodData,
                                                                            theCursorPosition,
-                                                                           includeSelection },
+                                                                           includeSelection,
+                                                                           &_renderLineCache },
                                   _viewport.scrollOffset(),
                                   highlightSearchMatches);
+    }
     else
         _lastRenderPassHints =
             _alternateScreen.render(RenderBufferBuilder<AlternateScreenCell> { *this,
@@ -492,7 +591,8 @@ void Terminal::fillRenderBufferInternal(RenderBuffer& output, bool includeSelect
                                                                                HighlightSearchMatches::Yes,
                                                                                _inputMethodData,
                                                                                theCursorPosition,
-                                                                               includeSelection },
+                                                                               includeSelection,
+                                                                               &_renderLineCache },
                                     _viewport.scrollOffset(),
                                     highlightSearchMatches);
 
@@ -1045,6 +1145,7 @@ void Terminal::writeToScreen(string_view vtStream)
             auto const chunk =
                 vtStream.substr(0, std::min(vtStream.size(), _currentPtyBuffer->bytesAvailable()));
             vtStream.remove_prefix(chunk.size());
+            CRISPY_INSTRUMENT_STAGE(parser, chunk.size());
             _parser.parseFragment(_currentPtyBuffer->writeAtEnd(chunk));
         }
     }
@@ -1068,15 +1169,15 @@ string_view Terminal::lockedWriteToPtyBuffer(string_view data)
 
 size_t Terminal::maxBulkTextSequenceWidth() const noexcept
 {
-    if (!isPrimaryScreen())
-        return 0;
-
-    if (!_primaryScreen.currentLine().isTrivialBuffer())
+    // Bulk text is accepted for trivial as well as inflated lines on either screen.
+    // The screen decides how to write it (see Screen::tryEmplaceChars() and Screen::tryWriteTextBulk()).
+    // The right margin is inclusive, so that text filling the line up to the very last column
+    // can be emplaced in one go, too (keeping the line in its trivial form).
+    auto const column = _currentScreen->cursor().position.column;
+    if (_mainScreenMargin.horizontal.to < column)
         return 0;
 
-    assert(_mainScreenMargin.horizontal.to >= _currentScreen->cursor().position.column);
-
-    return unbox<size_t>(_mainScreenMargin.horizontal.to - _currentScreen->cursor().position.column);
+    return unbox<size_t>(_mainScreenMargin.horizontal.to - column) + 1;
 }
 
 // {{{ SimpleSequenceHandler
@@ -2111,6 +2212,15 @@ LineCount Terminal::maxHistoryLineCount() const noexcept
     return _primaryScreen.grid().maxHistoryLineCount();
 }
 
+void Terminal::setHistorySpillFileSizeLimit(size_t bytes)
+{
+    auto& grid = _primaryScreen.grid();
+    if (bytes == (grid.spillFile() ? grid.spillFile()->sizeLimit() : 0))
+        return;
+
+    grid.setSpillFile(bytes != 0 ? ScrollbackFile::create(bytes) : nullptr);
+}
+
 void Terminal::setTerminalId(VTType id) noexcept
 {
     _terminalId = id;
@@ -2220,7 +2330,21 @@ optional<CellLocation> Terminal::searchReverse(u32string text, CellLocation sear
 optional<CellLocation> Terminal::search(CellLocation searchPosition)
 {
     auto const searchText = u32string_view(_search.pattern);
-    auto const matchLocation = currentScreen().search(searchText, searchPosition);
+    auto matchLocation = optional<CellLocation> {};
+
+    // Start with the lines that have been spilled out of the history, if starting there.
+    if (isPrimaryScreen() && !searchText.empty()
+        && searchPosition.line < -boxed_cast<LineOffset>(_primaryScreen.historyLineCount()))
+    {
+        auto const _ = std::lock_guard { *this };
+        matchLocation = _primaryScreen.grid().searchSpilledLines(
+            searchText, searchPosition, isCaseSensitiveSearch(searchText));
+        searchPosition = CellLocation { .line = -boxed_cast<LineOffset>(_primaryScreen.historyLineCount()),
+                                        .column = ColumnOffset(0) };
+    }
+
+    if (!matchLocation)
+        matchLocation = currentScreen().search(searchText, searchPosition);
 
     if (matchLocation)
         viewport().makeVisibleWithinSafeArea(matchLocation.value().line);
@@ -2261,6 +2385,9 @@ void Terminal::clearSearch()
 {
     _search.pattern.clear();
     _search.initiatedByDoubleClick = false;
+
+    // Searching may have thawed large parts of the history.
+    _primaryScreen.grid().freezeHistory();
 }
 
 bool Terminal::wordDelimited(CellLocation position) const noexcept
@@ -2299,7 +2426,19 @@ std::tuple<std::u32string, CellLocationRange> Terminal::extractWordUnderCursor(
 optional<CellLocation> Terminal::searchReverse(CellLocation searchPosition)
 {
     auto const searchText = u32string_view(_search.pattern);
-    auto const matchLocation = currentScreen().searchReverse(searchText, searchPosition);
+    auto matchLocation = currentScreen().searchReverse(searchText, searchPosition);
+
+    // Continue with the lines that have been spilled out of the history, if any.
+    if (!matchLocation && isPrimaryScreen() && !searchText.empty())
+    {
+        auto const _ = std::lock_guard { *this };
+        auto const historyTop = -boxed_cast<LineOffset>(_primaryScreen.historyLineCount());
+        if (searchPosition.line >= historyTop)
+            searchPosition = CellLocation { .line = historyTop - 1,
+                                            .column = boxed_cast<ColumnOffset>(pageSize().columns) - 1 };
+        matchLocation = _primaryScreen.grid().searchSpilledLinesReverse(
+            searchText, searchPosition, isCaseSensitiveSearch(searchText));
+    }
 
     if (matchLocation)
         viewport().makeVisibleWithinSafeArea(matchLocation.value().line);
@@ -2486,7 +2625,7 @@ void TraceHandler::flushOne(PendingSequence const& pendingSequence)
 {
     if (auto const* seq = std::get_if<Sequence>(&pendingSequence))
     {
-        if (auto const* functionDefinition = seq->functionDefinition(_terminal->activeSequences()))
+        if (auto const* functionDefinition = seq->functionDefinition(_terminal->supportedSequences()))
             std::cout << std::format("\t{:<20} ; {:<18} ; {}\n",
                                      seq->text(),
                                      functionDefinition->documentation.mnemonic,
@@ -7,6 +7,7 @@
 #include <vtbackend/Hyperlink.h>
 #include <vtbackend/InputGenerator.h>
 #include <vtbackend/InputHandler.h>
+#include <vtbackend/LatencyTelemetry.h>
 #include <vtbackend/RenderBuffer.h>
 #include <vtbackend/Selector.h>
 #include <vtbackend/Sequence.h>
@@ -310,6 +311,10 @@ class Terminal
     void setMaxHistoryLineCount(MaxHistoryLineCount maxHistoryLineCount);
     LineCount maxHistoryLineCount() const noexcept;
 
+    /// Sets the maximum size in bytes of the file that lines falling off the top of the
+    /// primary screen's history are spilled into, or disables spilling if @p bytes is 0.
+    void setHistorySpillFileSizeLimit(size_t bytes);
+
     void setTerminalId(VTType id) noexcept;
     VTType terminalId() const noexcept { return _terminalId; }
 
@@ -495,21 +500,17 @@ class Terminal
 
     /// Refreshes the render buffer.
     /// When this function returns, the back buffer is updated
-    /// and it is attempted to swap the back/front buffers.
-    /// but the swap has NOT been invoked yet.
+    /// and published to the render thread.
     ///
     /// @param locked whether or not the Terminal object's lock is already held by the caller.
     ///
-    /// @retval true   front buffer now contains the refreshed render buffer.
-    /// @retval false  back buffer contains the refreshed render buffer,
-    ///                and RenderDoubleBuffer::swapBuffers() must again
-    ///                be successfully invoked to swap back/front buffers
-    ///                in order to access the refreshed render buffer.
+    /// @retval true   the refreshed render buffer has been published.
+    /// @retval false  render buffer updates are currently disabled (e.g. by synchronized output).
     ///
     /// @note The current time must have been updated in order to get the
     ///       correct cursor blinking state drawn.
     ///
-    /// @see RenderDoubleBuffer::swapBuffers()
+    /// @see RenderTripleBuffer::swapBuffers()
     /// @see renderBuffer()
     ///
     bool refreshRenderBuffer(bool locked = false);
@@ -522,14 +523,14 @@ class Terminal
     /// @param now    the current time
     /// @param locked whether or not the Terminal object's lock is already held by the caller.
     ///
-    /// @see RenderDoubleBuffer::swapBuffers()
+    /// @see RenderTripleBuffer::swapBuffers()
     /// @see renderBuffer()
     bool ensureFreshRenderBuffer(bool locked = false);
 
-    /// Aquuires read-access handle to front render buffer.
+    /// Aquuires read-access handle to the most recently published render buffer.
     ///
-    /// This also acquires the reader lock and releases it automatically
-    /// upon RenderBufferRef destruction.
+    /// This never blocks the terminal thread. The returned handle must only be held
+    /// by one reader at a time.
     ///
     /// @see ensureFreshRenderBuffer()
     /// @see refreshRenderBuffer()
@@ -727,6 +728,7 @@ class Terminal
     }
 
     bool isHighlighted(CellLocation cell) const noexcept;
+    bool isHighlightActive() const noexcept { return _highlightRange.has_value(); }
     bool blinkState() const noexcept { return _slowBlinker.state; }
     bool rapidBlinkState() const noexcept { return _rapidBlinker.state; }
 
@@ -752,6 +754,8 @@ class Terminal
         return _hoveringHyperlinkId.load().value != 0;
     }
 
+    [[nodiscard]] HyperlinkId hoveringHyperlinkId() const noexcept { return _hoveringHyperlinkId.load(); }
+
     /// Retrieves the HyperlinkInfo that is currently behing hovered by the mouse, if so,
     /// or a nothing otherwise.
     [[nodiscard]] std::shared_ptr<HyperlinkInfo const> tryGetHoveringHyperlink() const noexcept
@@ -764,8 +768,19 @@ class Terminal
     [[nodiscard]] ExecutionMode executionMode() const noexcept { return _executionMode; }
     void setExecutionMode(ExecutionMode mode);
 
+    /// Waits for and processes the next chunk of input from the PTY.
+    ///
+    /// @returns false if the PTY has been closed, true otherwise.
     bool processInputOnce();
 
+    /// Processes whatever input is readily available from the PTY, without waiting for more.
+    ///
+    /// This is meant to be invoked from a shared event loop whenever the PTY's
+    /// pollable descriptors became readable.
+    ///
+    /// @returns false if the PTY has been closed, true otherwise.
+    bool processAvailableInput();
+
     void markScreenDirty() noexcept { _screenDirty = true; }
 
     [[nodiscard]] uint64_t lastFrameID() const noexcept { return _lastFrameID.load(); }
@@ -849,6 +864,30 @@ class Terminal
         return _currentPtyBuffer;
     }
 
+    /// Usage statistics of the buffer objects the PTY is being read into.
+    [[nodiscard]] crispy::buffer_object_pool_statistics ptyBufferStatistics() const
+    {
+        return _ptyBufferPool.statistics();
+    }
+
+    /// Usage statistics of the buffer objects holding text relocated out of sparse PTY buffer objects.
+    [[nodiscard]] crispy::buffer_object_pool_statistics historyTextStatistics() const
+    {
+        return _historyTextPool.statistics();
+    }
+
+    /// Frame time and input latency measurements of this terminal session.
+    [[nodiscard]] LatencyTelemetry& latencyTelemetry() noexcept { return _latencyTelemetry; }
+    [[nodiscard]] LatencyTelemetry const& latencyTelemetry() const noexcept { return _latencyTelemetry; }
+
+    /// Relocates the text of lines out of sparsely referenced PTY buffer objects into a dense
+    /// arena, so that a few surviving lines do not keep whole PTY buffer objects alive.
+    ///
+    /// The caller must hold the terminal lock.
+    ///
+    /// @returns the number of lines whose text has been relocated.
+    size_t compactPtyBuffers();
+
     [[nodiscard]] vtbackend::SelectionHelper& selectionHelper() noexcept { return _selectionHelper; }
 
     [[nodiscard]] Selection::OnSelectionUpdated selectionUpdatedHelper()
@@ -924,6 +963,11 @@ class Terminal
         return _supportedVTSequences.activeSequences();
     }
 
+    [[nodiscard]] SupportedSequences const& supportedSequences() const noexcept
+    {
+        return _supportedVTSequences;
+    }
+
     // {{{ VT parser related
 
     [[nodiscard]] size_t maxBulkTextSequenceWidth() const noexcept;
@@ -1041,8 +1085,23 @@ class Terminal
         return { !blinker.state, _currentTime };
     }
 
+    enum class InputStatus : uint8_t
+    {
+        Processed,
+        Idle,
+        Closed,
+    };
+
+    InputStatus processInput(bool nonBlocking);
+
+    // Timeout to use for reading from the PTY when not in non-blocking mode.
+    [[nodiscard]] std::optional<std::chrono::milliseconds> blockingReadTimeout() const noexcept;
+
     // Reads from PTY.
-    [[nodiscard]] std::optional<vtpty::Pty::ReadResult> readFromPty();
+    [[nodiscard]] std::optional<vtpty::Pty::ReadResult> readFromPty(bool nonBlocking);
+
+    // Allocates a new PTY buffer object, compacting the retired ones if they became sparse.
+    void allocatePtyBuffer();
 
     // Writes partially or all input data to the PTY buffer object and returns a string view to it.
     [[nodiscard]] std::string_view lockedWriteToPtyBuffer(std::string_view data);
@@ -1062,9 +1121,14 @@ class Terminal
     // terminal clock
     std::chrono::steady_clock::time_point _currentTime;
 
+    LatencyTelemetry _latencyTelemetry;
+
     // {{{ PTY and PTY read buffer management
     crispy::buffer_object_pool<char> _ptyBufferPool;
     crispy::buffer_object_ptr<char> _currentPtyBuffer;
+    crispy::buffer_object_pool<char> _historyTextPool; // dense arena for text relocated by compaction
+    crispy::buffer_fragment_compactor<char> _historyTextCompactor;
+    std::chrono::steady_clock::time_point _lastPtyBufferCompaction {};
     size_t _ptyReadBufferSize;
     std::unique_ptr<vtpty::Pty> _pty;
     // }}}
@@ -1117,7 +1181,9 @@ class Terminal
     mutable std::atomic<uint64_t> _changes { 0 };
     bool _screenDirty = false; // TODO: just inc _changes and delete this instead.
     RefreshInterval _refreshInterval;
-    RenderDoubleBuffer _renderBuffer {};
+    RenderTripleBuffer _renderBuffer {};
+    std::optional<CellLocation> _lastRenderedCursorPosition {};
+    RenderLineCache _renderLineCache {};
     std::atomic<uint64_t> _lastFrameID = 0;
     RenderPassHints _lastRenderPassHints {};
     // }}}
@@ -1202,6 +1268,10 @@ class Terminal
         {
             terminal.sequenceHandler().processSequence(sequence);
         }
+        bool processFastSequence(Sequence const& sequence)
+        {
+            return terminal.sequenceHandler().processFastSequence(sequence);
+        }
         void writeText(char32_t codepoint) { terminal.sequenceHandler().writeText(codepoint); }
         void writeText(std::string_view codepoints, size_t cellCount)
         {
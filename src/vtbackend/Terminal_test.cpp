@@ -133,6 +133,25 @@ TEST_CASE("Terminal.DECCARA", "[terminal]")
         }
 }
 
+TEST_CASE("Terminal.RenderBuffer.reused_lines_keep_their_codepoints", "[terminal]")
+{
+    auto mock = MockTerm { ColumnCount(4), LineCount(3) };
+    auto constexpr ClockBase = chrono::steady_clock::time_point();
+
+    // Mixed colors ensure that the lines are rendered cell by cell.
+    mock.writeToScreen("\033[31mab\033[32mc\r\n"
+                       "\033[33me\u0301\033[34md\r\n");
+    mock.terminal.tick(ClockBase);
+    mock.terminal.refreshRenderBuffer();
+    CHECK("abc\ne\u0301d" == trimmedTextScreenshot(mock));
+
+    // Scrolls the second line up, which is then taken over from the previous frame.
+    mock.writeToScreen("\r\nX");
+    mock.terminal.tick(ClockBase + chrono::seconds(1));
+    mock.terminal.refreshRenderBuffer();
+    CHECK("e\u0301d\n\nX" == trimmedTextScreenshot(mock));
+}
+
 TEST_CASE("Terminal.CaptureScreenBuffer")
 {
     auto constexpr ClockBase = chrono::steady_clock::time_point();
@@ -144,6 +144,10 @@ bool Viewport::scrollMarkDown()
 
 LineCount Viewport::historyLineCount() const noexcept
 {
+    // The lines spilled out of the primary screen's history can be scrolled to as well.
+    if (_terminal->isPrimaryScreen())
+        return _terminal->primaryScreen().historyLineCount()
+               + _terminal->primaryScreen().grid().spilledLineCount();
     return _terminal->currentScreen().historyLineCount();
 }
 
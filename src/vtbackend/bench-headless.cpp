@@ -1,5 +1,7 @@
 // SPDX-License-Identifier: Apache-2.0
+#include <vtbackend/Functions.h>
 #include <vtbackend/MockTerm.h>
+#include <vtbackend/SequenceBuilder.h>
 #include <vtbackend/Terminal.h>
 #include <vtbackend/cell/CellConfig.h>
 #include <vtbackend/logging.h>
@@ -7,16 +9,34 @@
 #include <vtparser/ParserEvents.h>
 
 #include <vtpty/MockViewPty.h>
+#if !defined(_WIN32)
+    #include <vtpty/UnixPty.h>
+#endif
 
 #include <crispy/App.h>
 #include <crispy/BufferObject.h>
 #include <crispy/CLI.h>
+#include <crispy/instrumentation.h>
+#include <crispy/thread_pool.h>
 #include <crispy/utils.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
 #include <format>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <new>
 #include <optional>
 #include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+    #include <sys/resource.h>
+#endif
 
 #include <libtermbench/termbench.h>
 
@@ -25,6 +45,21 @@ using namespace std;
 namespace
 {
 
+#if !defined(CONTOUR_INSTRUMENTATION)
+// Number of heap allocations performed via the global operator new.
+std::atomic<uint64_t> heapAllocations = 0; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+#endif
+
+uint64_t heapAllocationCount() noexcept
+{
+#if defined(CONTOUR_INSTRUMENTATION)
+    // The global operator new is replaced by the instrumentation's counting one already.
+    return crispy::instrumentation::heap_allocations();
+#else
+    return heapAllocations.load();
+#endif
+}
+
 std::string createText(size_t bytes)
 {
     std::string text;
@@ -37,8 +72,88 @@ std::string createText(size_t bytes)
     return text;
 }
 
+// Creates text filling the given page with every cell having its own foreground color,
+// so that no line can be rendered as a trivial line.
+std::string createColoredPage(vtbackend::PageSize pageSize)
+{
+    std::string text;
+    for (auto line = 0; line < unbox<int>(pageSize.lines); ++line)
+    {
+        for (auto column = 0; column < unbox<int>(pageSize.columns); ++column)
+            text += std::format("\033[38;5;{}m{}", (line + column) % 256, char('A' + (rand() % 26)));
+        if (line + 1 < unbox<int>(pageSize.lines))
+            text += "\r\n";
+    }
+    text += "\033[m";
+    return text;
+}
+
+// Creates a stream dominated by SGR and cursor movement sequences, with only little text in between,
+// as emitted by full screen applications redrawing colorful content.
+std::string createSgrDenseStream(size_t bytes)
+{
+    std::string text;
+    while (text.size() < bytes)
+    {
+        switch (rand() % 8)
+        {
+            case 0: text += std::format("\033[{};{}H", 1 + rand() % 50, 1 + rand() % 200); break;
+            case 1: text += "\033[m"; break;
+            case 2: text += std::format("\033[38;5;{}m", rand() % 256); break;
+            case 3: text += std::format("\033[48;5;{}m", rand() % 256); break;
+            case 4:
+                text += std::format("\033[38;2;{};{};{}m", rand() % 256, rand() % 256, rand() % 256);
+                break;
+            case 5: text += std::format("\033[{};{}m", 1 + rand() % 9, 30 + rand() % 8); break;
+            case 6: text += std::format("\033[{}C", 1 + rand() % 8); break;
+            default: text += "\033[K"; break;
+        }
+        text += char('A' + (rand() % 26));
+    }
+    return text;
+}
+
+// Resolves the function definition of every parsed sequence, and ignores everything else.
+template <typename Select>
+struct FunctionSelectingHandler
+{
+    Select select;
+    size_t* selectedCount;
+
+    void executeControlCode(char /*controlCode*/) {}
+    void processSequence(vtbackend::Sequence const& seq)
+    {
+        if (select(seq))
+            ++*selectedCount;
+    }
+    void writeText(char32_t /*codepoint*/) {}
+    void writeText(std::string_view /*codepoints*/, size_t /*cellCount*/) {}
+    void writeTextEnd() {}
+    [[nodiscard]] size_t maxBulkTextSequenceWidth() const noexcept { return 0; }
+};
+
 } // namespace
 
+#if !defined(CONTOUR_INSTRUMENTATION)
+void* operator new(size_t size)
+{
+    ++heapAllocations;
+    if (void* p = std::malloc(size != 0 ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t /*size*/) noexcept
+{
+    std::free(p);
+}
+#endif
+
 struct BenchOptions
 {
     unsigned testSizeMB = 64;
@@ -96,6 +211,249 @@ int baseBenchmark(Writer&& writer, BenchOptions options, string_view title)
     return EXIT_SUCCESS;
 }
 
+/// A recorded VT stream, as replayed by the `replay` command.
+struct Corpus
+{
+    std::string name;
+    std::string data;
+};
+
+/// Loads the given corpus files, or all regular files within the given directories.
+std::vector<Corpus> loadCorpora(std::vector<std::string_view> const& paths)
+{
+    namespace fs = std::filesystem;
+
+    auto files = std::vector<fs::path> {};
+    for (auto const path: paths)
+    {
+        if (fs::is_directory(path))
+        {
+            auto directoryFiles = std::vector<fs::path> {};
+            for (auto const& entry: fs::directory_iterator(path))
+                if (entry.is_regular_file())
+                    directoryFiles.emplace_back(entry.path());
+            std::ranges::sort(directoryFiles);
+            files.insert(files.end(), directoryFiles.begin(), directoryFiles.end());
+        }
+        else
+            files.emplace_back(path);
+    }
+
+    auto corpora = std::vector<Corpus> {};
+    for (auto const& file: files)
+    {
+        auto in = std::ifstream(file, std::ios::binary);
+        if (!in.good())
+            throw std::runtime_error(std::format("Could not open corpus file: {}", file.string()));
+        corpora.emplace_back(Corpus { .name = file.stem().string(),
+                                      .data = std::string(std::istreambuf_iterator<char>(in),
+                                                          std::istreambuf_iterator<char>()) });
+    }
+    return corpora;
+}
+
+/// Peak resident set size of this process in kilobytes, or 0 if unknown.
+uint64_t peakResidentSetKB()
+{
+#if !defined(_WIN32)
+    auto usage = rusage {};
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    #if defined(__APPLE__)
+        return static_cast<uint64_t>(usage.ru_maxrss) / 1024; // reported in bytes
+    #else
+        return static_cast<uint64_t>(usage.ru_maxrss);
+    #endif
+#endif
+    return 0;
+}
+
+struct ReplayResult
+{
+    std::string corpus;
+    std::string_view stage;
+    uint64_t bytes = 0;
+    std::chrono::nanoseconds elapsed {};
+    uint64_t allocations = 0;
+    uint64_t peakRssKB = 0;
+    crispy::instrumentation::counters stages {}; // per-stage breakdown, if instrumented
+
+    [[nodiscard]] double megabytesPerSecond() const noexcept
+    {
+        auto const seconds = std::chrono::duration<double>(elapsed).count();
+        return seconds > 0 ? static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds : 0.0;
+    }
+
+    [[nodiscard]] double nanosecondsPerByte() const noexcept
+    {
+        return bytes != 0 ? static_cast<double>(elapsed.count()) / static_cast<double>(bytes) : 0.0;
+    }
+};
+
+/// Runs the given replay function, measuring its wall time and heap allocations.
+template <typename F>
+ReplayResult measureReplay(Corpus const& corpus, std::string_view stage, unsigned repeat, F&& replay)
+{
+    using std::chrono::steady_clock;
+
+    crispy::instrumentation::reset();
+    auto const allocationCountBefore = heapAllocationCount();
+    auto const startTime = steady_clock::now();
+    replay();
+    auto const elapsed = steady_clock::now() - startTime;
+
+    return ReplayResult {
+        .corpus = corpus.name,
+        .stage = stage,
+        .bytes = static_cast<uint64_t>(corpus.data.size()) * repeat,
+        .elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed),
+        .allocations = heapAllocationCount() - allocationCountBefore,
+        .peakRssKB = peakResidentSetKB(),
+        .stages = crispy::instrumentation::snapshot(),
+    };
+}
+
+ReplayResult replayParser(Corpus const& corpus, unsigned repeat)
+{
+    auto po = vtparser::NullParserEvents {};
+    auto parser = vtparser::Parser<vtparser::ParserEvents> { po };
+    return measureReplay(corpus, "parser", repeat, [&]() {
+        for (unsigned i = 0; i < repeat; ++i)
+            parser.parseFragment(corpus.data);
+    });
+}
+
+/// Replays the corpus through the terminal's screen and grid.
+///
+/// If @p frameBytes is set, a render buffer is built after every that many bytes,
+/// resembling a terminal that is rendering while receiving a stream.
+ReplayResult replayTerminal(Corpus const& corpus,
+                            std::string_view stage,
+                            vtbackend::PageSize pageSize,
+                            unsigned history,
+                            unsigned repeat,
+                            std::optional<size_t> frameBytes)
+{
+    auto constexpr PtyReadBufferSize = 16384; // default of the read_buffer_size config option
+    auto vt = vtbackend::MockTerm<vtpty::MockViewPty>(
+        pageSize, vtbackend::LineCount::cast_from(history), PtyReadBufferSize);
+    auto* pty = dynamic_cast<vtpty::MockViewPty*>(&vt.terminal.device());
+    auto const chunkSize = frameBytes.value_or(corpus.data.size());
+
+    return measureReplay(corpus, stage, repeat, [&]() {
+        for (unsigned i = 0; i < repeat; ++i)
+        {
+            auto pending = std::string_view(corpus.data);
+            while (!pending.empty())
+            {
+                pty->setReadData(pending.substr(0, chunkSize));
+                pending.remove_prefix(std::min(chunkSize, pending.size()));
+                while (!pty->stdoutBuffer().empty())
+                    vt.terminal.processInputOnce();
+                if (frameBytes)
+                    (void) vt.terminal.refreshRenderBuffer();
+            }
+        }
+    });
+}
+
+std::string jsonEscaped(std::string_view text)
+{
+    auto result = std::string {};
+    for (auto const ch: text)
+    {
+        if (ch == '"' || ch == '\\')
+            result += '\\';
+        if (static_cast<unsigned char>(ch) < 0x20)
+            result += std::format("\\u{:04x}", static_cast<unsigned>(ch));
+        else
+            result += ch;
+    }
+    return result;
+}
+
+/// Formats the per-stage counters as a JSON member, or nothing if not instrumented.
+std::string stageCountersAsJson(crispy::instrumentation::counters const& stages)
+{
+    if (!crispy::instrumentation::enabled)
+        return {};
+
+    auto text = std::string(", \"stages\": {");
+    for (size_t i = 0; i < stages.size(); ++i)
+        text += std::format("{} \"{}\": {{ \"calls\": {}, \"bytes\": {}, \"allocations\": {}, "
+                            "\"nanoseconds\": {} }}",
+                            i != 0 ? "," : "",
+                            crispy::instrumentation::name(static_cast<crispy::instrumentation::stage>(i)),
+                            stages[i].calls,
+                            stages[i].bytes,
+                            stages[i].allocations,
+                            stages[i].nanoseconds);
+    text += " }";
+    return text;
+}
+
+void printReplayResultsAsJson(std::ostream& os,
+                              std::vector<ReplayResult> const& results,
+                              vtbackend::PageSize pageSize,
+                              unsigned history,
+                              unsigned repeat)
+{
+    os << "{\n";
+    os << std::format("  \"page_size\": {{ \"columns\": {}, \"lines\": {} }},\n",
+                      *pageSize.columns,
+                      *pageSize.lines);
+    os << std::format("  \"history\": {},\n", history);
+    os << std::format("  \"repeat\": {},\n", repeat);
+    os << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        auto const& result = results[i];
+        os << (i != 0 ? ",\n" : "\n");
+        os << std::format("    {{ \"corpus\": \"{}\", \"stage\": \"{}\", \"bytes\": {}, \"seconds\": {:.6f}, "
+                          "\"mb_per_second\": {:.3f}, \"ns_per_byte\": {:.3f}, \"allocations\": {}, "
+                          "\"peak_rss_kb\": {}{} }}",
+                          jsonEscaped(result.corpus),
+                          result.stage,
+                          result.bytes,
+                          std::chrono::duration<double>(result.elapsed).count(),
+                          result.megabytesPerSecond(),
+                          result.nanosecondsPerByte(),
+                          result.allocations,
+                          result.peakRssKB,
+                          stageCountersAsJson(result.stages));
+    }
+    os << "\n  ]\n}\n";
+}
+
+void printReplayResults(std::ostream& os, std::vector<ReplayResult> const& results)
+{
+    os << std::format("{:<24} {:<8} {:>12} {:>10} {:>10} {:>14} {:>12}\n",
+                      "Corpus",
+                      "Stage",
+                      "Bytes",
+                      "MB/s",
+                      "ns/byte",
+                      "Allocations",
+                      "Peak RSS");
+    for (auto const& result: results)
+        os << std::format("{:<24} {:<8} {:>12} {:>10.1f} {:>10.2f} {:>14} {:>12}\n",
+                          result.corpus,
+                          result.stage,
+                          result.bytes,
+                          result.megabytesPerSecond(),
+                          result.nanosecondsPerByte(),
+                          result.allocations,
+                          crispy::humanReadableBytes(result.peakRssKB * 1024));
+
+    if (crispy::instrumentation::enabled)
+    {
+        for (auto const& result: results)
+            os << std::format("\n{} ({}):\n{}",
+                              result.corpus,
+                              result.stage,
+                              crispy::instrumentation::report(result.stages));
+    }
+}
+
 namespace CLI = crispy::cli;
 
 class ContourHeadlessBench: public crispy::app
@@ -116,6 +474,10 @@ class ContourHeadlessBench: public crispy::app
         link("bench-headless.parser", bind(&ContourHeadlessBench::benchParserOnly, this));
         link("bench-headless.grid", bind(&ContourHeadlessBench::benchGrid, this));
         link("bench-headless.pty", bind(&ContourHeadlessBench::benchPTY));
+        link("bench-headless.render", bind(&ContourHeadlessBench::benchRender, this));
+        link("bench-headless.replay", bind(&ContourHeadlessBench::benchReplay, this));
+        link("bench-headless.dispatch", bind(&ContourHeadlessBench::benchDispatch, this));
+        link("bench-headless.resize", bind(&ContourHeadlessBench::benchResize, this));
         link("bench-headless.meta", bind(&ContourHeadlessBench::showMetaInfo));
 
         char const* logFilterString = getenv("LOG");
@@ -165,9 +527,88 @@ class ContourHeadlessBench: public crispy::app
                     CLI::command { .name = "parser",
                                    .helpText = "Performs performance tests utilizing the VT parser only.",
                                    .options = perfOptions },
+                    CLI::command {
+                        .name = "dispatch",
+                        .helpText = "Performs performance tests on parsing an SGR dense stream and selecting "
+                                    "the function of each sequence, via a full search and via the dispatch "
+                                    "index of the supported sequences.",
+                        .options =
+                            CLI::option_list {
+                                CLI::option { .name = "size",
+                                              .v = CLI::value { 32u },
+                                              .helpText = "Number of megabyte to process per test.",
+                                              .placeholder = "MB" },
+                            } },
+                    CLI::command {
+                        .name = "resize",
+                        .helpText = "Performs performance tests on reflowing a large history by shrinking "
+                                    "and growing the number of columns.",
+                        .options =
+                            CLI::option_list {
+                                CLI::option { .name = "history",
+                                              .v = CLI::value { 100000u },
+                                              .helpText = "Number of history lines to reflow.",
+                                              .placeholder = "LINES" },
+                                CLI::option { .name = "columns",
+                                              .v = CLI::value { 120u },
+                                              .helpText = "Number of columns to shrink from and grow to.",
+                                              .placeholder = "COUNT" },
+                                CLI::option { .name = "repeat",
+                                              .v = CLI::value { 5u },
+                                              .helpText = "Number of times to shrink and grow.",
+                                              .placeholder = "COUNT" },
+                            } },
                     CLI::command { .name = "pty",
                                    .helpText = "Performs performance tests utilizing the underlying "
                                                "operating system's PTY only." },
+                    CLI::command {
+                        .name = "render",
+                        .helpText = "Performs performance tests on building the render buffer of a full page.",
+                        .options =
+                            CLI::option_list {
+                                CLI::option { .name = "frames",
+                                              .v = CLI::value { 10000u },
+                                              .helpText = "Number of render buffers to build.",
+                                              .placeholder = "COUNT" },
+                            } },
+                    CLI::command {
+                        .name = "replay",
+                        .helpText = "Replays recorded VT streams through the parser, grid and render stages.",
+                        .options =
+                            CLI::option_list {
+                                CLI::option { .name = "stages",
+                                              .v = CLI::value { std::string("parser,grid,render") },
+                                              .helpText = "Comma separated list of stages to replay through.",
+                                              .placeholder = "LIST" },
+                                CLI::option { .name = "columns",
+                                              .v = CLI::value { 80u },
+                                              .helpText = "Number of columns of the page.",
+                                              .placeholder = "COUNT" },
+                                CLI::option { .name = "lines",
+                                              .v = CLI::value { 24u },
+                                              .helpText = "Number of lines of the page.",
+                                              .placeholder = "COUNT" },
+                                CLI::option { .name = "history",
+                                              .v = CLI::value { 1000u },
+                                              .helpText = "Number of scrollback lines.",
+                                              .placeholder = "COUNT" },
+                                CLI::option { .name = "repeat",
+                                              .v = CLI::value { 10u },
+                                              .helpText = "Number of times to replay each corpus per stage.",
+                                              .placeholder = "COUNT" },
+                                CLI::option { .name = "frame-bytes",
+                                              .v = CLI::value { 65536u },
+                                              .helpText = "Number of bytes processed between two render "
+                                                          "buffer builds in the render stage.",
+                                              .placeholder = "BYTES" },
+                                CLI::option { .name = "json",
+                                              .v = CLI::value { false },
+                                              .helpText = "Prints the results as JSON." },
+                            },
+                        .verbatim = CLI::verbatim { "CORPUS...",
+                                                    "Files, or directories of files, of recorded VT "
+                                                    "streams, e.g. as created by "
+                                                    "scripts/record-bench-corpus.sh." } },
                 }
         };
     }
@@ -203,6 +644,7 @@ class ContourHeadlessBench: public crispy::app
         auto vt = vtbackend::MockTerm<vtpty::MockViewPty>(pageSize, maxHistoryLineCount, ptyReadBufferSize);
         auto* pty = dynamic_cast<vtpty::MockViewPty*>(&vt.terminal.device());
         vt.terminal.setMode(vtbackend::DECMode::AutoWrap, true);
+        crispy::instrumentation::reset();
 
         auto const rv = baseBenchmark(
             [&](char const* a, size_t b) -> bool {
@@ -219,10 +661,137 @@ class ContourHeadlessBench: public crispy::app
             benchOptionsFor("grid"),
             "terminal with screen buffer");
         if (rv == EXIT_SUCCESS)
-            cout << std::format("{:>12}: {}\n\n", "history size", *vt.terminal.maxHistoryLineCount());
+        {
+            auto const& grid = vt.terminal.primaryScreen().grid();
+            auto const historyLineCount = std::max(*grid.historyLineCount(), 1);
+            auto const ptyBuffers = vt.terminal.ptyBufferStatistics();
+            cout << std::format("{:>12}: {}\n", "history size", *vt.terminal.maxHistoryLineCount());
+            cout << std::format("{:>12}: {} live of {} reserved\n",
+                                "pty buffers",
+                                crispy::humanReadableBytes(ptyBuffers.liveBytes),
+                                crispy::humanReadableBytes(ptyBuffers.reservedBytes));
+            cout << std::format(
+                "{:>12}: {:.1f}\n\n", "bytes/line", double(grid.historyBytesUsed()) / double(historyLineCount));
+            if (crispy::instrumentation::enabled)
+                cout << crispy::instrumentation::report(crispy::instrumentation::snapshot()) << '\n';
+        }
         return rv;
     }
 
+    int benchRender()
+    {
+        using std::chrono::steady_clock;
+
+        auto const pageSize = vtbackend::PageSize { vtbackend::LineCount(60), vtbackend::ColumnCount(200) };
+        auto const frameCount = parameters().uint("bench-headless.render.frames");
+        auto constexpr WarmupFrameCount = 10;
+
+        auto vt = vtbackend::MockTerm<vtpty::MockViewPty>(pageSize);
+        vt.writeToScreen(createColoredPage(pageSize));
+
+        // Every line is marked dirty before building a render buffer, so that no line can be
+        // taken over from the previous frame, and the full page is built each time.
+        auto const buildRenderBuffer = [&]() {
+            vt.terminal.primaryScreen().grid().markAllLinesDirty();
+            (void) vt.terminal.refreshRenderBuffer();
+        };
+
+        // Let all render buffers and their caches reach their steady state sizes.
+        for (int i = 0; i < WarmupFrameCount; ++i)
+            buildRenderBuffer();
+        crispy::instrumentation::reset();
+
+        std::cout << std::format("Running render buffer benchmark ({} frames of {}) ...\n", frameCount, pageSize);
+
+        auto elapsedTime = steady_clock::duration::zero();
+        auto allocationCount = uint64_t { 0 };
+        for (unsigned i = 0; i < frameCount; ++i)
+        {
+            auto const allocationCountBefore = heapAllocationCount();
+            auto const startTime = steady_clock::now();
+            buildRenderBuffer();
+            elapsedTime += steady_clock::now() - startTime;
+            allocationCount += heapAllocationCount() - allocationCountBefore;
+        }
+
+        auto const usecs = std::chrono::duration_cast<std::chrono::microseconds>(elapsedTime);
+
+        std::cout << std::format("\n");
+        std::cout << std::format("Render buffer build test\n");
+        std::cout << std::format("========================\n\n");
+        std::cout << std::format("Page size              : {}\n", pageSize);
+        std::cout << std::format("Frames built           : {}\n", frameCount);
+        std::cout << std::format(
+            "Test time              : {}.{:03} seconds\n", usecs.count() / 1000000, usecs.count() / 1000 % 1000);
+        std::cout << std::format("Average time per frame : {} us\n",
+                                 frameCount != 0 ? usecs.count() / frameCount : 0);
+        std::cout << std::format("Heap allocations       : {}\n", allocationCount);
+        std::cout << std::format("Allocations per frame  : {:.2f}\n",
+                                 frameCount != 0 ? double(allocationCount) / double(frameCount) : 0.0);
+        if (crispy::instrumentation::enabled)
+            std::cout << '\n' << crispy::instrumentation::report(crispy::instrumentation::snapshot());
+
+        return EXIT_SUCCESS;
+    }
+
+    int benchReplay()
+    {
+        auto const stages = std::string_view(parameters().str("bench-headless.replay.stages"));
+        auto const pageSize = vtbackend::PageSize {
+            vtbackend::LineCount::cast_from(parameters().uint("bench-headless.replay.lines")),
+            vtbackend::ColumnCount::cast_from(parameters().uint("bench-headless.replay.columns"))
+        };
+        auto const history = parameters().uint("bench-headless.replay.history");
+        auto const repeat = std::max(parameters().uint("bench-headless.replay.repeat"), 1u);
+        auto const frameBytes = std::max(parameters().uint("bench-headless.replay.frame-bytes"), 1u);
+        auto const json = parameters().boolean("bench-headless.replay.json");
+
+        if (parameters().verbatim.empty())
+        {
+            std::cerr << "No corpus files given.\n";
+            return EXIT_FAILURE;
+        }
+
+        auto const stageList = crispy::split(stages, ',');
+        for (auto const stage: stageList)
+        {
+            if (stage != "parser" && stage != "grid" && stage != "render")
+            {
+                std::cerr << std::format("Unknown replay stage: {}\n", stage);
+                return EXIT_FAILURE;
+            }
+        }
+        auto const hasStage = [&](std::string_view stage) {
+            return std::ranges::find(stageList, stage) != stageList.end();
+        };
+
+        auto const corpora = loadCorpora(parameters().verbatim);
+        auto results = std::vector<ReplayResult> {};
+        for (auto const& corpus: corpora)
+        {
+            if (!json)
+                std::cout << std::format("Replaying {} ({}) ...\n",
+                                         corpus.name,
+                                         crispy::humanReadableBytes(corpus.data.size()));
+            if (hasStage("parser"))
+                results.emplace_back(replayParser(corpus, repeat));
+            if (hasStage("grid"))
+                results.emplace_back(replayTerminal(corpus, "grid", pageSize, history, repeat, std::nullopt));
+            if (hasStage("render"))
+                results.emplace_back(replayTerminal(corpus, "render", pageSize, history, repeat, frameBytes));
+        }
+
+        if (json)
+            printReplayResultsAsJson(std::cout, results, pageSize, history, repeat);
+        else
+        {
+            std::cout << '\n';
+            printReplayResults(std::cout, results);
+        }
+
+        return EXIT_SUCCESS;
+    }
+
     static int benchPTY()
     {
         using std::chrono::steady_clock;
@@ -236,7 +805,7 @@ class ContourHeadlessBench: public crispy::app
         // TODO make these values CLI configurable.
         auto constexpr WritesPerLoop = 1;
         auto constexpr PtyWriteSize = 4096;
-        auto constexpr PtyReadSize = 4096;
+        auto constexpr PtyReadSize = 16384; // default of the read_buffer_size config option
         auto const benchTime = chrono::seconds(10);
 
         // Setup benchmark
@@ -308,6 +877,123 @@ class ContourHeadlessBench: public crispy::app
         std::cout << std::format("Transfer speed         : {} per second\n",
                                  crispy::humanReadableBytes(static_cast<uint64_t>(mbPerSecs)));
 
+#if !defined(_WIN32)
+        // Each read result is processed by the terminal under a single lock acquisition.
+        if (auto const* unixPty = dynamic_cast<vtpty::UnixPty const*>(&pty))
+        {
+            auto const& stats = unixPty->readStatistics();
+            auto const megabytes = std::max(static_cast<double>(stats.bytes) / (1024.0 * 1024.0), 1e-9);
+            std::cout << std::format("Syscalls per MB        : {:.1f} ({} waits, {} reads)\n",
+                                     static_cast<double>(stats.waits + stats.reads) / megabytes,
+                                     stats.waits,
+                                     stats.reads);
+            std::cout << std::format("Lock acquisitions / MB : {:.1f}\n",
+                                     static_cast<double>(stats.batches) / megabytes);
+        }
+#endif
+
+        return EXIT_SUCCESS;
+    }
+
+    int benchDispatch()
+    {
+        using std::chrono::steady_clock;
+
+        auto const testSizeMB = parameters().uint("bench-headless.dispatch.size");
+        auto const stream = createSgrDenseStream(size_t { testSizeMB } * 1024 * 1024);
+        auto const supportedSequences = vtbackend::SupportedSequences {};
+
+        auto const run = [&](std::string_view title, auto select) {
+            auto selectedCount = size_t { 0 };
+            auto handler = FunctionSelectingHandler<decltype(select)> { select, &selectedCount };
+            auto sequenceBuilder =
+                vtbackend::SequenceBuilder { handler, vtbackend::NoOpInstructionCounter() };
+            auto parser = vtparser::Parser { sequenceBuilder };
+
+            auto const startTime = steady_clock::now();
+            parser.parseFragment(stream);
+            auto const elapsed = std::chrono::duration<double>(steady_clock::now() - startTime);
+
+            std::cout << std::format("{:<14}: {:>8.2f} MB/s, {} sequences selected\n",
+                                     title,
+                                     double(stream.size()) / 1024.0 / 1024.0 / elapsed.count(),
+                                     selectedCount);
+        };
+
+        std::cout << std::format("Running function dispatch benchmark (test size: {} MB) ...\n\n",
+                                 testSizeMB);
+        run("full search", [&](vtbackend::Sequence const& seq) {
+            return seq.functionDefinition(supportedSequences.activeSequences());
+        });
+        run("dispatch index", [&](vtbackend::Sequence const& seq) {
+            return seq.functionDefinition(supportedSequences);
+        });
+
+        return EXIT_SUCCESS;
+    }
+
+    int benchResize()
+    {
+        using std::chrono::steady_clock;
+        using vtbackend::ColumnCount;
+        using vtbackend::LineCount;
+
+        auto const historyLineCount = parameters().uint("bench-headless.resize.history");
+        auto const columnCount = std::max(parameters().uint("bench-headless.resize.columns"), 20u);
+        auto const repeat = std::max(parameters().uint("bench-headless.resize.repeat"), 1u);
+        auto const wideSize = vtbackend::PageSize { LineCount(50), ColumnCount::cast_from(columnCount) };
+        auto const narrowSize =
+            vtbackend::PageSize { LineCount(50), ColumnCount::cast_from(columnCount / 2) };
+
+        std::cout << std::format("Running resize benchmark ({} history lines, {} threads) ...\n",
+                                 historyLineCount,
+                                 crispy::thread_pool::shared().worker_count() + 1);
+
+        // Lines of varying length, about half of them wrapping when shrunk. The history is large enough
+        // to keep all of them when shrunk.
+        auto grid = vtbackend::Grid<vtbackend::PrimaryScreenCell>(
+            wideSize, true, LineCount::cast_from(2 * historyLineCount));
+        auto text = std::string {};
+        for (unsigned i = 0; i < columnCount; ++i)
+            text += char('A' + (i % 26));
+        auto const bottomLine = wideSize.lines.as<vtbackend::LineOffset>() - 1;
+        for (unsigned i = 0; i < historyLineCount + unbox<unsigned>(wideSize.lines); ++i)
+        {
+            grid.scrollUp(LineCount(1));
+            auto const length = 10 + (i * 37) % (columnCount - 10);
+            grid.setLineText(bottomLine, std::string_view(text).substr(0, length));
+        }
+
+        auto shrinkTime = steady_clock::duration::zero();
+        auto growTime = steady_clock::duration::zero();
+        for (unsigned i = 0; i < repeat; ++i)
+        {
+            auto const shrinkStart = steady_clock::now();
+            (void) grid.resize(narrowSize, vtbackend::CellLocation {}, false);
+            auto const growStart = steady_clock::now();
+            (void) grid.resize(wideSize, vtbackend::CellLocation {}, false);
+            auto const growEnd = steady_clock::now();
+            shrinkTime += growStart - shrinkStart;
+            growTime += growEnd - growStart;
+        }
+
+        auto const averageMillis = [repeat](steady_clock::duration total) {
+            return std::chrono::duration<double, std::milli>(total).count() / repeat;
+        };
+
+        std::cout << std::format("\n");
+        std::cout << std::format("Resize reflow test\n");
+        std::cout << std::format("==================\n\n");
+        std::cout << std::format("History lines          : {}\n", historyLineCount);
+        std::cout << std::format("Shrink {:>3} -> {:>3}      : {:.2f} ms\n",
+                                 columnCount,
+                                 columnCount / 2,
+                                 averageMillis(shrinkTime));
+        std::cout << std::format("Grow   {:>3} -> {:>3}      : {:.2f} ms\n",
+                                 columnCount / 2,
+                                 columnCount,
+                                 averageMillis(growTime));
+
         return EXIT_SUCCESS;
     }
 
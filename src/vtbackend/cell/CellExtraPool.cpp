@@ -0,0 +1,171 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtbackend/cell/CellExtraPool.h>
+
+#include <algorithm>
+#include <limits>
+#include <new>
+#include <utility>
+
+namespace vtbackend
+{
+
+CellExtraPool::CellExtraPool()
+{
+    // Reserving up front lets release() cache slots without having to allocate.
+    for (auto& shard: _shards)
+        shard.freeList.reserve(2 * BatchSize);
+}
+
+CellExtraPool::~CellExtraPool()
+{
+    for (auto& directory: _directories)
+    {
+        auto* const chunks = directory.load(std::memory_order_relaxed);
+        if (!chunks)
+            continue;
+        for (auto& chunk: *chunks)
+            delete chunk.load(std::memory_order_relaxed);
+        delete chunks;
+    }
+    delete _spareChunk;
+}
+
+void CellExtraPool::ensureChunk(uint32_t chunkIndex)
+{
+    auto& directory = _directories[chunkIndex >> DirectoryBits];
+    if (!directory.load(std::memory_order_relaxed))
+        directory.store(new Directory(), std::memory_order_release);
+
+    if (_chunkUseCounts.size() <= chunkIndex)
+        _chunkUseCounts.resize(chunkIndex + 1, 0);
+
+    auto& chunk = chunkAt(chunkIndex);
+    if (chunk.load(std::memory_order_relaxed))
+        return;
+
+    chunk.store(_spareChunk ? std::exchange(_spareChunk, nullptr) : new Chunk(), std::memory_order_release);
+    ++_chunkCount;
+}
+
+CellExtraPool::Shard& CellExtraPool::currentShard() noexcept
+{
+    static auto nextShardIndex = std::atomic<size_t> { 0 };
+    thread_local auto const shardIndex = nextShardIndex.fetch_add(1, std::memory_order_relaxed) % ShardCount;
+    return _shards[shardIndex];
+}
+
+void CellExtraPool::refill(Shard& shard)
+{
+    if (_freeList.empty() && _unusedIndex >= std::numeric_limits<CellExtraId>::max())
+        throw std::bad_alloc();
+
+    while (shard.freeList.size() < BatchSize)
+    {
+        if (_freeList.empty() && _unusedIndex >= std::numeric_limits<CellExtraId>::max())
+            return;
+
+        // Ids on the free list may point into a chunk that has been freed in the meantime.
+        auto const id = !_freeList.empty() ? _freeList.back() : static_cast<CellExtraId>(_unusedIndex + 1);
+        auto const chunkIndex = (id - 1) >> ChunkBits;
+        ensureChunk(chunkIndex);
+
+        if (!_freeList.empty())
+            _freeList.pop_back();
+        else
+            ++_unusedIndex;
+
+        ++_chunkUseCounts[chunkIndex];
+        shard.freeList.push_back(id);
+    }
+}
+
+void CellExtraPool::drain(Shard& shard) noexcept
+{
+    // Return the least recently released slots, keeping the ones most likely still in cache.
+    auto const count = std::min(BatchSize, shard.freeList.size());
+    try
+    {
+        _freeList.reserve(_freeList.size() + count);
+    }
+    catch (std::bad_alloc const&)
+    {
+        return;
+    }
+
+    for (auto i = size_t { 0 }; i < count; ++i)
+    {
+        auto const id = shard.freeList[i];
+        _freeList.push_back(id);
+
+        auto const chunkIndex = (id - 1) >> ChunkBits;
+        if (--_chunkUseCounts[chunkIndex] != 0)
+            continue;
+
+        // Return the memory of chunks that are not used anymore, keeping one for the next allocation.
+        auto* const chunk = chunkAt(chunkIndex).exchange(nullptr, std::memory_order_acq_rel);
+        --_chunkCount;
+        if (_spareChunk)
+            delete chunk;
+        else
+            _spareChunk = chunk;
+    }
+    shard.freeList.erase(shard.freeList.begin(), shard.freeList.begin() + static_cast<ptrdiff_t>(count));
+}
+
+CellExtraId CellExtraPool::allocate()
+{
+    auto& shard = currentShard();
+    auto const shardLock = std::lock_guard { shard.mutex };
+
+    if (shard.freeList.empty())
+    {
+        auto const poolLock = std::lock_guard { _mutex };
+        refill(shard);
+    }
+
+    auto const id = shard.freeList.back();
+    shard.freeList.pop_back();
+    _size.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+CellExtraId CellExtraPool::allocate(CellExtra const& value)
+{
+    auto const id = allocate();
+    at(id) = value;
+    return id;
+}
+
+void CellExtraPool::release(CellExtraId id) noexcept
+{
+    // Keep the codepoints' capacity around for whichever cell is reusing this slot next.
+    auto& extra = at(id);
+    extra.codepoints.clear();
+    extra.underlineColor = DefaultColor();
+    extra.hyperlink = {};
+    extra.imageFragment.reset();
+    extra.flags = CellFlag::None;
+    extra.width = 1;
+
+    auto& shard = currentShard();
+    auto const shardLock = std::lock_guard { shard.mutex };
+
+    if (shard.freeList.size() >= 2 * BatchSize)
+    {
+        auto const poolLock = std::lock_guard { _mutex };
+        drain(shard);
+        if (shard.freeList.size() >= 2 * BatchSize)
+            return; // The slot is leaked, which is better than failing to release a cell.
+    }
+
+    shard.freeList.push_back(id);
+    _size.fetch_sub(1, std::memory_order_relaxed);
+}
+
+size_t CellExtraPool::capacity() const noexcept
+{
+    auto const _ = std::lock_guard { _mutex };
+    return _chunkCount * ChunkSize;
+}
+
+} // namespace vtbackend
@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <vtbackend/CellFlags.h>
+#include <vtbackend/Color.h>
+#include <vtbackend/Hyperlink.h>
+#include <vtbackend/Image.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace vtbackend
+{
+
+/// Rarely needed extra cell data.
+///
+/// In this struct we collect all the relevant cell data that is not frequently used,
+/// and thus, would only waste unnecessary memory in most situations.
+///
+/// @see CompactCell
+struct CellExtra
+{
+    /// With the main codepoint that is being stored in the CompactCell struct, followed by this
+    /// sequence of codepoints, a grapheme cluster is formed that represents the visual
+    /// character in this terminal cell.
+    ///
+    /// Since MOST content in the terminal is US-ASCII, all codepoints except the first one of a grapheme
+    /// cluster is stored in CellExtra.
+    std::u32string codepoints = {};
+
+    /// Color for underline decoration (such as curly underline).
+    Color underlineColor = DefaultColor();
+
+    /// With OSC-8 a hyperlink can be associated with a range of terminal cells.
+    HyperlinkId hyperlink = {};
+
+    /// Holds a reference to an image tile to be rendered (above the text, if any).
+    std::shared_ptr<ImageFragment> imageFragment = nullptr;
+
+    /// Cell flags.
+    CellFlags flags = CellFlag::None;
+
+    /// In terminals, the Unicode's East asian Width property is used to determine the
+    /// number of columns, a graphical character is spanning.
+    /// Since most graphical characters in a terminal will be US-ASCII, this width property
+    /// will be only used when NOT being 1.
+    uint8_t width = 1;
+};
+
+/// Identifies a CellExtra within the CellExtraPool.
+///
+/// The value 0 denotes no CellExtra at all.
+using CellExtraId = uint32_t;
+
+/**
+ * Slab storage for all CellExtra objects, addressed by CellExtraId.
+ *
+ * Slots are allocated in chunks that are never moved, and released slots are reused via a free list.
+ * This avoids one heap allocation per cell carrying extra data, which is what colorful full-screen
+ * applications cause a lot of.
+ *
+ * Chunks are looked up through directories that are allocated on demand, so that the pool grows
+ * with the whole 32-bit id space. Chunks whose slots have all been released are freed again,
+ * except for one that is kept around to avoid thrashing.
+ *
+ * Allocating and releasing slots is thread-safe, whereas accessing the contents of a slot is
+ * subject to the same synchronization as the cell owning it. Released slots are first cached in
+ * one of several shards, each thread using its own one, and are moved between the shards and the
+ * pool in batches, so that concurrent threads rarely contend on the same lock.
+ */
+class CellExtraPool
+{
+  public:
+    static constexpr uint32_t IdBits = 32;
+    static constexpr uint32_t ChunkBits = 12;
+    static constexpr uint32_t ChunkSize = 1u << ChunkBits;
+    static constexpr uint32_t DirectoryBits = 10;
+    static constexpr uint32_t DirectorySize = 1u << DirectoryBits;
+    static constexpr uint32_t MaxDirectoryCount = 1u << (IdBits - ChunkBits - DirectoryBits);
+    static constexpr size_t ShardCount = 8;
+    static constexpr size_t BatchSize = 64;
+
+    CellExtraPool();
+    CellExtraPool(CellExtraPool const&) = delete;
+    CellExtraPool(CellExtraPool&&) = delete;
+    CellExtraPool& operator=(CellExtraPool const&) = delete;
+    CellExtraPool& operator=(CellExtraPool&&) = delete;
+    ~CellExtraPool();
+
+    /// Returns the pool shared by all CompactCell objects.
+    [[nodiscard]] static CellExtraPool& instance() noexcept
+    {
+        static CellExtraPool pool;
+        return pool;
+    }
+
+    /// Allocates a slot holding a default-constructed CellExtra.
+    ///
+    /// @throws std::bad_alloc if memory or the id space is exhausted.
+    [[nodiscard]] CellExtraId allocate();
+
+    /// Allocates a slot holding a copy of the given CellExtra.
+    [[nodiscard]] CellExtraId allocate(CellExtra const& value);
+
+    /// Releases the given slot for reuse, resetting its contents.
+    void release(CellExtraId id) noexcept;
+
+    [[nodiscard]] CellExtra& at(CellExtraId id) noexcept
+    {
+        auto const index = id - 1;
+        return (*chunkAt(index >> ChunkBits).load(std::memory_order_acquire))[index & (ChunkSize - 1)];
+    }
+
+    [[nodiscard]] CellExtra const& at(CellExtraId id) const noexcept
+    {
+        return const_cast<CellExtraPool*>(this)->at(id);
+    }
+
+    /// Number of slots currently in use.
+    [[nodiscard]] size_t size() const noexcept { return _size.load(std::memory_order_relaxed); }
+
+    /// Number of slots available without allocating another chunk.
+    [[nodiscard]] size_t capacity() const noexcept;
+
+  private:
+    using Chunk = std::array<CellExtra, ChunkSize>;
+    using Directory = std::array<std::atomic<Chunk*>, DirectorySize>;
+
+    struct alignas(64) Shard
+    {
+        std::mutex mutex;
+        std::vector<CellExtraId> freeList; // at most 2 * BatchSize cached slots
+    };
+
+    [[nodiscard]] Shard& currentShard() noexcept;
+
+    [[nodiscard]] std::atomic<Chunk*>& chunkAt(uint32_t chunkIndex) noexcept
+    {
+        auto& directory = *_directories[chunkIndex >> DirectoryBits].load(std::memory_order_acquire);
+        return directory[chunkIndex & (DirectorySize - 1)];
+    }
+
+    // The following must be called with the pool's mutex held.
+
+    // Ensures the chunk holding the given slot is present.
+    void ensureChunk(uint32_t chunkIndex);
+
+    // Moves up to BatchSize slots from the pool to the given shard.
+    void refill(Shard& shard);
+
+    // Moves up to BatchSize slots from the given shard back to the pool.
+    void drain(Shard& shard) noexcept;
+
+    mutable std::mutex _mutex;
+    std::array<std::atomic<Directory*>, MaxDirectoryCount> _directories {};
+    std::vector<uint16_t> _chunkUseCounts; // number of slots in use or cached in a shard, per chunk
+    size_t _chunkCount = 0;                // number of chunks currently allocated
+    Chunk* _spareChunk = nullptr;          // freed chunk kept around for reuse
+    uint64_t _unusedIndex = 0;             // index of the first slot that has never been used
+    std::vector<CellExtraId> _freeList;    // released slots not cached in any shard
+    std::array<Shard, ShardCount> _shards;
+    std::atomic<size_t> _size = 0;
+};
+
+} // namespace vtbackend
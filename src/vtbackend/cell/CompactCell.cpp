@@ -12,7 +12,7 @@ std::u32string CompactCell::codepoints() const
         s += _codepoint;
         if (_extra)
         {
-            for (char32_t const cp: _extra->codepoints)
+            for (char32_t const cp: existingExtra().codepoints)
             {
                 s += cp;
             }
@@ -29,7 +29,7 @@ std::string CompactCell::toUtf8() const
     std::string text;
     text += unicode::convert_to<char>(_codepoint);
     if (_extra)
-        for (char32_t const cp: _extra->codepoints)
+        for (char32_t const cp: existingExtra().codepoints)
             text += unicode::convert_to<char>(cp);
     return text;
 }
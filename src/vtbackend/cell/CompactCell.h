@@ -7,9 +7,9 @@
 #include <vtbackend/GraphicsAttributes.h>
 #include <vtbackend/Hyperlink.h>
 #include <vtbackend/Image.h>
+#include <vtbackend/cell/CellExtraPool.h>
 #include <vtbackend/primitives.h>
 
-#include <crispy/Owned.h>
 #include <crispy/defines.h>
 #include <crispy/times.h>
 
@@ -24,45 +24,10 @@
 namespace vtbackend
 {
 
-/// Rarely needed extra cell data.
-///
-/// In this struct we collect all the relevant cell data that is not frequently used,
-/// and thus, would only waste unnecessary memory in most situations.
-///
-/// @see CompactCell
-struct CellExtra
-{
-    /// With the main codepoint that is being stored in the CompactCell struct, followed by this
-    /// sequence of codepoints, a grapheme cluster is formed that represents the visual
-    /// character in this terminal cell.
-    ///
-    /// Since MOST content in the terminal is US-ASCII, all codepoints except the first one of a grapheme
-    /// cluster is stored in CellExtra.
-    std::u32string codepoints = {};
-
-    /// Color for underline decoration (such as curly underline).
-    Color underlineColor = DefaultColor();
-
-    /// With OSC-8 a hyperlink can be associated with a range of terminal cells.
-    HyperlinkId hyperlink = {};
-
-    /// Holds a reference to an image tile to be rendered (above the text, if any).
-    std::shared_ptr<ImageFragment> imageFragment = nullptr;
-
-    /// Cell flags.
-    CellFlags flags = CellFlag::None;
-
-    /// In terminals, the Unicode's East asian Width property is used to determine the
-    /// number of columns, a graphical character is spanning.
-    /// Since most graphical characters in a terminal will be US-ASCII, this width property
-    /// will be only used when NOT being 1.
-    uint8_t width = 1;
-};
-
 /// Grid cell with character and graphics rendition information.
 ///
-/// TODO(perf): ensure POD'ness so that we can SIMD-copy it.
-/// - Requires moving out CellExtra into Line<T>?
+/// Rarely needed data is kept in a CellExtra that lives in the CellExtraPool,
+/// and is referred to by its CellExtraId.
 class CRISPY_PACKED CompactCell
 {
   public:
@@ -74,9 +39,9 @@ class CRISPY_PACKED CompactCell
     CompactCell& operator=(CompactCell const& v) noexcept;
     explicit CompactCell(GraphicsAttributes attributes, HyperlinkId hyperlink = {}) noexcept;
 
-    CompactCell(CompactCell&&) noexcept = default;
-    CompactCell& operator=(CompactCell&&) noexcept = default;
-    ~CompactCell() = default;
+    CompactCell(CompactCell&& v) noexcept;
+    CompactCell& operator=(CompactCell&& v) noexcept;
+    ~CompactCell() { releaseExtra(); }
 
     void reset() noexcept;
     void reset(GraphicsAttributes const& attributes) noexcept;
@@ -110,7 +75,7 @@ class CRISPY_PACKED CompactCell
     void resetFlags() noexcept
     {
         if (_extra)
-            _extra->flags = CellFlag::None;
+            existingExtra().flags = CellFlag::None;
     }
 
     void resetFlags(CellFlags flags) noexcept { extra().flags = flags; }
@@ -137,33 +102,61 @@ class CRISPY_PACKED CompactCell
     void setGraphicsRendition(GraphicsRendition sgr) noexcept;
 
   private:
+    /// Returns this cell's CellExtra, creating it if not present yet.
     [[nodiscard]] CellExtra& extra() noexcept;
 
-    template <typename... Args>
-    void createExtra(Args... args) noexcept;
+    /// Returns this cell's CellExtra, which must be present.
+    [[nodiscard]] CellExtra& existingExtra() noexcept { return CellExtraPool::instance().at(_extra); }
+    [[nodiscard]] CellExtra const& existingExtra() const noexcept
+    {
+        return std::as_const(CellExtraPool::instance()).at(_extra);
+    }
+
+    void createExtra() noexcept;
+    void createExtra(CellExtra const& value) noexcept;
+    void releaseExtra() noexcept;
 
     // CompactCell data
     char32_t _codepoint = 0; /// Primary Unicode codepoint to be displayed.
     Color _foregroundColor = DefaultColor();
     Color _backgroundColor = DefaultColor();
-    crispy::owned<CellExtra> _extra = {};
-    // TODO(perf) ^^ use CellExtraId = boxed<int24_t> into pre-alloc'ed vector<CellExtra>.
+    CellExtraId _extra = 0;
 };
 
 // {{{ impl: ctor's
-template <typename... Args>
-inline void CompactCell::createExtra(Args... args) noexcept
+inline void CompactCell::createExtra() noexcept
 {
     try
     {
-        _extra.reset(new CellExtra(std::forward<Args>(args)...));
+        _extra = CellExtraPool::instance().allocate();
     }
     catch (std::bad_alloc const&)
     {
-        Require(_extra.get() != nullptr);
+        Require(_extra != 0);
     }
 }
 
+inline void CompactCell::createExtra(CellExtra const& value) noexcept
+{
+    try
+    {
+        _extra = CellExtraPool::instance().allocate(value);
+    }
+    catch (std::bad_alloc const&)
+    {
+        Require(_extra != 0);
+    }
+}
+
+inline void CompactCell::releaseExtra() noexcept
+{
+    if (!_extra)
+        return;
+
+    CellExtraPool::instance().release(_extra);
+    _extra = 0;
+}
+
 inline CompactCell::CompactCell() noexcept
 {
     setWidth(1);
@@ -188,16 +181,46 @@ inline CompactCell::CompactCell(CompactCell const& v) noexcept:
     _backgroundColor { v._backgroundColor }
 {
     if (v._extra)
-        createExtra(*v._extra);
+        createExtra(v.existingExtra());
 }
 
 inline CompactCell& CompactCell::operator=(CompactCell const& v) noexcept
 {
+    if (this == &v)
+        return *this;
+
     _codepoint = v._codepoint;
     _foregroundColor = v._foregroundColor;
     _backgroundColor = v._backgroundColor;
-    if (v._extra)
-        createExtra(*v._extra);
+    if (!v._extra)
+        releaseExtra();
+    else if (_extra)
+        existingExtra() = v.existingExtra();
+    else
+        createExtra(v.existingExtra());
+    return *this;
+}
+
+inline CompactCell::CompactCell(CompactCell&& v) noexcept:
+    _codepoint { v._codepoint },
+    _foregroundColor { v._foregroundColor },
+    _backgroundColor { v._backgroundColor },
+    _extra { v._extra }
+{
+    v._extra = 0;
+}
+
+inline CompactCell& CompactCell::operator=(CompactCell&& v) noexcept
+{
+    if (this == &v)
+        return *this;
+
+    releaseExtra();
+    _codepoint = v._codepoint;
+    _foregroundColor = v._foregroundColor;
+    _backgroundColor = v._backgroundColor;
+    _extra = v._extra;
+    v._extra = 0;
     return *this;
 }
 // }}}
@@ -207,19 +230,12 @@ inline void CompactCell::reset() noexcept
     _codepoint = 0;
     _foregroundColor = DefaultColor();
     _backgroundColor = DefaultColor();
-    _extra.reset();
+    releaseExtra();
 }
 
 inline void CompactCell::reset(GraphicsAttributes const& attributes) noexcept
 {
-    _codepoint = 0;
-    _foregroundColor = attributes.foregroundColor;
-    _backgroundColor = attributes.backgroundColor;
-    _extra.reset();
-    if (attributes.flags != CellFlag::None)
-        extra().flags = attributes.flags;
-    if (attributes.underlineColor != DefaultColor())
-        extra().underlineColor = attributes.underlineColor;
+    reset(attributes, HyperlinkId());
 }
 
 inline void CompactCell::write(GraphicsAttributes const& attributes, char32_t ch, uint8_t width) noexcept
@@ -229,8 +245,8 @@ inline void CompactCell::write(GraphicsAttributes const& attributes, char32_t ch
     _codepoint = ch;
     if (_extra)
     {
-        _extra->codepoints.clear();
-        _extra->imageFragment = {};
+        existingExtra().codepoints.clear();
+        existingExtra().imageFragment = {};
     }
 
     _foregroundColor = attributes.foregroundColor;
@@ -252,7 +268,7 @@ inline void CompactCell::write(GraphicsAttributes const& attributes,
     if (_extra)
     {
         // Writing text into a cell destroys the image fragment (as least for Sixels).
-        _extra->imageFragment = {};
+        existingExtra().imageFragment = {};
     }
 
     _foregroundColor = attributes.foregroundColor;
@@ -273,7 +289,7 @@ inline void CompactCell::writeTextOnly(char32_t ch, uint8_t width) noexcept
     setWidth(width);
     _codepoint = ch;
     if (_extra)
-        _extra->codepoints.clear();
+        existingExtra().codepoints.clear();
 }
 
 inline void CompactCell::reset(GraphicsAttributes const& attributes, HyperlinkId hyperlink) noexcept
@@ -282,19 +298,27 @@ inline void CompactCell::reset(GraphicsAttributes const& attributes, HyperlinkId
     _foregroundColor = attributes.foregroundColor;
     _backgroundColor = attributes.backgroundColor;
 
-    _extra.reset();
-    if (attributes.underlineColor != DefaultColor())
-        extra().underlineColor = attributes.underlineColor;
-    if (attributes.flags != CellFlag::None)
-        extra().flags = attributes.flags;
-    if (hyperlink != HyperlinkId())
-        extra().hyperlink = hyperlink;
+    if (attributes.underlineColor == DefaultColor() && attributes.flags == CellFlag::None
+        && hyperlink == HyperlinkId())
+    {
+        releaseExtra();
+        return;
+    }
+
+    // Reuse the slot if present, instead of releasing it only to allocate another one.
+    CellExtra& ext = extra();
+    ext.codepoints.clear();
+    ext.underlineColor = attributes.underlineColor;
+    ext.hyperlink = hyperlink;
+    ext.imageFragment.reset();
+    ext.flags = attributes.flags;
+    ext.width = 1;
 }
 // }}}
 // {{{ impl: character
 inline constexpr uint8_t CompactCell::width() const noexcept
 {
-    return !_extra ? 1 : _extra->width;
+    return !_extra ? 1 : existingExtra().width;
     // return static_cast<int>((_codepoint >> 21) & 0x03); //return _width;
 }
 
@@ -312,8 +336,8 @@ inline void CompactCell::setCharacter(char32_t codepoint) noexcept
     _codepoint = codepoint;
     if (_extra)
     {
-        _extra->codepoints.clear();
-        _extra->imageFragment = {};
+        existingExtra().codepoints.clear();
+        existingExtra().imageFragment = {};
     }
     if (codepoint)
         setWidth(std::max<uint8_t>(unicode::width(codepoint), 1));
@@ -345,7 +369,7 @@ inline std::size_t CompactCell::codepointCount() const noexcept
         if (!_extra)
             return 1;
 
-        return 1 + _extra->codepoints.size();
+        return 1 + existingExtra().codepoints.size();
     }
     return 0;
 }
@@ -359,19 +383,18 @@ inline char32_t CompactCell::codepoint(size_t i) const noexcept
         return 0;
 
 #if !defined(NDEBUG)
-    return _extra->codepoints.at(i - 1);
+    return existingExtra().codepoints.at(i - 1);
 #else
-    return _extra->codepoints[i - 1];
+    return existingExtra().codepoints[i - 1];
 #endif
 }
 // }}}
 // {{{ attrs
 inline CellExtra& CompactCell::extra() noexcept
 {
-    if (_extra)
-        return *_extra;
-    createExtra();
-    return *_extra;
+    if (!_extra)
+        createExtra();
+    return existingExtra();
 }
 
 inline CellFlags CompactCell::flags() const noexcept
@@ -379,7 +402,7 @@ inline CellFlags CompactCell::flags() const noexcept
     if (!_extra)
         return CellFlag::None;
     else
-        return const_cast<CompactCell*>(this)->_extra->flags;
+        return existingExtra().flags;
 }
 
 inline Color CompactCell::foregroundColor() const noexcept
@@ -407,13 +430,13 @@ inline Color CompactCell::underlineColor() const noexcept
     if (!_extra)
         return DefaultColor();
     else
-        return _extra->underlineColor;
+        return existingExtra().underlineColor;
 }
 
 inline void CompactCell::setUnderlineColor(Color color) noexcept
 {
     if (_extra)
-        _extra->underlineColor = color;
+        existingExtra().underlineColor = color;
     else if (color != DefaultColor())
         extra().underlineColor = color;
 }
@@ -421,7 +444,7 @@ inline void CompactCell::setUnderlineColor(Color color) noexcept
 inline std::shared_ptr<ImageFragment> CompactCell::imageFragment() const noexcept
 {
     if (_extra)
-        return _extra->imageFragment;
+        return existingExtra().imageFragment;
     else
         return {};
 }
@@ -436,7 +459,7 @@ inline void CompactCell::setImageFragment(std::shared_ptr<RasterizedImage> raste
 inline HyperlinkId CompactCell::hyperlink() const noexcept
 {
     if (_extra)
-        return _extra->hyperlink;
+        return existingExtra().hyperlink;
     else
         return HyperlinkId {};
 }
@@ -446,7 +469,7 @@ inline void CompactCell::setHyperlink(HyperlinkId hyperlink)
     if (!!hyperlink)
         extra().hyperlink = hyperlink;
     else if (_extra)
-        _extra->hyperlink = {};
+        existingExtra().hyperlink = {};
 }
 
 inline bool CompactCell::empty() const noexcept
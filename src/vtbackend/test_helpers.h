@@ -54,7 +54,7 @@ template <typename S>
         if (*gap > 0) // Did we jump?
             currentLine.insert(currentLine.end(), unbox<size_t>(gap) - 1, ' ');
 
-        currentLine += unicode::convert_to<char>(std::u32string_view(cell.codepoints));
+        currentLine += unicode::convert_to<char>(renderBuffer.buffer->codepointsOf(cell));
         lastPos = cell.position;
         lastCount = 1;
     }
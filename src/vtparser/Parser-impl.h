@@ -4,11 +4,19 @@
 
 #include <libunicode/utf8.h>
 
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <cassert>
 #include <string_view>
 #include <tuple>
 
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+    #include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+#endif
+
 namespace vtparser
 {
 
@@ -22,6 +30,78 @@ namespace
     // clang-format on
 } // namespace
 
+namespace detail
+{
+    /// Tests whether or not the given byte is a printable 7-bit US-ASCII character [0x20 .. 0x7E].
+    constexpr bool isPrintableAscii(char ch) noexcept
+    {
+        return static_cast<uint8_t>(ch) >= 0x20 && static_cast<uint8_t>(ch) < 0x7F;
+    }
+
+    /// Scans the given input for the longest prefix of printable 7-bit US-ASCII characters.
+    ///
+    /// The scan stops at the first C0 control character (< 0x20), DEL (0x7F), or any byte
+    /// that is not 7-bit (>= 0x80, i.e. part of a UTF-8 multibyte sequence).
+    ///
+    /// @returns number of bytes of the printable prefix.
+    inline size_t scanPrintableAscii(char const* begin, char const* end) noexcept
+    {
+        auto const* input = begin;
+
+#if defined(__AVX2__)
+        auto const ControlCodeMax32 = _mm256_set1_epi8(0x20);
+        auto const Delete32 = _mm256_set1_epi8(0x7F);
+        while (end - input >= 32)
+        {
+            // Bytes >= 0x80 are negative when compared as signed, so they are caught by the less-than.
+            auto const batch = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(input));
+            auto const isControl = _mm256_or_si256(_mm256_cmpgt_epi8(ControlCodeMax32, batch),
+                                                   _mm256_cmpeq_epi8(batch, Delete32));
+            if (auto const mask = static_cast<uint32_t>(_mm256_movemask_epi8(isControl)); mask != 0)
+                return static_cast<size_t>(input - begin) + static_cast<size_t>(std::countr_zero(mask));
+            input += 32;
+        }
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+        auto const ControlCodeMax = _mm_set1_epi8(0x20);
+        auto const Delete = _mm_set1_epi8(0x7F);
+        while (end - input >= 16)
+        {
+            auto const batch = _mm_loadu_si128(reinterpret_cast<__m128i const*>(input));
+            auto const isControl =
+                _mm_or_si128(_mm_cmplt_epi8(batch, ControlCodeMax), _mm_cmpeq_epi8(batch, Delete));
+            if (auto const mask = static_cast<uint32_t>(_mm_movemask_epi8(isControl)); mask != 0)
+                return static_cast<size_t>(input - begin) + static_cast<size_t>(std::countr_zero(mask));
+            input += 16;
+        }
+#elif defined(__aarch64__) || defined(_M_ARM64)
+        auto const ControlCodeMax = vdupq_n_u8(0x20);
+        auto const Delete = vdupq_n_u8(0x7F);
+        while (end - input >= 16)
+        {
+            auto const batch = vld1q_u8(reinterpret_cast<uint8_t const*>(input));
+            auto const isControl = vorrq_u8(vcltq_u8(batch, ControlCodeMax), vcgeq_u8(batch, Delete));
+            if (vmaxvq_u8(isControl) != 0)
+            {
+                // Narrow each byte of the mask into a nibble, so that the first match can be found
+                // by counting trailing zero bits.
+                auto const nibbles = vget_lane_u64(
+                    vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(isControl), 4)), 0);
+                return static_cast<size_t>(input - begin)
+                       + static_cast<size_t>(std::countr_zero(nibbles) / 4);
+            }
+            input += 16;
+        }
+#endif
+
+        while (input != end && isPrintableAscii(*input))
+            ++input;
+
+        return static_cast<size_t>(input - begin);
+    }
+} // namespace detail
+
 struct ParserTable
 {
     //! State transition map from (State, Byte) to (State).
@@ -436,6 +516,32 @@ auto Parser<EventListener, TraceStateChanges>::parseBulkText(char const* begin,
     if (!maxCharCount)
         return { ProcessKind::FallbackToFSM, 0 };
 
+    // Fast path for pure 7-bit printable text (such as build logs),
+    // that bypasses the Unicode aware text scanner entirely.
+    if (_scanState.utf8.expectedLength == 0)
+    {
+        auto const available = std::min(static_cast<size_t>(std::distance(input, end)), maxCharCount);
+        auto byteCount = detail::scanPrintableAscii(input, input + available);
+
+        // If the run is followed by non-ASCII, the last character may start a grapheme cluster
+        // (e.g. followed by a combining character), so leave it to the Unicode aware scanner.
+        if (byteCount != 0 && input + byteCount != end && static_cast<uint8_t>(input[byteCount]) >= 0x80)
+            --byteCount;
+
+        if (byteCount != 0)
+        {
+            _eventListener.print(std::string_view(input, byteCount), byteCount);
+            _scanState.lastCodepointHint = static_cast<char32_t>(input[byteCount - 1]);
+            input += byteCount;
+
+            // Same optimization as below for the `(TEXT LF+)+`-case.
+            if (input != end && *input == '\n')
+                _eventListener.execute(*input++);
+
+            return { ProcessKind::ContinueBulk, static_cast<size_t>(std::distance(begin, input)) };
+        }
+    }
+
     _scanState.next = nullptr;
     auto const chunk = std::string_view(input, static_cast<size_t>(std::distance(input, end)));
     auto const [cellCount, subStart, subEnd] = unicode::scan_text(_scanState, chunk, maxCharCount);
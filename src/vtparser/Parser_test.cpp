@@ -65,3 +65,27 @@ TEST_CASE("Parser.APC")
     REQUIRE(listener.apc == "{Gi=1,a=q;}");
     REQUIRE(listener.text == "ABCDEF");
 }
+
+TEST_CASE("Parser.bulk_ascii")
+{
+    MockParserEvents listener;
+    auto p = vtparser::Parser<vtparser::ParserEvents>(listener);
+
+    // Long enough to exercise the vectorized scan and the scalar tail.
+    auto const text = std::string(67, 'A') + "\033[m" + std::string(33, 'B');
+    p.parseFragment(text);
+
+    CHECK(p.state() == vtparser::State::Ground);
+    CHECK(listener.text == std::string(67, 'A') + std::string(33, 'B'));
+    CHECK(p.precedingGraphicCharacter() == U'B');
+}
+
+TEST_CASE("Parser.bulk_ascii_followed_by_combining_character")
+{
+    MockParserEvents listener;
+    auto p = vtparser::Parser<vtparser::ParserEvents>(listener);
+
+    p.parseFragment("Hello, World!e\xCC\x81"sv); // e + U+0301 (COMBINING ACUTE ACCENT)
+
+    CHECK(listener.text == "Hello, World!e\xCC\x81");
+}
@@ -10,6 +10,7 @@
 #include <chrono>
 #include <optional>
 #include <string_view>
+#include <vector>
 
 #include <boxed-cpp/boxed.hpp>
 
@@ -82,6 +83,8 @@ class Pty
     /// @param storage Target buffer to store the read data to.
     /// @param timeout Wait only for up to given timeout before giving up the blocking read attempt.
     /// @param size    The number of bytes to read at most, even if the storage has more bytes available.
+    ///                Implementations may coalesce multiple reads of readily available data
+    ///                into a single result, up to this size.
     ///
     /// @returns A view to the consumed buffer. The boolean in the ReadResult
     ///          indicates whether or not this data was coming through
@@ -98,6 +101,13 @@ class Pty
     /// @notice This is typically implemented using non-blocking I/O.
     virtual void wakeupReader() = 0;
 
+    /// Returns file descriptors that become readable whenever read() would not block,
+    /// including when wakeupReader() has been called.
+    ///
+    /// This allows driving read() from a shared event loop rather than from a dedicated thread.
+    /// An empty list indicates that this PTY does not support that.
+    [[nodiscard]] virtual std::vector<int> pollableDescriptors() const { return {}; }
+
     /// Writes to the PTY device, so the other end can read from it.
     ///
     /// @param buf      Buffer of data to be written.
@@ -58,6 +58,10 @@ namespace vtpty
 
 namespace
 {
+    // Reads returning fewer bytes than this are considered interactive output (such as echoed
+    // keystrokes) and are handed out right away, rather than probing for more data first.
+    constexpr size_t MinFloodReadSize = 1024;
+
     UnixPty::PtyHandles createUnixPty(PageSize const& windowSize, optional<ImageSize> pixels)
     {
         // See https://code.woboq.org/userspace/glibc/login/forkpty.c.html
@@ -271,8 +275,19 @@ void UnixPty::wakeupReader() noexcept
     _readSelector.wakeup();
 }
 
+std::vector<int> UnixPty::pollableDescriptors() const
+{
+#if defined(__linux__)
+    // The read selector's epoll instance covers the master, the stdout-fastpipe, and wakeups.
+    return { _readSelector.native_handle() };
+#else
+    return {};
+#endif
+}
+
 optional<string_view> UnixPty::readSome(int fd, char* target, size_t n) noexcept
 {
+    ++_readStatistics.reads;
     auto const rv = static_cast<int>(::read(fd, target, n));
     if (rv < 0)
     {
@@ -304,15 +319,39 @@ std::optional<Pty::ReadResult> UnixPty::read(crispy::buffer_object<char>& storag
 {
     assert(_readSelector.size() > 0);
 
-    if (auto const fd = _readSelector.wait_one(timeout); fd.has_value())
+    ++_readStatistics.waits;
+    auto const fd = _readSelector.wait_one(timeout);
+    if (!fd.has_value())
     {
-        auto const l = scoped_lock { storage };
-        if (auto x = readSome(*fd, storage.hotEnd(), std::min(size, storage.bytesAvailable())))
-            return ReadResult { .data = x.value(), .fromStdoutFastPipe = *fd == _stdoutFastPipe.reader() };
-    }
-    else
         errno = EAGAIN;
-    return std::nullopt;
+        return std::nullopt;
+    }
+
+    auto const fromStdoutFastPipe = *fd == _stdoutFastPipe.reader();
+    auto const l = scoped_lock { storage };
+    auto const budget = std::min(size, storage.bytesAvailable());
+    auto const first = readSome(*fd, storage.hotEnd(), budget);
+    if (!first)
+        return std::nullopt;
+
+    // Under flood, keep draining the file descriptor until it would block or the budget is used up,
+    // so that the caller gets to process all of it at once, instead of going through another
+    // wait and lock per chunk that the kernel hands out.
+    auto total = first->size();
+    auto lastReadSize = total;
+    while (lastReadSize >= MinFloodReadSize && total < budget)
+    {
+        auto const more = readSome(*fd, storage.hotEnd() + total, budget - total);
+        if (!more || more->empty())
+            break; // Errors and end-of-file are reported by the next call.
+        lastReadSize = more->size();
+        total += lastReadSize;
+    }
+
+    ++_readStatistics.batches;
+    _readStatistics.bytes += total;
+    return ReadResult { .data = string_view { storage.hotEnd(), total },
+                        .fromStdoutFastPipe = fromStdoutFastPipe };
 }
 
 int UnixPty::write(std::string_view data)
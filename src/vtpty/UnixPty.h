@@ -8,6 +8,7 @@
 #include <crispy/file_descriptor.h>
 #include <crispy/read_selector.h>
 
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -48,6 +49,17 @@ class UnixPty final: public Pty
         PtySlaveHandle slave;
     };
 
+    /// Counters about how reading from this PTY performed.
+    ///
+    /// These are only updated by read(), and are thus to be inspected from the reading thread.
+    struct ReadStatistics
+    {
+        uint64_t waits = 0;   // number of waits for readability (select/epoll system calls)
+        uint64_t reads = 0;   // number of read() system calls
+        uint64_t batches = 0; // number of successful read() results, each being processed at once
+        uint64_t bytes = 0;   // number of bytes read in total
+    };
+
     UnixPty(PageSize pageSize, std::optional<ImageSize> pixels);
     ~UnixPty() override;
 
@@ -59,6 +71,7 @@ class UnixPty final: public Pty
     void waitForClosed() override;
     [[nodiscard]] bool isClosed() const noexcept override;
     void wakeupReader() noexcept override;
+    [[nodiscard]] std::vector<int> pollableDescriptors() const override;
     [[nodiscard]] std::optional<ReadResult> read(crispy::buffer_object<char>& storage,
                                                  std::optional<std::chrono::milliseconds> timeout,
                                                  size_t size) override;
@@ -68,6 +81,8 @@ class UnixPty final: public Pty
 
     UnixPipe& stdoutFastPipe() noexcept { return _stdoutFastPipe; }
 
+    [[nodiscard]] ReadStatistics const& readStatistics() const noexcept { return _readStatistics; }
+
   private:
     std::optional<std::string_view> readSome(int fd, char* target, size_t n) noexcept;
 
@@ -78,6 +93,7 @@ class UnixPty final: public Pty
     crispy::read_selector _readSelector;
     PageSize _pageSize;
     std::optional<ImageSize> _pixels;
+    ReadStatistics _readStatistics;
     std::unique_ptr<Slave> _slave;
     std::mutex _mutex;
 };
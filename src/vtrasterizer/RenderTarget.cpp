@@ -47,6 +47,16 @@ auto Renderable::createTileData(atlas::TileLocation tileLocation,
     // clang-format on
 }
 
+void Renderable::relocateTileData(TextureAtlas::TileCreateData& tileData,
+                                  atlas::TileLocation tileLocation) const
+{
+    auto const atlasSize = _textureScheduler->atlasSize();
+    tileData.metadata.normalizedLocation.x =
+        static_cast<float>(tileLocation.x.value) / unbox<float>(atlasSize.width);
+    tileData.metadata.normalizedLocation.y =
+        static_cast<float>(tileLocation.y.value) / unbox<float>(atlasSize.height);
+}
+
 auto Renderable::sliceTileData(Renderable::TextureAtlas::TileCreateData const& createData,
                                TileSliceIndex sliceIndex,
                                atlas::TileLocation tileLocation) -> Renderable::TextureAtlas::TileCreateData
@@ -79,6 +79,15 @@ struct RenderTileAttributes
     ImageSize targetSize {};
 };
 
+/**
+ * Horizontal band of pixel rows spanning the full width of a render target.
+ */
+struct PixelRowBand
+{
+    int top;
+    int height;
+};
+
 /**
  * Terminal render target interface, for example OpenGL, DirectX, or software-rasterization.
  *
@@ -111,6 +120,16 @@ class RenderTarget
     /// Schedules taking a screenshot of the current scene and forwards it to the given callback.
     virtual void scheduleScreenshot(ScreenshotCallback callback) = 0;
 
+    /// Requests the next execute() to only redraw the given bands of pixel rows,
+    /// and to keep the rest of the previously rendered frame.
+    ///
+    /// Render commands scheduled for the next frame may then be restricted to
+    /// what intersects with the given bands.
+    ///
+    /// @returns false if the request cannot be honored, e.g. because the previous frame
+    ///          is not available, in which case the next frame must be rendered in full.
+    virtual bool setDamagedBands(std::vector<PixelRowBand> bands) = 0;
+
     /// Executes all previously scheduled render commands.
     virtual void execute(std::chrono::steady_clock::time_point now) = 0;
 
@@ -161,6 +180,9 @@ class Renderable
                                                               RenderTileAttributes::Y y,
                                                               uint32_t fragmentShaderSelector);
 
+    /// Moves the given tile data to another location in the texture atlas.
+    void relocateTileData(TextureAtlas::TileCreateData& tileData, atlas::TileLocation tileLocation) const;
+
     [[nodiscard]] Renderable::TextureAtlas::TileCreateData sliceTileData(
         Renderable::TextureAtlas::TileCreateData const& createData,
         TileSliceIndex sliceIndex,
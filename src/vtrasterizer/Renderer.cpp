@@ -12,8 +12,10 @@
     #include <text_shaper/directwrite_shaper.h>
 #endif
 
+#include <algorithm>
 #include <array>
 #include <memory>
+#include <utility>
 
 using std::array;
 using std::get;
@@ -35,6 +37,9 @@ namespace vtrasterizer
 namespace
 {
 
+    // Number of cell heights reserved below the atlas' tile grid for packing wide glyphs as a whole.
+    constexpr auto PackedAtlasAreaLineCount = 16u;
+
     void loadGridMetricsFromFont(text::font_key font, GridMetrics& gm, text::shaper& textShaper)
     {
         auto const m = textShaper.metrics(font);
@@ -182,7 +187,8 @@ void Renderer::configureTextureAtlas()
                                  .tileSize = atlasCellSize,
                                  .hashCount = _atlasHashtableSlotCount,
                                  .tileCount = _atlasTileCount,
-                                 .directMappingCount = _directMappingAllocator.currentlyAllocatedCount };
+                                 .directMappingCount = _directMappingAllocator.currentlyAllocatedCount,
+                                 .packedAreaHeight = unbox(atlasCellSize.height) * PackedAtlasAreaLineCount };
 
     Require(atlasProperties.tileCount.value > 0);
 
@@ -221,6 +227,8 @@ void Renderer::executeImageDiscards()
 
 void Renderer::clearCache()
 {
+    _fullRedrawPending = true;
+
     if (!_renderTarget)
         return;
 
@@ -234,6 +242,8 @@ void Renderer::clearCache()
 
 void Renderer::setFonts(FontDescriptions fontDescriptions)
 {
+    _textRenderer.stopBackgroundRasterization();
+
     if (_fontDescriptions.textShapingEngine == fontDescriptions.textShapingEngine)
     {
         _textShaper->clear_cache();
@@ -259,6 +269,7 @@ bool Renderer::setFontSize(text::font_size fontSize)
     if (fontSize.pt > 200.)
         return false;
 
+    _textRenderer.stopBackgroundRasterization();
     _fontDescriptions.size = fontSize;
     _fonts = loadFontKeys(_fontDescriptions, *_textShaper);
     updateFontMetrics();
@@ -270,6 +281,7 @@ void Renderer::updateFontMetrics()
 {
     rendererLog()("Updating grid metrics: {}", _gridMetrics);
 
+    _textRenderer.stopBackgroundRasterization();
     _gridMetrics = loadGridMetrics(_fonts.regular, _gridMetrics.pageSize, *_textShaper);
 
     if (_renderTarget)
@@ -281,10 +293,62 @@ void Renderer::updateFontMetrics()
     clearCache();
 }
 
+bool Renderer::prepareDamagedLines(vtbackend::RenderBuffer const& renderBuffer)
+{
+    auto const lastRenderedFrameID = std::exchange(_lastRenderedFrameID, renderBuffer.frameID);
+    auto const fullRedrawPending = std::exchange(_fullRedrawPending, false);
+
+    // The dirty lines of a render buffer are only relative to the frame right before it,
+    // so frames that have been skipped require a full redraw.
+    if (fullRedrawPending || renderBuffer.allLinesDirty
+        || (renderBuffer.frameID != lastRenderedFrameID && renderBuffer.frameID != lastRenderedFrameID + 1))
+        return false;
+
+    auto const lineCount = unbox<size_t>(_gridMetrics.pageSize.lines);
+    _damagedLines.assign(lineCount, false);
+
+    auto const markDamaged = [&](vtbackend::LineOffset line) {
+        // The neighbouring lines are redrawn, too, as glyphs may overflow into them.
+        auto const first = static_cast<size_t>(std::max(0, unbox<int>(line) - 1));
+        auto const last = std::min(lineCount, static_cast<size_t>(std::max(0, unbox<int>(line) + 2)));
+        for (auto i = first; i < last; ++i)
+            _damagedLines[i] = true;
+    };
+
+    // Rendering the same frame again does not require any line to be redrawn,
+    // except for those that lacked glyphs being rasterized in the background.
+    if (renderBuffer.frameID != lastRenderedFrameID)
+        for (auto const line: renderBuffer.dirtyLines)
+            markDamaged(line);
+    for (auto const line: _placeholderLines)
+        markDamaged(line);
+
+    auto bands = vector<PixelRowBand> {};
+    for (size_t line = 0; line < lineCount;)
+    {
+        if (!_damagedLines[line])
+        {
+            ++line;
+            continue;
+        }
+        auto const first = line;
+        while (line < lineCount && _damagedLines[line])
+            ++line;
+        auto const top = first == 0 ? 0 : _gridMetrics.mapTopLeft(vtbackend::LineOffset::cast_from(first), {}).y;
+        auto const bottom = _gridMetrics.mapTopLeft(vtbackend::LineOffset::cast_from(line), {}).y;
+        bands.emplace_back(PixelRowBand { .top = top, .height = bottom - top });
+    }
+
+    return _renderTarget->setDamagedBands(std::move(bands));
+}
+
 void Renderer::render(vtbackend::Terminal& terminal, bool pressure)
 {
     auto const statusLineHeight = terminal.statusLineHeight();
-    _gridMetrics.pageSize = terminal.pageSize() + statusLineHeight;
+    auto const pageSize = terminal.pageSize() + statusLineHeight;
+    if (_gridMetrics.pageSize != pageSize)
+        _fullRedrawPending = true;
+    _gridMetrics.pageSize = pageSize;
 
     executeImageDiscards();
 
@@ -301,14 +365,19 @@ void Renderer::render(vtbackend::Terminal& terminal, bool pressure)
     _textRenderer.setPressure(pressure && terminal.isPrimaryScreen());
     {
         vtbackend::RenderBufferRef const renderBuffer = terminal.renderBuffer();
+        _partialRedraw = prepareDamagedLines(renderBuffer.get());
         cursorOpt = renderBuffer.get().cursor;
-        renderCells(renderBuffer.get().cells);
+        renderCells(renderBuffer.get());
         renderLines(renderBuffer.get().lines);
     }
     _textRenderer.endFrame();
     _imageRenderer.endFrame();
 
-    if (cursorOpt && cursorOpt.value().shape != vtbackend::CursorShape::Block)
+    // Lines rendered with placeholders for glyphs still being rasterized are drawn again with the next frame.
+    _placeholderLines = _textRenderer.placeholderLines();
+
+    if (cursorOpt && cursorOpt.value().shape != vtbackend::CursorShape::Block
+        && isLineDamaged(cursorOpt.value().position.line))
     {
         // Note. Block cursor is implicitly rendered via standard grid cell rendering.
         auto const cursor = *cursorOpt;
@@ -327,15 +396,17 @@ void Renderer::render(vtbackend::Terminal& terminal, bool pressure)
     _renderTarget->execute(terminal.currentTime());
 }
 
-void Renderer::renderCells(vector<vtbackend::RenderCell> const& renderableCells)
+void Renderer::renderCells(vtbackend::RenderBuffer const& renderBuffer)
 {
-    for (vtbackend::RenderCell const& cell: renderableCells)
+    for (vtbackend::RenderCell const& cell: renderBuffer.cells)
     {
+        if (!isLineDamaged(cell.position.line))
+            continue;
         _backgroundRenderer.renderCell(cell);
         _decorationRenderer.renderCell(cell);
-        _textRenderer.renderCell(cell);
-        if (cell.image)
-            _imageRenderer.renderImage(_gridMetrics.map(cell.position), *cell.image);
+        _textRenderer.renderCell(cell, renderBuffer.codepointsOf(cell));
+        if (auto const* image = renderBuffer.imageOf(cell))
+            _imageRenderer.renderImage(_gridMetrics.map(cell.position), *image);
     }
 }
 
@@ -343,6 +414,8 @@ void Renderer::renderLines(vector<vtbackend::RenderLine> const& renderableLines)
 {
     for (vtbackend::RenderLine const& line: renderableLines)
     {
+        if (!isLineDamaged(line.lineOffset))
+            continue;
         _backgroundRenderer.renderLine(line);
         _decorationRenderer.renderLine(line);
         _textRenderer.renderLine(line);
@@ -20,6 +20,7 @@
 #include <gsl/pointers>
 
 #include <format>
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -80,6 +81,7 @@ class Renderer
     void setHyperlinkDecoration(Decorator normal, Decorator hover)
     {
         _decorationRenderer.setHyperlinkDecoration(normal, hover);
+        _fullRedrawPending = true;
     }
 
     void setPageSize(vtbackend::PageSize screenSize) noexcept { _gridMetrics.pageSize = screenSize; }
@@ -89,6 +91,7 @@ class Renderer
         if (_renderTarget)
             _renderTarget->setMargin(margin);
         _gridMetrics.pageMargin = margin;
+        _fullRedrawPending = true;
     }
 
     /**
@@ -104,6 +107,17 @@ class Renderer
      */
     void render(vtbackend::Terminal& terminal, bool pressureHint);
 
+    /// Indicates whether the last rendered frame lacks glyphs still being rasterized in the background,
+    /// and another frame is to be rendered to show them.
+    [[nodiscard]] bool hasPendingGlyphs() const noexcept { return _textRenderer.hasPendingGlyphs(); }
+
+    /// Sets the callback to be invoked from a background thread once glyphs missing in the last frame
+    /// have been rasterized, and another frame is to be rendered to show them.
+    void setGlyphsRasterizedCallback(std::function<void()> callback)
+    {
+        _textRenderer.setGlyphsRasterizedCallback(std::move(callback));
+    }
+
     void discardImage(vtbackend::Image const& image);
 
     void clearCache();
@@ -126,10 +140,24 @@ class Renderer
 
   private:
     void configureTextureAtlas();
-    void renderCells(std::vector<vtbackend::RenderCell> const& renderableCells);
+    void renderCells(vtbackend::RenderBuffer const& renderBuffer);
     void renderLines(std::vector<vtbackend::RenderLine> const& renderableLines);
     void executeImageDiscards();
 
+    /// Determines the screen lines to be redrawn for the given render buffer
+    /// and restricts the render target's next frame to them.
+    ///
+    /// @returns true if only the lines marked in _damagedLines are to be rendered,
+    ///          false if the full page is to be rendered.
+    bool prepareDamagedLines(vtbackend::RenderBuffer const& renderBuffer);
+
+    [[nodiscard]] bool isLineDamaged(vtbackend::LineOffset line) const noexcept
+    {
+        return !_partialRedraw
+               || (line >= vtbackend::LineOffset(0) && unbox<size_t>(line) < _damagedLines.size()
+                   && _damagedLines[unbox<size_t>(line)]);
+    }
+
     crispy::strong_hashtable_size _atlasHashtableSlotCount;
     crispy::lru_capacity _atlasTileCount;
     bool _atlasDirectMapping;
@@ -147,6 +175,12 @@ class Renderer
 
     vtbackend::ColorPalette const& _colorPalette;
 
+    uint64_t _lastRenderedFrameID = 0;
+    bool _fullRedrawPending = true;
+    bool _partialRedraw = false;
+    std::vector<bool> _damagedLines;                      // Indexed by screen line offset.
+    std::vector<vtbackend::LineOffset> _placeholderLines; // Lines lacking pending glyphs in the last frame.
+
     std::mutex _imageDiscardLock;                       //!< Lock guard for accessing _discardImageQueue.
     std::vector<vtbackend::ImageId> _discardImageQueue; //!< List of images to be discarded.
 
@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtrasterizer/ShelfPacker.h>
+
+using std::nullopt;
+using std::optional;
+
+namespace vtrasterizer::atlas
+{
+
+auto ShelfPacker::allocate(uint32_t width, uint32_t height) -> optional<Allocation>
+{
+    if (!width || !height || width > _width || height > _height)
+        return nullopt;
+
+    // Find the shelf with the least height to spare, that still has room left.
+    auto bestFit = optional<uint32_t> {};
+    for (uint32_t i = 0; i < _shelves.size(); ++i)
+    {
+        auto const& shelf = _shelves[i];
+        if (shelf.height >= height && _width - shelf.usedWidth >= width
+            && (!bestFit || shelf.height < _shelves[*bestFit].height))
+            bestFit = i;
+    }
+
+    // Shelves wasting no more than a quarter of their height are always good enough.
+    if (bestFit && (_shelves[*bestFit].height - height) * 4 <= _shelves[*bestFit].height)
+        return place(*bestFit, width);
+
+    if (_height - _usedHeight >= height)
+    {
+        _shelves.emplace_back(Shelf { .y = _usedHeight, .height = height, .usedWidth = 0, .lastUse = 0 });
+        _usedHeight += height;
+        return place(static_cast<uint32_t>(_shelves.size() - 1), width);
+    }
+
+    if (bestFit)
+        return place(*bestFit, width);
+
+    // Evict the least recently used shelf being tall enough.
+    auto victim = optional<uint32_t> {};
+    for (uint32_t i = 0; i < _shelves.size(); ++i)
+    {
+        auto const& shelf = _shelves[i];
+        if (shelf.height >= height && (!victim || shelf.lastUse < _shelves[*victim].lastUse))
+            victim = i;
+    }
+
+    if (!victim)
+        return nullopt;
+
+    _shelves[*victim].usedWidth = 0;
+    return place(*victim, width, victim);
+}
+
+auto ShelfPacker::place(uint32_t shelf, uint32_t width, optional<uint32_t> evictedShelf) -> Allocation
+{
+    auto& target = _shelves[shelf];
+    auto const x = target.usedWidth;
+    target.usedWidth += width;
+    target.lastUse = ++_clock;
+    return Allocation { .shelf = shelf, .x = x, .y = target.y, .evictedShelf = evictedShelf };
+}
+
+void ShelfPacker::clear() noexcept
+{
+    _shelves.clear();
+    _usedHeight = 0;
+}
+
+} // namespace vtrasterizer::atlas
@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace vtrasterizer::atlas
+{
+
+/**
+ * Packs rectangles of variable size into a fixed area, using shelves of uniform height.
+ *
+ * Rectangles are placed left to right onto the best fitting shelf,
+ * and new shelves are stacked top to bottom until the area is exhausted.
+ *
+ * Space is only ever reclaimed by whole shelves, evicting the least recently used
+ * shelf that is tall enough for the rectangle to be allocated.
+ */
+class ShelfPacker
+{
+  public:
+    struct Allocation
+    {
+        uint32_t shelf; // Index of the shelf holding the rectangle.
+        uint32_t x;     // Left offset of the rectangle into the packed area.
+        uint32_t y;     // Top offset of the rectangle into the packed area.
+
+        // Shelf whose rectangles have been evicted to make room for this allocation, if any.
+        std::optional<uint32_t> evictedShelf;
+    };
+
+    ShelfPacker(uint32_t width, uint32_t height) noexcept: _width { width }, _height { height } {}
+
+    /// Allocates a rectangle of the given size, evicting the least recently used shelf if needed.
+    ///
+    /// @returns the allocation or std::nullopt if the rectangle does not fit, even when evicting.
+    [[nodiscard]] std::optional<Allocation> allocate(uint32_t width, uint32_t height);
+
+    /// Marks the given shelf as most recently used.
+    void touch(uint32_t shelf) noexcept { _shelves[shelf].lastUse = ++_clock; }
+
+    /// Releases all shelves.
+    void clear() noexcept;
+
+    [[nodiscard]] uint32_t width() const noexcept { return _width; }
+    [[nodiscard]] uint32_t height() const noexcept { return _height; }
+    [[nodiscard]] size_t shelfCount() const noexcept { return _shelves.size(); }
+    [[nodiscard]] uint32_t usedHeight() const noexcept { return _usedHeight; }
+
+  private:
+    struct Shelf
+    {
+        uint32_t y;
+        uint32_t height;
+        uint32_t usedWidth;
+        uint64_t lastUse;
+    };
+
+    Allocation place(uint32_t shelf, uint32_t width, std::optional<uint32_t> evictedShelf = std::nullopt);
+
+    uint32_t _width;
+    uint32_t _height;
+    uint32_t _usedHeight = 0;
+    uint64_t _clock = 0;
+    std::vector<Shelf> _shelves;
+};
+
+} // namespace vtrasterizer::atlas
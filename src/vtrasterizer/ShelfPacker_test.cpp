@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtrasterizer/ShelfPacker.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+using vtrasterizer::atlas::ShelfPacker;
+
+TEST_CASE("ShelfPacker.allocate.shelves", "[ShelfPacker]")
+{
+    auto packer = ShelfPacker(100, 50);
+
+    auto a = packer.allocate(40, 20);
+    REQUIRE(a.has_value());
+    CHECK(a->shelf == 0);
+    CHECK(a->x == 0);
+    CHECK(a->y == 0);
+    CHECK(!a->evictedShelf);
+
+    auto b = packer.allocate(40, 18);
+    REQUIRE(b.has_value());
+    CHECK(b->shelf == 0);
+    CHECK(b->x == 40);
+    CHECK(b->y == 0);
+
+    // Not fitting into the rest of the first shelf.
+    auto c = packer.allocate(30, 20);
+    REQUIRE(c.has_value());
+    CHECK(c->shelf == 1);
+    CHECK(c->x == 0);
+    CHECK(c->y == 20);
+
+    CHECK(packer.shelfCount() == 2);
+    CHECK(packer.usedHeight() == 40);
+}
+
+TEST_CASE("ShelfPacker.allocate.best_fit", "[ShelfPacker]")
+{
+    auto packer = ShelfPacker(100, 100);
+    REQUIRE(packer.allocate(10, 40).has_value());
+    REQUIRE(packer.allocate(10, 20).has_value());
+
+    // Goes onto the shelf of height 20 rather than 40.
+    auto a = packer.allocate(10, 16);
+    REQUIRE(a.has_value());
+    CHECK(a->shelf == 1);
+    CHECK(a->x == 10);
+
+    // Would waste too much of the existing shelves, so a new one is opened.
+    auto b = packer.allocate(10, 8);
+    REQUIRE(b.has_value());
+    CHECK(b->shelf == 2);
+    CHECK(b->y == 60);
+}
+
+TEST_CASE("ShelfPacker.allocate.evict_least_recently_used", "[ShelfPacker]")
+{
+    auto packer = ShelfPacker(20, 40);
+    REQUIRE(packer.allocate(20, 20).has_value()); // shelf 0
+    REQUIRE(packer.allocate(20, 20).has_value()); // shelf 1
+    packer.touch(0);
+
+    auto a = packer.allocate(15, 20);
+    REQUIRE(a.has_value());
+    CHECK(a->shelf == 1);
+    CHECK(a->x == 0);
+    CHECK(a->y == 20);
+    CHECK(a->evictedShelf == 1u);
+
+    // Shelf 0 is least recently used now.
+    auto b = packer.allocate(10, 10);
+    REQUIRE(b.has_value());
+    CHECK(b->shelf == 0);
+    CHECK(b->evictedShelf == 0u);
+}
+
+TEST_CASE("ShelfPacker.allocate.too_large", "[ShelfPacker]")
+{
+    auto packer = ShelfPacker(20, 40);
+    CHECK(!packer.allocate(21, 10).has_value());
+    CHECK(!packer.allocate(10, 41).has_value());
+    CHECK(!packer.allocate(0, 10).has_value());
+
+    // No shelf being tall enough to be evicted.
+    REQUIRE(packer.allocate(20, 30).has_value());
+    REQUIRE(packer.allocate(20, 10).has_value());
+    CHECK(!packer.allocate(10, 35).has_value());
+
+    packer.clear();
+    CHECK(packer.allocate(10, 35).has_value());
+}
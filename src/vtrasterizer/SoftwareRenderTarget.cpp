@@ -0,0 +1,361 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtrasterizer/SoftwareRenderTarget.h>
+#include <vtrasterizer/shared_defines.h>
+
+#include <crispy/assert.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <format>
+
+using std::max;
+using std::min;
+
+namespace vtrasterizer
+{
+
+namespace
+{
+    constexpr auto BytesPerPixel = size_t { 4 };
+
+    /// Divides by 255, rounding to nearest, for values up to 255 * 255 * 2.
+    constexpr uint32_t div255(uint32_t value) noexcept
+    {
+        value += 128;
+        return (value + (value >> 8)) >> 8;
+    }
+
+    constexpr uint32_t toByte(float value) noexcept
+    {
+        return static_cast<uint32_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+
+    /// Blends the given (straight alpha) color onto the premultiplied pixel,
+    /// i.e. (SRC_ALPHA, ONE_MINUS_SRC_ALPHA) for the color and (ONE, ONE_MINUS_SRC_ALPHA) for the alpha.
+    ///
+    /// Kept branch free, so that the loops over a row of pixels can be vectorized by the compiler.
+    inline void blendPixel(uint8_t* pixel, uint32_t r, uint32_t g, uint32_t b, uint32_t a) noexcept
+    {
+        auto const inverse = 255 - a;
+        pixel[0] = static_cast<uint8_t>(div255((r * a) + (pixel[0] * inverse)));
+        pixel[1] = static_cast<uint8_t>(div255((g * a) + (pixel[1] * inverse)));
+        pixel[2] = static_cast<uint8_t>(div255((b * a) + (pixel[2] * inverse)));
+        pixel[3] = static_cast<uint8_t>(div255((a * 255) + (pixel[3] * inverse)));
+    }
+} // namespace
+
+SoftwareRenderTarget::SoftwareRenderTarget(ImageSize renderSize)
+{
+    setRenderSize(renderSize);
+}
+
+// {{{ RenderTarget impl
+void SoftwareRenderTarget::setRenderSize(ImageSize size)
+{
+    if (_renderSize == size && !_frame.pixels.empty())
+        return;
+
+    _renderSize = size;
+    _frame.pixels.assign(size.area() * BytesPerPixel, 0);
+    _frame.valid = false;
+}
+
+void SoftwareRenderTarget::setMargin(PageMargin margin)
+{
+    _margin = margin;
+    _frame.valid = false;
+}
+
+void SoftwareRenderTarget::renderRectangle(int x, int y, Width width, Height height, RGBAColor color)
+{
+    _rectangles.emplace_back(Rectangle { x, y, unbox<int>(width), unbox<int>(height), color });
+}
+
+void SoftwareRenderTarget::scheduleScreenshot(ScreenshotCallback callback)
+{
+    _pendingScreenshotCallback = std::move(callback);
+}
+
+bool SoftwareRenderTarget::setDamagedBands(std::vector<PixelRowBand> bands)
+{
+    if (!_frame.valid)
+        return false;
+
+    _damagedBands = std::move(bands);
+    return true;
+}
+
+void SoftwareRenderTarget::execute(std::chrono::steady_clock::time_point /*now*/)
+{
+    auto const height = unbox<int>(_renderSize.height);
+
+    if (_damagedBands && _frame.valid)
+    {
+        // Only redraw the damaged row bands, leaving everything else as rendered by previous frames.
+        for (auto const& band: *_damagedBands)
+            drawScene(RowClip { .top = max(band.top, 0), .bottom = min(band.top + band.height, height) });
+    }
+    else
+        drawScene(RowClip { .top = 0, .bottom = height });
+
+    _frame.valid = true;
+    _damagedBands.reset();
+    _rectangles.clear();
+    _tiles.clear();
+
+    if (_pendingScreenshotCallback)
+    {
+        _pendingScreenshotCallback.value()(_frame.pixels, _renderSize);
+        _pendingScreenshotCallback.reset();
+    }
+}
+
+void SoftwareRenderTarget::clearCache()
+{
+    _frame.valid = false;
+}
+
+std::optional<AtlasTextureScreenshot> SoftwareRenderTarget::readAtlas()
+{
+    return AtlasTextureScreenshot {
+        .atlasInstanceId = 0,
+        .size = _atlas.size,
+        .format = _atlas.properties.format,
+        .buffer = _atlas.pixels,
+    };
+}
+
+void SoftwareRenderTarget::inspect(std::ostream& output) const
+{
+    output << std::format("SoftwareRenderTarget: render size {}, atlas size {}, {} rectangles, {} tiles\n",
+                          _renderSize,
+                          _atlas.size,
+                          _rectangles.size(),
+                          _tiles.size());
+}
+
+RGBAColor SoftwareRenderTarget::pixelAt(int x, int y) const noexcept
+{
+    auto const* pixel =
+        _frame.pixels.data() + ((size_t(y) * unbox<size_t>(_renderSize.width)) + size_t(x)) * BytesPerPixel;
+    return RGBAColor { pixel[0], pixel[1], pixel[2], pixel[3] };
+}
+// }}}
+
+// {{{ AtlasBackend impl
+void SoftwareRenderTarget::configureAtlas(atlas::ConfigureAtlas atlas)
+{
+    Require(atlas.properties.format == atlas::Format::RGBA);
+
+    _atlas.size = atlas.size;
+    _atlas.properties = atlas.properties;
+    _atlas.pixels.assign(atlas.size.area() * BytesPerPixel, 0);
+}
+
+void SoftwareRenderTarget::uploadTile(atlas::UploadTile tile)
+{
+    auto const componentCount = element_count(tile.bitmapFormat);
+    auto const atlasWidth = unbox<size_t>(_atlas.size.width);
+    auto const atlasHeight = unbox<size_t>(_atlas.size.height);
+    auto const x = size_t { tile.location.x.value };
+    auto const y = size_t { tile.location.y.value };
+    auto const width = min(unbox<size_t>(tile.bitmapSize.width), atlasWidth - min(x, atlasWidth));
+    auto const height = min(unbox<size_t>(tile.bitmapSize.height), atlasHeight - min(y, atlasHeight));
+    auto const sourcePitch = unbox<size_t>(tile.bitmapSize.width) * componentCount;
+
+    // Converts to RGBA just like the OpenGL renderer does.
+    for (size_t row = 0; row < height; ++row)
+    {
+        auto const* source = tile.bitmap.data() + (row * sourcePitch);
+        auto* target = _atlas.pixels.data() + ((((y + row) * atlasWidth) + x) * BytesPerPixel);
+        for (size_t column = 0; column < width; ++column, source += componentCount, target += BytesPerPixel)
+        {
+            switch (tile.bitmapFormat)
+            {
+                case atlas::Format::Red:
+                    target[0] = source[0];
+                    target[1] = target[2] = 0;
+                    target[3] = 0xFF;
+                    break;
+                case atlas::Format::RGB:
+                    std::copy_n(source, 3, target);
+                    target[3] = 0xFF;
+                    break;
+                case atlas::Format::RGBA: std::copy_n(source, 4, target); break;
+            }
+        }
+    }
+}
+
+void SoftwareRenderTarget::renderTile(atlas::RenderTile tile)
+{
+    _tiles.emplace_back(tile);
+}
+// }}}
+
+// {{{ rasterization
+void SoftwareRenderTarget::drawScene(RowClip clip)
+{
+    if (clip.top >= clip.bottom)
+        return;
+
+    auto const pitch = unbox<size_t>(_renderSize.width) * BytesPerPixel;
+    std::fill(_frame.pixels.begin() + static_cast<ptrdiff_t>(size_t(clip.top) * pitch),
+              _frame.pixels.begin() + static_cast<ptrdiff_t>(size_t(clip.bottom) * pitch),
+              uint8_t { 0 });
+
+    for (auto const& rectangle: _rectangles)
+        fillRectangle(rectangle, clip);
+
+    for (auto const& tile: _tiles)
+        drawTile(tile, clip);
+}
+
+void SoftwareRenderTarget::fillRectangle(Rectangle const& rectangle, RowClip clip)
+{
+    auto const frameWidth = unbox<int>(_renderSize.width);
+    auto const top = max(rectangle.y, clip.top);
+    auto const bottom = min(rectangle.y + rectangle.height, clip.bottom);
+    auto const left = max(rectangle.x, 0);
+    auto const right = min(rectangle.x + rectangle.width, frameWidth);
+    if (left >= right)
+        return;
+
+    auto const color = rectangle.color;
+    for (auto row = top; row < bottom; ++row)
+    {
+        auto* pixel =
+            _frame.pixels.data() + (((size_t(row) * size_t(frameWidth)) + size_t(left)) * BytesPerPixel);
+        for (auto column = left; column < right; ++column, pixel += BytesPerPixel)
+            blendPixel(pixel, color.red(), color.green(), color.blue(), color.alpha());
+    }
+}
+
+void SoftwareRenderTarget::drawTile(atlas::RenderTile const& tile, RowClip clip)
+{
+    auto const atlasWidth = unbox<int>(_atlas.size.width);
+    auto const atlasHeight = unbox<int>(_atlas.size.height);
+    auto const frameWidth = unbox<int>(_renderSize.width);
+
+    // Source rectangle, as addressed by the normalized texture coordinates.
+    auto const sourceX = static_cast<int>(std::lround(tile.normalizedLocation.x * float(atlasWidth)));
+    auto const sourceY = static_cast<int>(std::lround(tile.normalizedLocation.y * float(atlasHeight)));
+    auto const sourceWidth = static_cast<int>(std::lround(tile.normalizedLocation.width * float(atlasWidth)));
+    auto const sourceHeight =
+        static_cast<int>(std::lround(tile.normalizedLocation.height * float(atlasHeight)));
+
+    // Target rectangle, the bitmap being scaled to the target size, if one is given.
+    auto const targetWidth = unbox<int>(tile.targetSize.width) ? unbox<int>(tile.targetSize.width)
+                                                                : unbox<int>(tile.bitmapSize.width);
+    auto const targetHeight = unbox<int>(tile.targetSize.height) ? unbox<int>(tile.targetSize.height)
+                                                                  : unbox<int>(tile.bitmapSize.height);
+
+    if (sourceWidth <= 0 || sourceHeight <= 0 || targetWidth <= 0 || targetHeight <= 0)
+        return;
+
+    auto const top = max(tile.y.value, clip.top);
+    auto const bottom = min(tile.y.value + targetHeight, clip.bottom);
+    auto const left = max(tile.x.value, 0);
+    auto const right = min(tile.x.value + targetWidth, frameWidth);
+
+    if (top >= bottom || left >= right)
+        return;
+
+    // Nearest neighbour sampling at the pixel centers, as the atlas texture is not filtered either.
+    auto const sourceOffset = [](int offset, int sourceSize, int targetSize) {
+        return sourceSize == targetSize ? offset : (((2 * offset) + 1) * sourceSize) / (2 * targetSize);
+    };
+
+    // Unscaled tiles within the atlas are walked linearly, all others through a column map computed once.
+    auto const firstSourceColumn = sourceX + (left - tile.x.value);
+    auto const isLinear = sourceWidth == targetWidth && firstSourceColumn >= 0
+                          && firstSourceColumn + (right - left) <= atlasWidth;
+    if (!isLinear)
+    {
+        _sourceColumnOffsets.resize(size_t(right - left));
+        for (auto column = left; column < right; ++column)
+            _sourceColumnOffsets[size_t(column - left)] =
+                size_t(std::clamp(sourceX + sourceOffset(column - tile.x.value, sourceWidth, targetWidth),
+                                  0,
+                                  atlasWidth - 1))
+                * BytesPerPixel;
+    }
+
+    auto const forEachTexel = [&](auto const& shade) {
+        for (auto row = top; row < bottom; ++row)
+        {
+            auto const sourceRow =
+                std::clamp(sourceY + sourceOffset(row - tile.y.value, sourceHeight, targetHeight),
+                           0,
+                           atlasHeight - 1);
+            auto const* texels =
+                _atlas.pixels.data() + (size_t(sourceRow) * size_t(atlasWidth) * BytesPerPixel);
+            auto* pixel =
+                _frame.pixels.data() + (((size_t(row) * size_t(frameWidth)) + size_t(left)) * BytesPerPixel);
+            auto* const pixelsEnd = pixel + (size_t(right - left) * BytesPerPixel);
+            if (isLinear)
+            {
+                auto const* texel = texels + (size_t(firstSourceColumn) * BytesPerPixel);
+                for (; pixel != pixelsEnd; pixel += BytesPerPixel, texel += BytesPerPixel)
+                    shade(pixel, texel);
+            }
+            else
+            {
+                for (auto const* offset = _sourceColumnOffsets.data(); pixel != pixelsEnd;
+                     pixel += BytesPerPixel, ++offset)
+                    shade(pixel, texels + *offset);
+            }
+        }
+    };
+
+    auto const r = toByte(tile.color[0]);
+    auto const g = toByte(tile.color[1]);
+    auto const b = toByte(tile.color[2]);
+    auto const a = toByte(tile.color[3]);
+
+    // The shading mirrors the text fragment shader (see text.frag).
+    switch (tile.fragmentShaderSelector)
+    {
+        case FRAGMENT_SELECTOR_IMAGE_BGRA:
+            forEachTexel([](uint8_t* pixel, uint8_t const* texel) {
+                blendPixel(pixel, texel[0], texel[1], texel[2], texel[3]);
+            });
+            break;
+        case FRAGMENT_SELECTOR_GLYPH_LCD_SIMPLE:
+            forEachTexel([&](uint8_t* pixel, uint8_t const* texel) {
+                blendPixel(pixel,
+                           div255(texel[0] * r),
+                           div255(texel[1] * g),
+                           div255(texel[2] * b),
+                           (uint32_t(texel[0]) + texel[1] + texel[2]) / 3);
+            });
+            break;
+        case FRAGMENT_SELECTOR_GLYPH_LCD:
+            forEachTexel([&](uint8_t* pixel, uint8_t const* texel) {
+                auto const tr = float(texel[0]) / 255.0f;
+                auto const tg = float(texel[1]) / 255.0f;
+                auto const tb = float(texel[2]) / 255.0f;
+                auto const rgbMax = max(max(tr, tg), tb);
+                auto const rgbMin = min(min(tr, tg), tb);
+                auto const rgbAvg = (tr + tg + tb) / 3.0f;
+                auto const complement = 1.0f - rgbMax;
+                blendPixel(pixel,
+                           toByte((tile.color[0] * rgbMax) + (tr * complement)),
+                           toByte((tile.color[1] * rgbMax) + (tg * complement)),
+                           toByte((tile.color[2] * rgbMax) + (tb * complement)),
+                           toByte(((rgbAvg * rgbMax) + (rgbMin * complement)) * tile.color[3]));
+            });
+            break;
+        case FRAGMENT_SELECTOR_GLYPH_ALPHA:
+        default:
+            // Using the red channel as alpha mask of an anti-aliased glyph.
+            forEachTexel([&](uint8_t* pixel, uint8_t const* texel) {
+                blendPixel(pixel, r, g, b, div255(texel[0] * a));
+            });
+            break;
+    }
+}
+// }}}
+
+} // namespace vtrasterizer
@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <vtbackend/Color.h>
+#include <vtbackend/primitives.h>
+
+#include <vtrasterizer/RenderTarget.h>
+#include <vtrasterizer/TextureAtlas.h>
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+namespace vtrasterizer
+{
+
+/**
+ * Render target rasterizing on the CPU into an RGBA frame buffer in main memory.
+ *
+ * This allows rendering frames without any GPU or windowing system, e.g. for benchmarking
+ * the render pipeline or for pixel-exact regression tests.
+ *
+ * Scheduled rectangles and tiles are blended the same way as by the OpenGL renderer's shaders,
+ * rectangles first, and the frame buffer holds premultiplied colors, with rows from top to bottom.
+ *
+ * @see OpenGLRenderer
+ */
+class SoftwareRenderTarget final: public RenderTarget, public atlas::AtlasBackend
+{
+  public:
+    explicit SoftwareRenderTarget(ImageSize renderSize);
+
+    // RenderTarget implementation
+    void setRenderSize(ImageSize size) override;
+    void setMargin(PageMargin margin) override;
+    atlas::AtlasBackend& textureScheduler() override { return *this; }
+    void renderRectangle(int x, int y, Width width, Height height, RGBAColor color) override;
+    void scheduleScreenshot(ScreenshotCallback callback) override;
+    bool setDamagedBands(std::vector<PixelRowBand> bands) override;
+    void execute(std::chrono::steady_clock::time_point now) override;
+    void clearCache() override;
+    std::optional<AtlasTextureScreenshot> readAtlas() override;
+    void inspect(std::ostream& output) const override;
+
+    // AtlasBackend implementation
+    [[nodiscard]] ImageSize atlasSize() const noexcept override { return _atlas.size; }
+    void configureAtlas(atlas::ConfigureAtlas atlas) override;
+    void uploadTile(atlas::UploadTile tile) override;
+    void renderTile(atlas::RenderTile tile) override;
+
+    [[nodiscard]] ImageSize renderSize() const noexcept { return _renderSize; }
+
+    /// Returns the most recently rendered frame (RGBA, 8 bits per component).
+    [[nodiscard]] std::vector<uint8_t> const& frame() const noexcept { return _frame.pixels; }
+
+    /// Returns the pixel at the given position of the most recently rendered frame.
+    [[nodiscard]] RGBAColor pixelAt(int x, int y) const noexcept;
+
+  private:
+    struct Rectangle
+    {
+        int x;
+        int y;
+        int width;
+        int height;
+        RGBAColor color;
+    };
+
+    /// Rows [top, bottom) of the frame buffer to be drawn into.
+    struct RowClip
+    {
+        int top;
+        int bottom;
+    };
+
+    void drawScene(RowClip clip);
+    void fillRectangle(Rectangle const& rectangle, RowClip clip);
+    void drawTile(atlas::RenderTile const& tile, RowClip clip);
+
+    ImageSize _renderSize;
+    PageMargin _margin {};
+
+    // The texture atlas, always stored as RGBA.
+    struct
+    {
+        ImageSize size {};
+        atlas::AtlasProperties properties {};
+        std::vector<uint8_t> pixels;
+    } _atlas;
+
+    // Render commands scheduled for the next frame.
+    std::vector<Rectangle> _rectangles;
+    std::vector<atlas::RenderTile> _tiles;
+
+    // Byte offsets of the atlas columns sampled by the tile being drawn, reused across tiles.
+    std::vector<size_t> _sourceColumnOffsets;
+
+    struct
+    {
+        std::vector<uint8_t> pixels;
+        bool valid = false; // Indicates whether or not the frame buffer holds a complete frame.
+    } _frame;
+    std::optional<std::vector<PixelRowBand>> _damagedBands;
+
+    std::optional<ScreenshotCallback> _pendingScreenshotCallback;
+};
+
+} // namespace vtrasterizer
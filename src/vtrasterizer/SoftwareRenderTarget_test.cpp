@@ -0,0 +1,146 @@
+// SPDX-License-Identifier: Apache-2.0
+#include <vtrasterizer/SoftwareRenderTarget.h>
+#include <vtrasterizer/shared_defines.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+
+using namespace vtrasterizer;
+
+namespace
+{
+
+auto const Now = std::chrono::steady_clock::time_point {};
+
+SoftwareRenderTarget createTarget(int width, int height)
+{
+    auto target = SoftwareRenderTarget { ImageSize { Width(width), Height(height) } };
+    target.configureAtlas(atlas::ConfigureAtlas {
+        .size = ImageSize { Width(16), Height(16) },
+        .properties = atlas::AtlasProperties { .format = atlas::Format::RGBA,
+                                               .tileSize = ImageSize { Width(4), Height(4) } },
+    });
+    return target;
+}
+
+/// Uploads a 2x2 glyph mask to the atlas origin, with the given coverage per pixel.
+void uploadGlyph(SoftwareRenderTarget& target, std::array<uint8_t, 4> coverage)
+{
+    target.uploadTile(atlas::UploadTile {
+        .location = atlas::TileLocation {},
+        .bitmap = atlas::Buffer(coverage.begin(), coverage.end()),
+        .bitmapSize = ImageSize { Width(2), Height(2) },
+        .bitmapFormat = atlas::Format::Red,
+    });
+}
+
+atlas::RenderTile glyphTile(int x, int y, std::array<float, 4> color)
+{
+    return atlas::RenderTile {
+        .x = atlas::RenderTile::X { x },
+        .y = atlas::RenderTile::Y { y },
+        .bitmapSize = ImageSize { Width(2), Height(2) },
+        .targetSize = ImageSize { Width(2), Height(2) },
+        .color = color,
+        .tileLocation = atlas::TileLocation {},
+        .normalizedLocation = { .x = 0.0f, .y = 0.0f, .width = 2 / 16.f, .height = 2 / 16.f },
+        .fragmentShaderSelector = FRAGMENT_SELECTOR_GLYPH_ALPHA,
+    };
+}
+
+} // namespace
+
+TEST_CASE("SoftwareRenderTarget.renderRectangle", "[SoftwareRenderTarget]")
+{
+    auto target = createTarget(4, 4);
+    target.renderRectangle(0, 0, Width(4), Height(4), RGBAColor { 0x10, 0x20, 0x30, 0xFF });
+    target.renderRectangle(1, 1, Width(2), Height(2), RGBAColor { 0xFF, 0x00, 0x00, 0x80 });
+    target.renderRectangle(3, 3, Width(5), Height(5), RGBAColor { 0x00, 0xFF, 0x00, 0xFF }); // clipped
+    target.execute(Now);
+
+    CHECK(target.pixelAt(0, 0) == RGBAColor { 0x10, 0x20, 0x30, 0xFF });
+    CHECK(target.pixelAt(1, 1) == RGBAColor { 0x88, 0x10, 0x18, 0xFF });
+    CHECK(target.pixelAt(2, 2) == RGBAColor { 0x88, 0x10, 0x18, 0xFF });
+    CHECK(target.pixelAt(3, 3) == RGBAColor { 0x00, 0xFF, 0x00, 0xFF });
+}
+
+TEST_CASE("SoftwareRenderTarget.renderTile.glyph_alpha", "[SoftwareRenderTarget]")
+{
+    auto target = createTarget(4, 4);
+    uploadGlyph(target, { 0xFF, 0x00, 0x80, 0xFF });
+
+    target.renderRectangle(0, 0, Width(4), Height(4), RGBAColor { 0x00, 0x00, 0x00, 0xFF });
+    target.renderTile(glyphTile(1, 1, { 1.0f, 1.0f, 1.0f, 1.0f }));
+    target.execute(Now);
+
+    CHECK(target.pixelAt(0, 0) == RGBAColor { 0x00, 0x00, 0x00, 0xFF });
+    CHECK(target.pixelAt(1, 1) == RGBAColor { 0xFF, 0xFF, 0xFF, 0xFF });
+    CHECK(target.pixelAt(2, 1) == RGBAColor { 0x00, 0x00, 0x00, 0xFF });
+    CHECK(target.pixelAt(1, 2) == RGBAColor { 0x80, 0x80, 0x80, 0xFF });
+    CHECK(target.pixelAt(2, 2) == RGBAColor { 0xFF, 0xFF, 0xFF, 0xFF });
+    CHECK(target.pixelAt(3, 3) == RGBAColor { 0x00, 0x00, 0x00, 0xFF });
+}
+
+TEST_CASE("SoftwareRenderTarget.renderTile.scaled", "[SoftwareRenderTarget]")
+{
+    auto target = createTarget(4, 4);
+    uploadGlyph(target, { 0xFF, 0x00, 0x00, 0xFF });
+
+    auto tile = glyphTile(0, 0, { 1.0f, 0.0f, 0.0f, 1.0f });
+    tile.targetSize = ImageSize { Width(4), Height(4) };
+    target.renderTile(tile);
+    target.execute(Now);
+
+    // Each texel covers 2x2 pixels.
+    CHECK(target.pixelAt(1, 1) == RGBAColor { 0xFF, 0x00, 0x00, 0xFF });
+    CHECK(target.pixelAt(2, 1) == RGBAColor { 0x00, 0x00, 0x00, 0x00 });
+    CHECK(target.pixelAt(1, 2) == RGBAColor { 0x00, 0x00, 0x00, 0x00 });
+    CHECK(target.pixelAt(3, 3) == RGBAColor { 0xFF, 0x00, 0x00, 0xFF });
+}
+
+TEST_CASE("SoftwareRenderTarget.setDamagedBands", "[SoftwareRenderTarget]")
+{
+    auto target = createTarget(2, 4);
+
+    // Without a complete frame, there is nothing to keep.
+    CHECK(!target.setDamagedBands({ PixelRowBand { .top = 0, .height = 1 } }));
+
+    target.renderRectangle(0, 0, Width(2), Height(4), RGBAColor { 0x11, 0x11, 0x11, 0xFF });
+    target.execute(Now);
+
+    REQUIRE(target.setDamagedBands({ PixelRowBand { .top = 1, .height = 2 } }));
+    target.renderRectangle(0, 0, Width(2), Height(4), RGBAColor { 0x22, 0x22, 0x22, 0xFF });
+    target.execute(Now);
+
+    CHECK(target.pixelAt(0, 0) == RGBAColor { 0x11, 0x11, 0x11, 0xFF });
+    CHECK(target.pixelAt(0, 1) == RGBAColor { 0x22, 0x22, 0x22, 0xFF });
+    CHECK(target.pixelAt(1, 2) == RGBAColor { 0x22, 0x22, 0x22, 0xFF });
+    CHECK(target.pixelAt(0, 3) == RGBAColor { 0x11, 0x11, 0x11, 0xFF });
+
+    // Invalidating the frame makes the next one a full redraw again.
+    target.clearCache();
+    CHECK(!target.setDamagedBands({ PixelRowBand { .top = 1, .height = 2 } }));
+}
+
+TEST_CASE("SoftwareRenderTarget.scheduleScreenshot", "[SoftwareRenderTarget]")
+{
+    auto target = createTarget(3, 2);
+    target.renderRectangle(0, 0, Width(3), Height(2), RGBAColor { 0x01, 0x02, 0x03, 0xFF });
+
+    auto screenshot = std::vector<uint8_t> {};
+    auto screenshotSize = ImageSize {};
+    target.scheduleScreenshot([&](std::vector<uint8_t> const& rgbaBuffer, ImageSize pixelSize) {
+        screenshot = rgbaBuffer;
+        screenshotSize = pixelSize;
+    });
+    target.execute(Now);
+
+    CHECK(screenshotSize == ImageSize { Width(3), Height(2) });
+    REQUIRE(screenshot.size() == 3 * 2 * 4);
+    CHECK(screenshot == target.frame());
+    CHECK(screenshot[0] == 0x01);
+    CHECK(screenshot[1] == 0x02);
+    CHECK(screenshot[2] == 0x03);
+    CHECK(screenshot[3] == 0xFF);
+}
@@ -136,7 +136,9 @@ Making use of reserved glyph slots
 
 #include <crispy/algorithm.h>
 #include <crispy/assert.h>
+#include <crispy/instrumentation.h>
 #include <crispy/range.h>
+#include <crispy/thread_pool.h>
 
 #include <libunicode/convert.h>
 #include <libunicode/utf8_grapheme_segmenter.h>
@@ -145,6 +147,11 @@ Making use of reserved glyph slots
 #include <range/v3/view/enumerate.hpp>
 
 #include <algorithm>
+#include <exception>
+#include <format>
+#include <memory>
+#include <span>
+#include <utility>
 
 using crispy::point;
 using crispy::strong_hash;
@@ -180,6 +187,10 @@ namespace
     constexpr auto LastReservedChar = char32_t { 0x7E };
     constexpr auto DirectMappedCharsCount = LastReservedChar - FirstReservedChar + 1;
 
+    // Number of glyphs rasterized right away per frame, before further ones are
+    // rasterized in the background and rendered with a later frame.
+    constexpr auto SynchronousRasterizationsPerFrame = 32;
+
     strong_hash hashGlyphKeyAndPresentation(text::glyph_key const& glyphKey,
                                             unicode::PresentationStyle presentation) noexcept
     {
@@ -283,9 +294,18 @@ TextRenderer::TextRenderer(GridMetrics const& gridMetrics,
 {
 }
 
+TextRenderer::~TextRenderer()
+{
+    stopBackgroundRasterization();
+}
+
 void TextRenderer::inspect(ostream& textOutput) const
 {
     textOutput << "TextRenderer:\n";
+    textOutput << std::format("direct mapping : {} hits, {} rasterized on demand, {} misses\n",
+                              _directMappingStats.hits,
+                              _directMappingStats.lazyRasterized,
+                              _directMappingStats.misses);
     _textShapingCache->inspect(textOutput);
     _boxDrawingRenderer.inspect(textOutput);
 }
@@ -293,7 +313,9 @@ void TextRenderer::inspect(ostream& textOutput) const
 void TextRenderer::setRenderTarget(
     RenderTarget& renderTarget, atlas::DirectMappingAllocator<RenderTileAttributes>& directMappingAllocator)
 {
-    _directMapping = directMappingAllocator.allocate(DirectMappedCharsCount);
+    stopPrewarming();
+    auto const directMappedTileCount = static_cast<uint32_t>(DirectMappedCharsCount * DirectMappedStyleCount);
+    _directMapping = directMappingAllocator.allocate(directMappedTileCount);
     Renderable::setRenderTarget(renderTarget, directMappingAllocator);
     _boxDrawingRenderer.setRenderTarget(renderTarget, directMappingAllocator);
     clearCache();
@@ -301,19 +323,24 @@ void TextRenderer::setRenderTarget(
 
 void TextRenderer::setTextureAtlas(TextureAtlas& atlas)
 {
+    // Tiles being pre-warmed were located in the previous atlas.
+    stopPrewarming();
+
     Renderable::setTextureAtlas(atlas);
     _boxDrawingRenderer.setTextureAtlas(atlas);
 
     if (_directMapping)
-        initializeDirectMapping();
+        _directMappingOutdated = true;
 }
 
 void TextRenderer::clearCache()
 {
+    // Deferred to the next frame, as a font change clears the cache multiple times in a row.
     if (_textureAtlas && _directMapping)
-        initializeDirectMapping();
+        _directMappingOutdated = true;
 
     _textShapingCache->clear();
+    _failedGlyphs.clear();
 
     _boxDrawingRenderer.clearCache();
 }
@@ -365,43 +392,144 @@ void TextRenderer::restrictToTileSize(TextureAtlas::TileCreateData& tileCreateDa
 void TextRenderer::initializeDirectMapping()
 {
     Require(_textureAtlas);
-    Require(_directMapping.count == DirectMappedCharsCount);
+    Require(_directMapping.count == DirectMappedCharsCount * DirectMappedStyleCount);
+
+    // Keep whatever has been pre-warmed already, as the atlas is still the same.
+    uploadPrewarmedTiles();
+    stopPrewarming();
 
-    _directMappedGlyphKeyToTileIndex.clear();
-    _directMappedGlyphKeyToTileIndex.resize(LastReservedChar + 1);
+    struct PrewarmGlyph
+    {
+        uint32_t tileIndex;
+        atlas::TileLocation tileLocation;
+        text::glyph_key glyph;
+    };
+    auto glyphs = vector<PrewarmGlyph> {};
 
-    for (char32_t codepoint = FirstReservedChar; codepoint <= LastReservedChar; ++codepoint)
+    constexpr auto Styles =
+        array { TextStyle::Regular, TextStyle::Bold, TextStyle::Italic, TextStyle::BoldItalic };
+    static_assert(Styles.size() == DirectMappedStyleCount);
+
+    for (size_t style = 0; style < DirectMappedStyleCount; ++style)
     {
-        if (optional<text::glyph_position> gposOpt = _textShaper.shape(_fonts.regular, codepoint))
+        auto& glyphKeyToTileIndex = _directMappedGlyphKeyToTileIndex[style];
+        glyphKeyToTileIndex.clear();
+
+        // Styles falling back to the font of a preceding style are served by the tiles of that one.
+        auto const font = getFontForStyle(_fonts, Styles[style]);
+        auto const precedingStyles = std::span(Styles.data(), style);
+        if (std::ranges::any_of(precedingStyles,
+                                [&](TextStyle other) { return getFontForStyle(_fonts, other) == font; }))
+            continue;
+
+        glyphKeyToTileIndex.resize(LastReservedChar + 1);
+        auto const baseIndex = static_cast<uint32_t>(style * DirectMappedCharsCount);
+
+        auto const textShaperLock = std::lock_guard { _textShaperLock };
+        for (char32_t codepoint = FirstReservedChar; codepoint <= LastReservedChar; ++codepoint)
         {
-            text::glyph_key const& glyph = gposOpt.value().glyph;
-            if (glyph.index.value >= _directMappedGlyphKeyToTileIndex.size())
-                _directMappedGlyphKeyToTileIndex.resize(glyph.index.value
-                                                        + (LastReservedChar - codepoint + 1));
-            _directMappedGlyphKeyToTileIndex[glyph.index.value] =
-                _directMapping.toTileIndex(codepoint - FirstReservedChar);
+            if (optional<text::glyph_position> gposOpt = _textShaper.shape(font, codepoint))
+            {
+                text::glyph_key const& glyph = gposOpt.value().glyph;
+                if (glyph.index.value >= glyphKeyToTileIndex.size())
+                    glyphKeyToTileIndex.resize(glyph.index.value + (LastReservedChar - codepoint + 1));
+                auto const tileIndex = _directMapping.toTileIndex(baseIndex + codepoint - FirstReservedChar);
+                glyphKeyToTileIndex[glyph.index.value] = tileIndex;
+
+                if (!_textureAtlas->directMapped(tileIndex).bitmapSize.width.value)
+                    glyphs.emplace_back(
+                        PrewarmGlyph { tileIndex, _textureAtlas->tileLocation(tileIndex), glyph });
+            }
         }
     }
+
+    if (glyphs.empty())
+        return;
+
+    // The glyphs are rasterized in the background and uploaded with whichever frame comes next.
+    // Glyphs being rendered before their tile got uploaded are rasterized on demand instead.
+    _prewarmingCancelled = false;
+    _prewarming.running = true;
+    crispy::thread_pool::shared().post([this, glyphs = std::move(glyphs)]() {
+        auto _ = crispy::finally { [this]() {
+            auto const lock = std::lock_guard { _prewarming.lock };
+            _prewarming.running = false;
+            _prewarming.idle.notify_all();
+        } };
+
+        for (auto const& [tileIndex, tileLocation, glyph]: glyphs)
+        {
+            if (_prewarmingCancelled)
+                break;
+            try
+            {
+                auto tileCreateData =
+                    createRasterizedGlyph(tileLocation, glyph, unicode::PresentationStyle::Text);
+                if (!tileCreateData)
+                    continue;
+                auto const lock = std::lock_guard { _prewarming.lock };
+                _prewarming.completed.emplace_back(PrewarmedTile { tileIndex, std::move(*tileCreateData) });
+            }
+            catch (std::exception const& e)
+            {
+                rasterizerLog()("Failed to pre-warm direct mapped glyph {}. {}", glyph, e.what());
+            }
+        }
+    });
+}
+
+void TextRenderer::uploadPrewarmedTiles()
+{
+    auto tiles = vector<PrewarmedTile> {};
+    {
+        auto const _ = std::lock_guard { _prewarming.lock };
+        tiles.swap(_prewarming.completed);
+    }
+
+    for (auto& [tileIndex, tileCreateData]: tiles)
+    {
+        // Already rasterized on demand.
+        if (_textureAtlas->directMapped(tileIndex).bitmapSize.width.value)
+            continue;
+
+        restrictToTileSize(tileCreateData);
+        Require(tileCreateData.bitmapSize.width <= textureAtlas().tileSize().width);
+        _textureAtlas->setDirectMapping(tileIndex, std::move(tileCreateData));
+    }
+}
+
+void TextRenderer::stopPrewarming()
+{
+    auto lock = std::unique_lock { _prewarming.lock };
+    _prewarmingCancelled = true;
+    _prewarming.idle.wait(lock, [this]() { return !_prewarming.running; });
+    _prewarming.completed.clear();
 }
 
 Renderable::AtlasTileAttributes const* TextRenderer::ensureRasterizedIfDirectMapped(
     text::glyph_key const& glyph)
 {
-    if (!isGlyphDirectMapped(glyph))
+    auto const tileIndex = directMappedTileIndex(glyph);
+    if (!tileIndex)
+    {
+        ++_directMappingStats.misses;
         return nullptr;
-
-    auto const tileIndex = _directMappedGlyphKeyToTileIndex[glyph.index.value];
+    }
 
     if (_textureAtlas->directMapped(tileIndex).bitmapSize.width.value)
+    {
         // TODO: Find a better way to test if the glyph was rasterized&uploaded already.
         // like: if (_textureAtlas->isDirectMappingSet(tileIndex)) ...
+        ++_directMappingStats.hits;
         return &_textureAtlas->directMapped(tileIndex);
+    }
 
     auto const tileLocation = _textureAtlas->tileLocation(tileIndex);
     auto tileCreateData = createRasterizedGlyph(tileLocation, glyph, unicode::PresentationStyle::Text);
     if (!tileCreateData)
         return nullptr;
 
+    ++_directMappingStats.lazyRasterized;
     restrictToTileSize(*tileCreateData);
     Require(tileCreateData->bitmapSize.width <= textureAtlas().tileSize().width);
 
@@ -426,22 +554,30 @@ void TextRenderer::updateFontMetrics()
 
 void TextRenderer::beginFrame()
 {
+    if (std::exchange(_directMappingOutdated, false) && _textureAtlas)
+        initializeDirectMapping();
+    uploadPrewarmedTiles();
+    insertRasterizedGlyphs();
+    _synchronousRasterizationBudget = SynchronousRasterizationsPerFrame;
+    _placeholderLines.clear();
     _textClusterGrouper.beginFrame();
 }
 
 void TextRenderer::renderLine(vtbackend::RenderLine const& renderLine)
 {
+    CRISPY_INSTRUMENT_STAGE(text_renderer, 0);
     _textClusterGrouper.renderLine(renderLine.text,
                                    renderLine.lineOffset,
                                    renderLine.textAttributes.foregroundColor,
                                    makeTextStyle(renderLine.textAttributes.flags));
 }
 
-void TextRenderer::renderCell(vtbackend::RenderCell const& cell)
+void TextRenderer::renderCell(vtbackend::RenderCell const& cell, std::u32string_view codepoints)
 {
+    CRISPY_INSTRUMENT_STAGE(text_renderer, 0);
     // std::cout << std::format("renderCell: {} {} {} {} {}\n",
     //            cell.position,
-    //            unicode::convert_to<char>(u32string_view(cell.codepoints)),
+    //            unicode::convert_to<char>(codepoints),
     //            _forceUpdateInitialPenPosition ? "forcedRestart" : "-",
     //            cell.groupStart ? "groupStart" : "-",
     //            cell.groupEnd ? "groupEnd" : "-");
@@ -450,7 +586,7 @@ void TextRenderer::renderCell(vtbackend::RenderCell const& cell)
         _textClusterGrouper.forceGroupStart();
 
     _textClusterGrouper.renderCell(cell.position,
-                                   cell.codepoints,
+                                   codepoints,
                                    makeTextStyle(cell.attributes.flags),
                                    cell.attributes.foregroundColor);
 
@@ -468,6 +604,7 @@ void TextRenderer::renderCell(vtbackend::CellLocation position,
 
 void TextRenderer::endFrame()
 {
+    CRISPY_INSTRUMENT_STAGE(text_renderer, 0);
     _textClusterGrouper.endFrame();
 }
 
@@ -582,8 +719,11 @@ void TextRenderer::renderTextGroup(std::u32string_view codepoints,
             auto const pen1 = applyGlyphPositionToPen(pen, *attributes, glyphPosition);
             renderRasterizedGlyph(pen1, color, *attributes);
 
+            // Packed glyphs are held as a whole, whereas wide glyphs on the tile grid are sliced.
+            auto const isPacked = attributes->bitmapSize.width > textureAtlas().tileSize().width;
             auto xOffset = unbox(textureAtlas().tileSize().width);
-            while (AtlasTileAttributes const* subAttribs = textureAtlas().try_get(hash * xOffset))
+            while (AtlasTileAttributes const* subAttribs =
+                       isPacked ? nullptr : textureAtlas().try_get(hash * xOffset))
             {
                 renderTile(atlas::RenderTile::X { pen1.x + int(xOffset) },
                            atlas::RenderTile::Y { pen1.y },
@@ -592,6 +732,9 @@ void TextRenderer::renderTextGroup(std::u32string_view codepoints,
                 xOffset += unbox(textureAtlas().tileSize().width);
             }
         }
+        else if (_pendingGlyphs.contains(hash)
+                 && (_placeholderLines.empty() || _placeholderLines.back() != initialPenPosition.line))
+            _placeholderLines.push_back(initialPenPosition.line);
 
         if (glyphPosition.advance.x)
         {
@@ -610,33 +753,177 @@ void TextRenderer::renderTextGroup(std::u32string_view codepoints,
 Renderable::AtlasTileAttributes const* TextRenderer::getOrCreateRasterizedMetadata(
     strong_hash const& hash, text::glyph_key const& glyphKey, unicode::PresentationStyle presentationStyle)
 {
-    // clang-format off
+    if (auto const* attributes = textureAtlas().try_get_packed(hash))
+        return attributes;
+
+    if (auto const* attributes = textureAtlas().try_get(hash))
+        return attributes;
+
+    if (_pendingGlyphs.contains(hash) || _failedGlyphs.contains(hash))
+        return nullptr;
+
+    // Glyphs exceeding this frame's budget are rendered with a later frame.
+    if (_synchronousRasterizationBudget <= 0)
+    {
+        requestRasterization(
+            GlyphRequest { .hash = hash, .glyph = glyphKey, .presentation = presentationStyle });
+        return nullptr;
+    }
+
+    --_synchronousRasterizationBudget;
+
+    auto glyph = rasterizeGlyph(glyphKey);
+    if (!glyph)
+    {
+        _failedGlyphs.insert(hash);
+        return nullptr;
+    }
+
+    return createGlyphTile(hash, glyphKey, presentationStyle, std::move(*glyph));
+}
+
+Renderable::AtlasTileAttributes const* TextRenderer::createGlyphTile(strong_hash const& hash,
+                                                                     text::glyph_key const& glyphKey,
+                                                                     unicode::PresentationStyle presentation,
+                                                                     text::rasterized_glyph glyph)
+{
+    // The final location is only known once the tile has been placed.
+    auto createData = createGlyphTileData(atlas::TileLocation {}, glyphKey, presentation, std::move(glyph));
+    if (!createData)
+        return nullptr;
+
+    if (createData->bitmapSize.width > textureAtlas().tileSize().width)
+    {
+        auto const* attributes = textureAtlas().emplace_packed(
+            hash, *createData, [this](atlas::TileLocation tileLocation, TextureAtlas::TileCreateData& data) {
+                relocateTileData(data, tileLocation);
+            });
+        if (attributes)
+            return attributes;
+    }
+
     return textureAtlas().get_or_try_emplace(
-        hash,
-        [&](atlas::TileLocation tileLocation)
-        -> optional<TextureAtlas::TileCreateData>
+        hash, [&](atlas::TileLocation tileLocation) -> optional<TextureAtlas::TileCreateData> {
+            return createSlicedRasterizedGlyph(tileLocation, hash, std::move(*createData));
+        });
+}
+
+// {{{ background rasterization
+void TextRenderer::requestRasterization(GlyphRequest request)
+{
+    _pendingGlyphs.insert(request.hash);
+
+    {
+        auto const _ = std::lock_guard { _backgroundRasterization.lock };
+        _backgroundRasterization.requests.emplace_back(std::move(request));
+        if (std::exchange(_backgroundRasterization.running, true))
+            return;
+    }
+
+    crispy::thread_pool::shared().post([this]() { rasterizeRequestedGlyphs(); });
+}
+
+void TextRenderer::rasterizeRequestedGlyphs()
+{
+    auto lock = std::unique_lock { _backgroundRasterization.lock };
+
+    // Whatever happens, waiters in cancelRasterizationRequests() must be woken up.
+    auto _ = crispy::finally { [&]() {
+        if (!lock.owns_lock())
+            lock.lock();
+        _backgroundRasterization.running = false;
+        _backgroundRasterization.idle.notify_all();
+    } };
+
+    while (!_backgroundRasterization.requests.empty())
+    {
+        auto const request = _backgroundRasterization.requests.front();
+        _backgroundRasterization.requests.pop_front();
+        lock.unlock();
+
+        auto glyph = optional<text::rasterized_glyph> {};
+        try
         {
-            return createSlicedRasterizedGlyph(tileLocation, glyphKey, presentationStyle, hash);
+            glyph = rasterizeGlyph(request.glyph);
         }
-    );
-    // clang-format on
+        catch (std::exception const& e)
+        {
+            rasterizerLog()("Failed to rasterize glyph {}. {}", request.glyph, e.what());
+        }
+        catch (...)
+        {
+            rasterizerLog()("Failed to rasterize glyph {}.", request.glyph);
+        }
+
+        lock.lock();
+        _backgroundRasterization.completed.emplace_back(RasterizedGlyph { request, std::move(glyph) });
+
+        // Only the first glyph to be inserted with the next frame has to trigger that frame.
+        if (_backgroundRasterization.completed.size() == 1 && _glyphsRasterizedCallback)
+        {
+            lock.unlock();
+            _glyphsRasterizedCallback();
+            lock.lock();
+        }
+    }
 }
 
-auto TextRenderer::createSlicedRasterizedGlyph(atlas::TileLocation tileLocation,
-                                               text::glyph_key const& glyphKey,
-                                               unicode::PresentationStyle presentation,
-                                               strong_hash const& hash)
-    -> optional<TextureAtlas::TileCreateData>
+void TextRenderer::insertRasterizedGlyphs()
+{
+    auto completed = vector<RasterizedGlyph> {};
+    {
+        auto const _ = std::lock_guard { _backgroundRasterization.lock };
+        completed.swap(_backgroundRasterization.completed);
+    }
+
+    for (auto& rasterized: completed)
+    {
+        auto const& request = rasterized.request;
+        _pendingGlyphs.erase(request.hash);
+        if (!rasterized.glyph)
+        {
+            _failedGlyphs.insert(request.hash);
+            continue;
+        }
+
+        (void) createGlyphTile(
+            request.hash, request.glyph, request.presentation, std::move(*rasterized.glyph));
+    }
+}
+
+void TextRenderer::cancelRasterizationRequests()
+{
+    auto lock = std::unique_lock { _backgroundRasterization.lock };
+    _backgroundRasterization.requests.clear();
+    _backgroundRasterization.idle.wait(lock, [this]() { return !_backgroundRasterization.running; });
+    _backgroundRasterization.completed.clear();
+    _pendingGlyphs.clear();
+}
+
+void TextRenderer::stopBackgroundRasterization()
 {
-    auto result = createRasterizedGlyph(tileLocation, glyphKey, presentation);
-    if (!result)
-        return result;
+    stopPrewarming();
+    cancelRasterizationRequests();
+}
 
-    auto& createData = *result;
+optional<text::rasterized_glyph> TextRenderer::rasterizeGlyph(text::glyph_key const& glyphKey)
+{
+    auto const _ = std::lock_guard { _textShaperLock };
+    return _textShaper.rasterize(glyphKey, _fontDescriptions.renderMode);
+}
+// }}}
 
+auto TextRenderer::createSlicedRasterizedGlyph(atlas::TileLocation tileLocation,
+                                               strong_hash const& hash,
+                                               TextureAtlas::TileCreateData createData)
+    -> optional<TextureAtlas::TileCreateData>
+{
     if (unbox<int>(createData.bitmapSize.width) <= unbox<int>(textureAtlas().tileSize().width))
+    {
         // standard (narrow) rasterization
-        return result;
+        relocateTileData(createData, tileLocation);
+        return createData;
+    }
 
     // Now, slice wide glyph into smaller fitting tiles,
     // upload all but the head-tile explicitly and then return the head-tile
@@ -704,11 +991,18 @@ auto TextRenderer::createRasterizedGlyph(atlas::TileLocation tileLocation,
                                          unicode::PresentationStyle presentation)
     -> optional<TextureAtlas::TileCreateData>
 {
-    auto theGlyphOpt = _textShaper.rasterize(glyphKey, _fontDescriptions.renderMode);
+    auto theGlyphOpt = rasterizeGlyph(glyphKey);
     if (!theGlyphOpt.has_value())
         return nullopt;
 
-    text::rasterized_glyph& glyph = theGlyphOpt.value();
+    return createGlyphTileData(tileLocation, glyphKey, presentation, std::move(theGlyphOpt.value()));
+}
+
+auto TextRenderer::createGlyphTileData(atlas::TileLocation tileLocation,
+                                       text::glyph_key const& glyphKey,
+                                       unicode::PresentationStyle presentation,
+                                       text::rasterized_glyph glyph) -> optional<TextureAtlas::TileCreateData>
+{
     Require(glyph.bitmap.size()
             == text::pixel_size(glyph.format) * unbox<size_t>(glyph.bitmapSize.width)
                    * unbox<size_t>(glyph.bitmapSize.height));
@@ -863,6 +1157,7 @@ text::shape_result TextRenderer::shapeTextRun(unicode::run_segmenter::range cons
 
     text::shape_result glyphPosition;
     glyphPosition.reserve(clusters.size());
+    auto const textShaperLock = std::lock_guard { _textShaperLock };
     _textShaper.shape(font,
                       codepoints,
                       clusters,
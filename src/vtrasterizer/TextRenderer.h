@@ -26,6 +26,14 @@
 #include <gsl/span>
 #include <gsl/span_ext>
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <unordered_set>
 #include <vector>
 
 namespace vtrasterizer
@@ -50,6 +58,14 @@ struct TextRendererEvents
     virtual void onAfterRenderingText() = 0;
 };
 
+/// Counters on how glyphs are served by the direct mapped tier of the texture atlas.
+struct DirectMappingStats
+{
+    uint64_t hits = 0;           // Glyphs rendered from an already rasterized direct mapped tile.
+    uint64_t lazyRasterized = 0; // Direct mapped glyphs that were not pre-warmed and rasterized on demand.
+    uint64_t misses = 0;         // Glyphs not direct mapped, i.e. looked up in the LRU cached tiles.
+};
+
 /// Text Rendering Pipeline
 class TextRenderer: public Renderable, public TextClusterGrouper::Events
 {
@@ -59,6 +75,7 @@ class TextRenderer: public Renderable, public TextClusterGrouper::Events
                  FontDescriptions& fontDescriptions,
                  FontKeys const& fontKeys,
                  TextRendererEvents& eventHandler);
+    ~TextRenderer() override;
 
     void setRenderTarget(RenderTarget& renderTarget, DirectMappingAllocator& directMappingAllocator) override;
     void setTextureAtlas(TextureAtlas& atlas) override;
@@ -69,14 +86,41 @@ class TextRenderer: public Renderable, public TextClusterGrouper::Events
 
     void updateFontMetrics();
 
+    /// Stops rasterizing glyphs in the background, waiting for it to return, and discards pending glyphs.
+    ///
+    /// Must be called before the text shaper, the font keys or the grid metrics are modified.
+    void stopBackgroundRasterization();
+
+    /// Indicates whether glyphs are still being rasterized in the background,
+    /// having been rendered as blank placeholders until they are inserted into the atlas with a later frame.
+    [[nodiscard]] bool hasPendingGlyphs() const noexcept { return !_pendingGlyphs.empty(); }
+
+    /// Screen lines that have been rendered with placeholders for pending glyphs in the current frame.
+    [[nodiscard]] std::vector<vtbackend::LineOffset> const& placeholderLines() const noexcept
+    {
+        return _placeholderLines;
+    }
+
+    /// Sets the callback to be invoked from the background worker as soon as rasterized glyphs are
+    /// ready to be inserted into the atlas with the next frame.
+    void setGlyphsRasterizedCallback(std::function<void()> callback)
+    {
+        _glyphsRasterizedCallback = std::move(callback);
+    }
+
+    [[nodiscard]] DirectMappingStats const& directMappingStats() const noexcept
+    {
+        return _directMappingStats;
+    }
+
     void setPressure(bool pressure) noexcept { _pressure = pressure; }
 
     /// Must be invoked before a new terminal frame is rendered.
     void beginFrame();
 
     /// Renders a given terminal's grid cell that has been
-    /// transformed into a RenderCell.
-    void renderCell(vtbackend::RenderCell const& cell);
+    /// transformed into a RenderCell, along with the cell's codepoints.
+    void renderCell(vtbackend::RenderCell const& cell, std::u32string_view codepoints);
 
     void renderCell(vtbackend::CellLocation position,
                     std::u32string_view graphemeCluster,
@@ -90,6 +134,8 @@ class TextRenderer: public Renderable, public TextClusterGrouper::Events
 
   private:
     void initializeDirectMapping();
+    void uploadPrewarmedTiles();
+    void stopPrewarming();
 
     void renderTextGroup(std::u32string_view codepoints,
                          gsl::span<unsigned> clusters,
@@ -118,21 +164,49 @@ class TextRenderer: public Renderable, public TextClusterGrouper::Events
                                                              text::glyph_key const& glyphKey,
                                                              unicode::PresentationStyle presentationStyle);
 
+    /// Rasterizes the given glyph, being safe to be called from any thread.
+    std::optional<text::rasterized_glyph> rasterizeGlyph(text::glyph_key const& glyphKey);
+
+    /// Inserts the given rasterized glyph into the texture atlas.
+    ///
+    /// Glyphs wider than a tile are packed as a whole if the atlas supports it,
+    /// and sliced into tiles otherwise.
+    AtlasTileAttributes const* createGlyphTile(crispy::strong_hash const& hash,
+                                               text::glyph_key const& glyphKey,
+                                               unicode::PresentationStyle presentation,
+                                               text::rasterized_glyph glyph);
+
     /**
-     * Creates (and rasterizes) a single glyph and returns its
+     * Creates the tile of a single rasterized glyph and returns its
      * render tile attributes required for the render step.
      */
     std::optional<TextureAtlas::TileCreateData> createSlicedRasterizedGlyph(
         atlas::TileLocation tileLocation,
-        text::glyph_key const& glyphKey,
-        unicode::PresentationStyle presentation,
-        crispy::strong_hash const& hash);
+        crispy::strong_hash const& hash,
+        TextureAtlas::TileCreateData createData);
 
     std::optional<TextureAtlas::TileCreateData> createRasterizedGlyph(
         atlas::TileLocation tileLocation,
         text::glyph_key const& glyphKey,
         unicode::PresentationStyle presentation);
 
+    std::optional<TextureAtlas::TileCreateData> createGlyphTileData(atlas::TileLocation tileLocation,
+                                                                    text::glyph_key const& glyphKey,
+                                                                    unicode::PresentationStyle presentation,
+                                                                    text::rasterized_glyph glyph);
+
+    struct GlyphRequest
+    {
+        crispy::strong_hash hash;
+        text::glyph_key glyph;
+        unicode::PresentationStyle presentation;
+    };
+
+    void requestRasterization(GlyphRequest request);
+    void rasterizeRequestedGlyphs();
+    void insertRasterizedGlyphs();
+    void cancelRasterizationRequests();
+
     void restrictToTileSize(TextureAtlas::TileCreateData& tileCreateData);
 
     crispy::point applyGlyphPositionToPen(crispy::point pen,
@@ -161,17 +235,82 @@ class TextRenderer: public Renderable, public TextClusterGrouper::Events
     // TODO: make unique_ptr, get owned, export cref for other users in Renderer impl.
     text::shaper& _textShaper;
 
+    // The text shaper is not thread safe, so any use of it is serialized by this lock.
+    std::mutex _textShaperLock;
+
+    struct RasterizedGlyph
+    {
+        GlyphRequest request;
+        std::optional<text::rasterized_glyph> glyph;
+    };
+
+    // Glyphs being rasterized in the background, shared with the worker.
+    struct
+    {
+        std::mutex lock;
+        std::condition_variable idle;
+        std::deque<GlyphRequest> requests;      // Glyphs yet to be rasterized, in request order.
+        std::vector<RasterizedGlyph> completed; // Glyphs to be inserted into the atlas with the next frame.
+        bool running = false;                   // Indicates whether a worker is processing the requests.
+    } _backgroundRasterization;
+
+    struct GlyphHashHasher
+    {
+        size_t operator()(crispy::strong_hash const& hash) const noexcept { return hash.d(); }
+    };
+    using GlyphHashSet = std::unordered_set<crispy::strong_hash, GlyphHashHasher>;
+
+    GlyphHashSet _pendingGlyphs;                          // Requested glyphs not yet inserted into the atlas.
+    GlyphHashSet _failedGlyphs;                           // Glyphs that could not be rasterized.
+    int _synchronousRasterizationBudget = 0;              // Glyphs to be rasterized right away in this frame.
+    std::vector<vtbackend::LineOffset> _placeholderLines; // Lines rendered with pending glyphs in this frame.
+    std::function<void()> _glyphsRasterizedCallback;
+
+    // The direct mapped tiles are never evicted, and are rasterized for
+    // the regular, bold, italic, and bold italic font (in that order).
+    static constexpr size_t DirectMappedStyleCount = 4;
+
     DirectMapping _directMapping {};
 
-    // Maps from glyph index to tile index.
-    std::vector<uint32_t> _directMappedGlyphKeyToTileIndex {};
+    // Maps from glyph index to tile index, for each of the direct mapped font styles.
+    std::array<std::vector<uint32_t>, DirectMappedStyleCount> _directMappedGlyphKeyToTileIndex {};
+
+    struct PrewarmedTile
+    {
+        uint32_t tileIndex;
+        TextureAtlas::TileCreateData tileCreateData;
+    };
+
+    // Direct mapped tiles being rasterized in the background, shared with the worker.
+    struct
+    {
+        std::mutex lock;
+        std::condition_variable idle;
+        std::vector<PrewarmedTile> completed; // Tiles to be uploaded with the next frame.
+        bool running = false;                 // Indicates whether a worker is pre-warming tiles.
+    } _prewarming;
+    std::atomic<bool> _prewarmingCancelled = false;
+
+    // Indicates whether the direct mapped glyphs are to be looked up again with the next frame.
+    bool _directMappingOutdated = false;
+
+    DirectMappingStats _directMappingStats {};
 
-    [[nodiscard]] bool isGlyphDirectMapped(text::glyph_key const& glyph) const noexcept
+    /// Returns the tile index of the given glyph in the direct mapped tier, or 0 if not direct mapped.
+    [[nodiscard]] uint32_t directMappedTileIndex(text::glyph_key const& glyph) const noexcept
     {
-        return _directMapping                  // Is direct mapping enabled?
-               && glyph.font == _fonts.regular // Only regular font is direct-mapped for now.
-               && glyph.index.value < _directMappedGlyphKeyToTileIndex.size()
-               && _directMappedGlyphKeyToTileIndex[glyph.index.value] != 0;
+        if (!_directMapping)
+            return 0;
+
+        auto const fonts = std::array { _fonts.regular, _fonts.bold, _fonts.italic, _fonts.boldItalic };
+        for (size_t style = 0; style < fonts.size(); ++style)
+        {
+            if (glyph.font != fonts[style])
+                continue;
+            auto const& tileIndices = _directMappedGlyphKeyToTileIndex[style];
+            return glyph.index.value < tileIndices.size() ? tileIndices[glyph.index.value] : 0;
+        }
+        return 0;
     }
 
     AtlasTileAttributes const* ensureRasterizedIfDirectMapped(text::glyph_key const& glyphKey);
@@ -4,12 +4,16 @@
 #include <vtbackend/Color.h>
 #include <vtbackend/primitives.h>
 
+#include <vtrasterizer/ShelfPacker.h>
+
 #include <crispy/StrongHash.h>
 #include <crispy/StrongLRUHashtable.h>
 #include <crispy/assert.h>
 
 #include <cstdint>
 #include <format>
+#include <optional>
+#include <unordered_map>
 #include <variant> // monostate
 #include <vector>
 
@@ -115,6 +119,12 @@ struct AtlasProperties
     // This can be for example [A-Za-z0-9], characters that are most often
     // used and least likely part of a ligature.
     uint32_t directMappingCount {};
+
+    // Minimum height in pixels of the area below the tile grid,
+    // in which tiles of variable size (such as wide glyphs) are packed into shelves.
+    //
+    // Zero disables tile packing.
+    uint32_t packedAreaHeight {};
 };
 
 // -----------------------------------------------------------------------
@@ -296,6 +306,25 @@ class TextureAtlas
 
     [[nodiscard]] bool isDirectMappingEnabled() const noexcept { return !_directMapping.empty(); }
 
+    // Tests whether tiles of variable size can be packed into this atlas.
+    [[nodiscard]] bool isPackingEnabled() const noexcept { return _packer.has_value(); }
+
+    // Returns the packed tile by the given key, if found, and marks it as recently used.
+    [[nodiscard]] TileAttributes<Metadata> const* try_get_packed(crispy::strong_hash const& key);
+
+    /// Packs a tile of variable size into the atlas, evicting the least recently used
+    /// shelf of packed tiles if needed.
+    ///
+    /// The relocate callback is invoked with the tile's location and data before uploading,
+    /// so that location dependent metadata can be updated.
+    ///
+    /// @returns the newly created tile or nullptr if the tile could not be packed,
+    ///          in which case tileCreateData is left untouched.
+    template <typename RelocateFn>
+    TileAttributes<Metadata> const* emplace_packed(crispy::strong_hash const& key,
+                                                   TileCreateData& tileCreateData,
+                                                   RelocateFn relocate);
+
     [[nodiscard]] TileLocation tileLocation(uint32_t tileIndex) const { return _tileLocations[tileIndex]; }
 
     // Retrieves the number of total tiles that can be stored.
@@ -334,6 +363,25 @@ class TextureAtlas
     std::string _name;
 
     std::vector<TileAttributes<Metadata>> _directMapping;
+
+    struct PackedTile
+    {
+        TileAttributes<Metadata> attributes;
+        uint32_t shelf;
+    };
+
+    struct PackedTileKeyHash
+    {
+        size_t operator()(crispy::strong_hash const& key) const noexcept { return key.d(); }
+    };
+
+    // Packs tiles of variable size into the area below the tile grid, if enabled.
+    std::optional<ShelfPacker> _packer;
+    uint32_t _packedAreaTop = 0;
+    std::unordered_map<crispy::strong_hash, PackedTile, PackedTileKeyHash> _packedTiles;
+
+    // Keys of the packed tiles, per shelf, to be dropped when the shelf gets evicted.
+    std::vector<std::vector<crispy::strong_hash>> _packedShelfKeys;
 };
 
 template <typename Metadata = std::monostate>
@@ -458,7 +506,7 @@ inline vtbackend::ImageSize computeAtlasSize(AtlasProperties const& atlasPropert
     auto const width = vtbackend::Width::cast_from(crispy::nextPowerOfTwo(static_cast<uint32_t>(
         squareEdgeCount * unbox(atlasProperties.tileSize.width))));
     auto const height = vtbackend::Height::cast_from(crispy::nextPowerOfTwo(static_cast<uint32_t>(
-        squareEdgeCount * unbox(atlasProperties.tileSize.height))));
+        squareEdgeCount * unbox(atlasProperties.tileSize.height) + atlasProperties.packedAreaHeight)));
     // clang-format on
 
     // std::cout << std::format("computeAtlasSize: tiles {}+{}={} -> texture size {}x{} (tile size {})\n",
@@ -485,7 +533,8 @@ TextureAtlas<Metadata>::TextureAtlas(AtlasBackend& backend, AtlasProperties atla
     }() },
     _tilesInY { [&]() {
         Require(unbox(_atlasProperties.tileSize.height) != 0);
-        auto const tilesInY = unbox(_atlasSize.height) / unbox(_atlasProperties.tileSize.height);
+        auto const tilesInY = (unbox(_atlasSize.height) - _atlasProperties.packedAreaHeight)
+                              / unbox(_atlasProperties.tileSize.height);
         Require(tilesInY != 0);
         return tilesInY;
     }() },
@@ -531,6 +580,13 @@ TextureAtlas<Metadata>::TextureAtlas(AtlasBackend& backend, AtlasProperties atla
     }
 
     _directMapping.resize(_atlasProperties.directMappingCount);
+
+    if (_atlasProperties.packedAreaHeight)
+    {
+        // All of the rows below the tile grid are available for packing.
+        _packedAreaTop = _tilesInY * unbox(_atlasProperties.tileSize.height);
+        _packer.emplace(unbox(_atlasSize.width), unbox(_atlasSize.height) - _packedAreaTop);
+    }
 }
 
 template <typename Metadata>
@@ -632,6 +688,10 @@ void TextureAtlas<Metadata>::reset(AtlasProperties atlasProperties)
 {
     _atlasProperties = atlasProperties;
     _tileCache->clear();
+    _packedTiles.clear();
+    _packedShelfKeys.clear();
+    if (_packer)
+        _packer->clear();
 }
 
 template <typename Metadata>
@@ -663,6 +723,65 @@ void TextureAtlas<Metadata>::setDirectMapping(uint32_t tileIndex, TileCreateData
     _directMapping[tileIndex] = std::move(instance);
 }
 
+template <typename Metadata>
+TileAttributes<Metadata> const* TextureAtlas<Metadata>::try_get_packed(crispy::strong_hash const& key)
+{
+    auto const i = _packedTiles.find(key);
+    if (i == _packedTiles.end())
+        return nullptr;
+
+    _packer->touch(i->second.shelf);
+    return &i->second.attributes;
+}
+
+template <typename Metadata>
+template <typename RelocateFn>
+TileAttributes<Metadata> const* TextureAtlas<Metadata>::emplace_packed(crispy::strong_hash const& key,
+                                                                       TileCreateData& tileCreateData,
+                                                                       RelocateFn relocate)
+{
+    if (!_packer)
+        return nullptr;
+
+    auto const allocation =
+        _packer->allocate(unbox(tileCreateData.bitmapSize.width), unbox(tileCreateData.bitmapSize.height));
+    if (!allocation)
+        return nullptr;
+
+    if (allocation->evictedShelf)
+    {
+        for (auto const& evictedKey: _packedShelfKeys[*allocation->evictedShelf])
+            _packedTiles.erase(evictedKey);
+        _packedShelfKeys[*allocation->evictedShelf].clear();
+    }
+
+    if (auto const i = _packedTiles.find(key); i != _packedTiles.end())
+        std::erase(_packedShelfKeys[i->second.shelf], key);
+
+    if (allocation->shelf >= _packedShelfKeys.size())
+        _packedShelfKeys.resize(allocation->shelf + 1);
+    _packedShelfKeys[allocation->shelf].emplace_back(key);
+
+    auto const tileLocation = TileLocation({ static_cast<uint16_t>(allocation->x) },
+                                           { static_cast<uint16_t>(_packedAreaTop + allocation->y) });
+    relocate(tileLocation, tileCreateData);
+
+    auto tileUpload = UploadTile {};
+    tileUpload.location = tileLocation;
+    tileUpload.bitmapSize = tileCreateData.bitmapSize;
+    tileUpload.bitmapFormat = tileCreateData.bitmapFormat;
+    tileUpload.bitmap = std::move(tileCreateData.bitmap);
+    _backend.uploadTile(std::move(tileUpload));
+
+    auto& packedTile = _packedTiles[key];
+    packedTile.attributes.location = tileLocation;
+    packedTile.attributes.bitmapSize = tileCreateData.bitmapSize;
+    packedTile.attributes.metadata = std::move(tileCreateData.metadata);
+    packedTile.shelf = allocation->shelf;
+
+    return &packedTile.attributes;
+}
+
 template <typename Metadata>
 void TextureAtlas<Metadata>::inspect(std::ostream& output) const
 {
@@ -671,6 +790,12 @@ void TextureAtlas<Metadata>::inspect(std::ostream& output) const
     output << std::format("atlas size     : {}\n", _atlasSize);
     output << std::format("tile size      : {}\n", _atlasProperties.tileSize);
     output << std::format("direct mapped  : {}\n", _atlasProperties.directMappingCount);
+    if (_packer)
+        output << std::format("packed tiles   : {} in {} shelves ({}/{} pixel rows used)\n",
+                              _packedTiles.size(),
+                              _packer->shelfCount(),
+                              _packer->usedHeight(),
+                              _packer->height());
     output << '\n';
     _tileCache->inspect(output);
 }
@@ -720,11 +845,13 @@ struct std::formatter<vtrasterizer::atlas::AtlasProperties>: std::formatter<std:
 {
     auto format(vtrasterizer::atlas::AtlasProperties const& value, auto& ctx) const
     {
-        return formatter<std::string>::format(std::format("tile size {}, format {}, direct-mapped {}",
-                                                          value.tileSize,
-                                                          value.format,
-                                                          value.directMappingCount),
-                                              ctx);
+        return formatter<std::string>::format(
+            std::format("tile size {}, format {}, direct-mapped {}, packed area height {}",
+                        value.tileSize,
+                        value.format,
+                        value.directMappingCount,
+                        value.packedAreaHeight),
+            ctx);
     }
 };
 // }}}